@@ -25,12 +25,18 @@
 #include <epicsStdlib.h>
 #include <epicsAssert.h>
 #include <epicsPrint.h>
+#include <epicsAtomic.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
 #include <devSup.h>
 #include <epicsString.h>
 #include <boRecord.h>
 #include <iocsh.h>
 #include <callback.h>
 #include <errno.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <sys/time.h>
 
 /* Record includes */
@@ -38,15 +44,24 @@
 #include <longoutRecord.h>
 #include <int64inRecord.h>
 #include <int64outRecord.h>
+#include <menuScan.h>
 #include <dbStaticLib.h>
 
 /* Modbus or asyn includes */
 //#include <drvModbusAsyn.h>
 #include <drvAsynIPPort.h>
 #include <modbusInterpose.h>
+#include <asynOctetSyncIO.h>
+
+#include <algorithm>
 
 #include "alarm.h"
 #include "devEK9000.h"
+#include "ekBits.h"
+#include "ekOutputGroup.h"
+#include "ekLayoutCache.h"
+#include "ekProfile.h"
+#include "ekRailConfig.h"
 #include "ekUtil.h"
 #include "errlog.h"
 #include "recGbl.h"
@@ -56,7 +71,20 @@
 
 /* Some settings */
 #define POLL_DURATION 0.05
-#define TIMEOUT_COUNT 50
+
+/* CoE mailbox: time between status polls, and how long a terminal gets to answer */
+#define COE_POLL_INTERVAL 0.005
+#define COE_TIMEOUT 0.25
+/* Longest a synchronous transfer waits for the requests ahead of it and its own */
+#define COE_WAIT_TIMEOUT 10.0
+
+/* Steps of a CoERequest_t */
+enum {
+	COE_STATE_START = 0,
+	COE_STATE_POLL,
+	COE_STATE_FETCH,
+	COE_STATE_DONE
+};
 
 /* Forward decls */
 class devEK9000;
@@ -70,8 +98,91 @@ std::list<devEK9000*>& GlobalDeviceList() {
 	return devices;
 }
 
+/* Devices by name, kept in sync with GlobalDeviceList() */
+static util::NameMap<devEK9000*>::type& GlobalDeviceIndex() {
+	static util::NameMap<devEK9000*>::type index;
+	return index;
+}
+
+/* Terminals by legacy record name, see devEK9000Terminal::SetRecordName */
+static util::NameMap<devEK9000Terminal*>::type& GlobalTerminalIndex() {
+	static util::NameMap<devEK9000Terminal*>::type index;
+	return index;
+}
+
+/**
+ * Couplers the poll thread walks, as an immutable array swapped in whole by PublishPollSet. The poll thread loads the
+ * pointer once per cycle and bumps s_pollEpoch when it's done with it, so it never locks. A replaced set is freed once
+ * the epoch has moved past the one it was retired in; with a single reader that's the end of the cycle in progress.
+ */
+struct PollSet_t {
+	std::vector<devEK9000*> devices;
+	size_t retiredAt;
+};
+
+static EpicsAtomicPtrT s_pollSet = NULL;
+static size_t s_pollEpoch = 0;
+static std::vector<PollSet_t*> s_retiredPollSets;
+
+/* Serializes changes to the device list, index and poll set. Never taken by the poll thread */
+static epicsMutexId RegistryLock() {
+	static epicsMutexId lock = epicsMutexMustCreate();
+	return lock;
+}
+
+/* Free the retired sets the poll thread can no longer be looking at. Caller holds RegistryLock */
+static void ReclaimPollSets() {
+	const size_t epoch = epicsAtomicGetSizeT(&s_pollEpoch);
+	for (std::vector<PollSet_t*>::iterator it = s_retiredPollSets.begin(); it != s_retiredPollSets.end();) {
+		if (!g_PollThread || epoch > (*it)->retiredAt) {
+			delete *it;
+			it = s_retiredPollSets.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+/* Rebuild the poll set from the device list and swap it in. Caller holds RegistryLock */
+static void PublishPollSet() {
+	PollSet_t* next = new PollSet_t();
+	for (std::list<devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it)
+		if ((*it)->m_init && !(*it)->m_detached)
+			next->devices.push_back(*it);
+
+	PollSet_t* prev = static_cast<PollSet_t*>(epicsAtomicGetPtrT(&s_pollSet));
+	epicsAtomicSetPtrT(&s_pollSet, next);
+	if (prev) {
+		prev->retiredAt = epicsAtomicGetSizeT(&s_pollEpoch);
+		s_retiredPollSets.push_back(prev);
+	}
+	ReclaimPollSets();
+}
+
+/* Wait for the poll thread to finish the cycle it's in, after which it can't hold anything retired before now */
+static void WaitForPollCycle() {
+	if (!g_PollThread)
+		return;
+	const size_t start = epicsAtomicGetSizeT(&s_pollEpoch);
+	while (epicsAtomicGetSizeT(&s_pollEpoch) == start)
+		epicsThreadSleep(0.01);
+}
+
+/* Layouts declared with ek9000DeclareLayout, picked up by the coupler of the same name when it registers */
+static std::map<std::string, std::vector<uint16_t> >& DeclaredLayouts() {
+	static std::map<std::string, std::vector<uint16_t> > layouts;
+	return layouts;
+}
+
 bool devEK9000::debugEnabled = false;
 int devEK9000::pollDelay = 200;
+bool devEK9000::parallelInit = false;
+double devEK9000::parallelInitTimeout = 30.0;
+std::string devEK9000::layoutCacheDir;
+bool devEK9000::pdoIntrospection = false;
+
+/* Shared by every terminal running the value-only PDO, so they merge into one decode run like any other codec */
+static const TerminalCodec_t s_compactCodec = {0, 1, &ChannelDecoder<CompactCodec, 1>::Run};
 
 // This is a big hack for safety reasons! This will force you to use the DEFINE_XXX_PDO macro for every terminal type at
 // least once, so we can catch mismatches between terminals.json and the in-code PDO structs.
@@ -100,14 +211,13 @@ void Utl_InitThread() {
 //      - Poll for new EL1xxx/EL3xxx/EL5xxx data every poll time.
 void PollThreadFunc(void*) {
 	int cnt = 0;
-	struct timeval start, finish, last_read_status;
-	memset(&last_read_status, 0, sizeof(last_read_status));
+	struct timeval start, finish;
 	double duration_ms = -1.0;
 	while (true) {
 		gettimeofday(&start, NULL);
-		// for (auto device : GlobalDeviceList()) {
-		for (std::list<devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
-			devEK9000* device = *it;
+		const PollSet_t* set = static_cast<const PollSet_t*>(epicsAtomicGetPtrT(&s_pollSet));
+		for (size_t i = 0; set && i < set->devices.size(); ++i) {
+			devEK9000* device = set->devices[i];
 			DeviceLock lock(device);
 			if (!lock.valid())
 				continue;
@@ -121,12 +231,22 @@ void PollThreadFunc(void*) {
 				if (connected && !device->m_connected) {
 					LOG_WARNING(device, "%s: Link status changed to CONNECTED\n", device->m_name.data());
 					device->m_connected = true;
+					/* The coupler may have dropped to its fallback values while we were away */
+					if (device->m_wasConnected) {
+						device->m_pendingRestore = "reconnect";
+						/* Nor can we know what happened to the terminals' settings */
+						device->InvalidateCoECache(0);
+					}
+					device->m_wasConnected = true;
 				}
 				/* Skip poll if we're not connected */
 				if (!device->m_connected) {
 					LOG_INFO(device, "%s: device not connected, skipping poll", device->m_name.data());
 					continue;
 				}
+				/* Mapped offline, make sure we got the rail right before touching any terminal */
+				if (device->m_layoutPending)
+					device->ValidateDeclaredLayout();
 				uint16_t buf = 1;
 				if (device->doModbusIO(0, MODBUS_WRITE_SINGLE_REGISTER, 0x1121, &buf, 1)) {
 					LOG_WARNING(device, "%s: FAILED TO RESET WATCHDOG!\n", device->m_name.data());
@@ -134,8 +254,9 @@ void PollThreadFunc(void*) {
 			}
 
 			// Read status registers only after a ~1 second delay
-			if (((start.tv_sec + start.tv_usec / 1e6) - (last_read_status.tv_sec + last_read_status.tv_usec / 1e6)) >=
-				1.0) {
+			epicsTimeStamp now;
+			epicsTimeGetCurrent(&now);
+			if (epicsTimeDiffInSeconds(&now, &device->m_lastStatusRead) >= 1.0) {
 				device->m_status_status = device->doModbusIO(0, MODBUS_READ_INPUT_REGISTERS, EK9000_STATUS_START,
 															 device->m_status_buf, ArraySize(device->m_status_buf));
 
@@ -145,25 +266,77 @@ void PollThreadFunc(void*) {
 					LOG_WARNING(device, "%s: E-Bus status switched to %s\n", device->m_name.data(),
 								ebus ? "OK" : "FAULT");
 				}
+				/* The fallback counter goes up each time the watchdog expires and the outputs drop to fallback values */
+				uint16_t fallbacks = device->m_status_buf[EK9000_STATUS_FALLBACKS - EK9000_STATUS_START];
+				if (device->m_status_status == asynSuccess) {
+					if (device->m_fallbacksValid && fallbacks != device->m_lastFallbacks)
+						device->m_pendingRestore = "watchdog fallback";
+					device->m_lastFallbacks = fallbacks;
+					device->m_fallbacksValid = true;
+				}
 				scanIoRequest(device->m_status_io);
-				gettimeofday(&last_read_status, NULL);
+				device->m_lastStatusRead = now;
 				// Signal digital/analog error
-				if (!ebus)
-					device->m_digital_status = device->m_analog_status = asynError;
+				if (!ebus) {
+					device->PublishInputs(INPUT_IMAGE_DIGITAL, asynError);
+					device->PublishInputs(INPUT_IMAGE_ANALOG, asynError);
+				}
+			}
+
+			/* Inputs stay INVALID until the mapping is confirmed */
+			if (!device->TerminalIOEnabled())
+				continue;
+
+			/* Low rate check for terminals added, removed or swapped on the running rail */
+			if (device->m_railCheckPeriod > 0 && device->m_ebus_ok) {
+				epicsTimeStamp now;
+				epicsTimeGetCurrent(&now);
+				if (epicsTimeDiffInSeconds(&now, &device->m_lastRailCheck) >= device->m_railCheckPeriod) {
+					device->CheckRail();
+					device->m_lastRailCheck = now;
+				}
 			}
+			/* Only terminals that are still where they were mapped get read */
+			const RailSnapshot_t* rail = device->Rail();
+			if (!rail)
+				continue;
+
+			/* Put back everything we commanded in one batch, before anything else is written this cycle. Stays pending
+			 * through cycles that can't do it */
+			if (device->m_pendingRestore && device->m_outputImageValid && device->m_ebus_ok &&
+				device->RestoreOutputs(device->m_pendingRestore) == EK_EOK)
+				device->m_pendingRestore = NULL;
 
 			/* read EL1xxx/EL3xxx/EL5xxx data */
-			if (device->m_digital_cnt && device->m_ebus_ok) {
-				device->m_digital_status =
-					device->doModbusIO(0, MODBUS_READ_DISCRETE_INPUTS, 0, device->m_digital_buf, device->m_digital_cnt);
+			if (!rail->segments[RAIL_DIGITAL_IN].empty() && device->m_ebus_ok) {
+				int status = device->ReadInputSegments(rail, RAIL_DIGITAL_IN);
+				device->PublishInputs(INPUT_IMAGE_DIGITAL, status);
 				scanIoRequest(device->m_digital_io);
 			}
-			if (device->m_analog_cnt && device->m_ebus_ok) {
-				device->m_analog_status =
-					device->doModbusIO(0, MODBUS_READ_INPUT_REGISTERS, 0, device->m_analog_buf, device->m_analog_cnt);
+			if (!rail->segments[RAIL_ANALOG_IN].empty() && device->m_ebus_ok) {
+				int status = device->ReadInputSegments(rail, RAIL_ANALOG_IN);
+				if (status == EK_EOK)
+					device->DecodeInputs();
+				device->PublishInputs(INPUT_IMAGE_ANALOG, status);
 				scanIoRequest(device->m_analog_io);
 			}
+
+			/* Low rate check that the outputs still hold what we last commanded */
+			if (device->m_outputVerifyPeriod > 0 && device->m_outputImageValid && device->m_ebus_ok) {
+				epicsTimeStamp now;
+				epicsTimeGetCurrent(&now);
+				if (epicsTimeDiffInSeconds(&now, &device->m_lastOutputVerify) >= device->m_outputVerifyPeriod) {
+					device->VerifyOutputImage();
+					device->m_lastOutputVerify = now;
+				}
+			}
+
+			/* Step ramps, pulse trains and schedules */
+			if (device->m_ebus_ok)
+				device->RunProfiles();
 		}
+		/* Done with this cycle's set, see PollSet_t */
+		epicsAtomicIncrSizeT(&s_pollEpoch);
 		cnt = (cnt + 1) % 2;
 		gettimeofday(&finish, NULL);
 		duration_ms = (finish.tv_sec - start.tv_sec) * 1000. + (finish.tv_usec - start.tv_usec) / 1000.;
@@ -180,7 +353,7 @@ void PollThreadFunc(void*) {
 devEK9000Terminal::devEK9000Terminal(devEK9000* device) {
 	/* Terminal family */
 	m_terminalFamily = 0;
-	/* Zero-based index of the terminal */
+	/* 1-based rail position of the terminal, 0 until Init */
 	m_terminalIndex = 0;
 	/* the device */
 	m_device = device;
@@ -194,6 +367,8 @@ devEK9000Terminal::devEK9000Terminal(devEK9000* device) {
 	m_inputStart = 0;
 	/* Output image start */
 	m_outputStart = 0;
+	m_codec = NULL;
+	m_sizesFromPdos = false;
 }
 
 void devEK9000Terminal::Init(uint32_t termid, int termindex) {
@@ -203,73 +378,76 @@ void devEK9000Terminal::Init(uint32_t termid, int termindex) {
 	this->m_terminalIndex = termindex;
 	this->m_terminalId = termid;
 
-	if (termid >= 1000 && termid < 3000)
-		this->m_terminalFamily = TERMINAL_FAMILY_DIGITAL;
-	else if (termid >= 3000 && termid < 8000)
-		this->m_terminalFamily = TERMINAL_FAMILY_ANALOG;
+	if (const int family = GetTerminalFamily(termid))
+		this->m_terminalFamily = family;
 
 	/* Get the process image size for this terminal */
 	devEK9000Terminal::GetTerminalInfo((int)termid, inp, outp);
 	this->m_inputSize = inp;
 	this->m_outputSize = outp;
+	this->m_codec = util::FindCodec(termid);
+	this->m_sizesFromPdos = false;
 }
 
 // If multi is true, we do not expect a channel selector at the end of the record name
 // In that case, outindex is not set
 // This is LEGACY code, to maintain compatibility with older setups
 devEK9000Terminal* devEK9000Terminal::ProcessRecordName(const char* recname, int* outindex) {
-	char ret[512];
-	strncpy(ret, recname, sizeof(ret) - 1);
-	ret[sizeof(ret) - 1] = 0;
-
-	size_t len = strlen(ret);
+	std::string name = recname;
 
 	if (outindex) {
-		bool good = false;
-		for (size_t i = len; i >= 0; i--) {
-			if (ret[i] == ':' && (size_t)i < len) {
-				ret[i] = '\0';
-				if (util::parseNumber(ret + 1, *outindex, 10))
-					good = true;
-				break;
-			}
-		}
-		if (!good)
+		/* Strip the channel selector off the end */
+		const size_t sep = name.rfind(':');
+		if (sep == std::string::npos || !util::parseNumber(name.c_str() + sep + 1, *outindex, 10))
 			return NULL;
+		name.erase(sep);
 	}
 
-	// for (auto dev : GlobalDeviceList()) {
-	for (std::list<devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
-		devEK9000* dev = *it;
-		for (int i = 0; i < dev->m_numTerms; i++) {
-			if (dev->m_terms[i]->m_recordName.empty())
-				continue;
-			if (strcmp(dev->m_terms[i]->m_recordName.data(), ret) == 0) {
-				return dev->m_terms[i];
-			}
-		}
-	}
-	return NULL;
+	util::NameMap<devEK9000Terminal*>::type::const_iterator it = GlobalTerminalIndex().find(name);
+	return it != GlobalTerminalIndex().end() ? it->second : NULL;
+}
+
+void devEK9000Terminal::SetRecordName(const char* rec) {
+	util::NameMap<devEK9000Terminal*>::type& index = GlobalTerminalIndex();
+	util::NameMap<devEK9000Terminal*>::type::iterator it = index.find(m_recordName);
+	if (it != index.end() && it->second == this)
+		index.erase(it);
+	m_recordName = rec;
+	/* First terminal configured with a name wins, like the old linear search */
+	if (!m_recordName.empty())
+		index.insert(std::make_pair(m_recordName, this));
 }
 
 void devEK9000Terminal::GetTerminalInfo(int termid, int& inp_size, int& out_size) {
-	for (size_t i = 0; i < ArraySize(s_terminalInfos); i++) {
-		if (s_terminalInfos[i].id == (uint32_t)termid) {
-			inp_size = s_terminalInfos[i].inputSize;
-			out_size = s_terminalInfos[i].outputSize;
-			return;
-		}
+	const terminal_t* info = util::FindTerminal(termid);
+	if (info) {
+		inp_size = info->inputSize;
+		out_size = info->outputSize;
 	}
 }
 
+int devEK9000Terminal::GetTerminalFamily(uint32_t termid) {
+	if (termid >= 1000 && termid < 3000)
+		return TERMINAL_FAMILY_DIGITAL;
+	if (termid >= 3000 && termid < 8000)
+		return TERMINAL_FAMILY_ANALOG;
+	return 0;
+}
+
 int devEK9000Terminal::doEK9000IO(int type, int startaddr, uint16_t* buf, int len) {
 	if (!this->m_device) {
 		return EK_EBADTERM;
 	}
-	int status = this->m_device->doModbusIO(0, type, startaddr, buf, len);
-	if (status) {
+	if (type == MODBUS_WRITE_MULTIPLE_REGISTERS || type == MODBUS_WRITE_SINGLE_REGISTER)
+		return m_device->WriteRegisters(startaddr, buf, len);
+
+	/* Reading back outputs, from wherever they are on the rail now */
+	uint32_t rail = 0;
+	if (!this->m_device->TerminalIOEnabled() || !this->m_device->RegistersActive(startaddr, len) ||
+		this->m_device->Rail()->Span(RAIL_REGISTER_OUT, startaddr - EK9000_OUTPUT_REG_START, len, rail) != uint32_t(len))
+		return EK_ELAYOUT;
+	if (this->m_device->doModbusIO(0, type, EK9000_OUTPUT_REG_START + rail, buf, len))
 		return EK_EMODBUSERR;
-	}
 	return EK_EOK;
 }
 
@@ -281,31 +459,29 @@ int devEK9000Terminal::getEK9000IO(EIOType type, int startaddr, uint16_t* buf, i
 
 int devEK9000::getEK9000IO(EIOType type, int startaddr, uint16_t* buf, uint16_t len) {
 	int status = 0;
-	DeviceLock lock(this);
-	if (!lock.valid())
-		return EK_EMUTEXTIMEOUT;
-
+	/* Input images are guarded by m_inputSpin alone, only the status block needs the device lock */
 	if (type == READ_DIGITAL) { /* digital */
 		if (startaddr < 0 || startaddr + len > this->m_digital_cnt)
-			status = EK_EBADPARAM;
-		else if (this->m_digital_status)
-			status = this->m_digital_status;
-		else {
-			memcpy(buf, this->m_digital_buf + startaddr, len * sizeof(uint16_t));
-			status = EK_EOK;
-		}
+			return EK_EBADPARAM;
+		epicsSpinLock(m_inputSpin);
+		status = m_digital_status;
+		if (!status)
+			bits::UnpackWords(buf, m_digital_bits, startaddr, len);
+		epicsSpinUnlock(m_inputSpin);
 	}
 	else if (type == READ_ANALOG) { /* analog */
 		if (startaddr < 0 || startaddr + len > this->m_analog_cnt)
-			status = EK_EBADPARAM;
-		else if (this->m_analog_status)
-			status = this->m_analog_status;
-		else {
+			return EK_EBADPARAM;
+		epicsSpinLock(m_inputSpin);
+		status = m_analog_status;
+		if (!status)
 			memcpy(buf, this->m_analog_buf + startaddr, len * sizeof(uint16_t));
-			status = EK_EOK;
-		}
+		epicsSpinUnlock(m_inputSpin);
 	}
 	else if (type == READ_STATUS) {
+		DeviceLock lock(this);
+		if (!lock.valid())
+			return EK_EMUTEXTIMEOUT;
 		startaddr -= EK9000_STATUS_START;
 		if (startaddr < 0 || size_t(startaddr + len) > ArraySize(m_status_buf))
 			status = EK_EBADPARAM;
@@ -321,6 +497,127 @@ int devEK9000::getEK9000IO(EIOType type, int startaddr, uint16_t* buf, uint16_t
 	return status;
 }
 
+bool devEK9000::ResolveInput(const devEK9000Terminal* term, EInputImage image, int offset, int width,
+							 ReadDescriptor_t& out) const {
+	const int size = image == INPUT_IMAGE_DIGITAL ? m_digital_cnt : image == INPUT_IMAGE_ANALOG ? m_analog_cnt : 0;
+	if (offset < 0 || width <= 0 || offset + width > size || (image == INPUT_IMAGE_DIGITAL && width > 32))
+		return false;
+	out.image = image;
+	out.pos = (uint8_t)term->m_terminalIndex;
+	out.offset = offset;
+	out.width = width;
+	return true;
+}
+
+int devEK9000::ReadInput(const ReadDescriptor_t& desc, void* out) {
+	int status;
+	epicsSpinLock(m_inputSpin);
+	/* The image stays in the mapped layout, only terminals that changed since the record was resolved aren't read */
+	const RailSnapshot_t* rail = Rail();
+	if (!rail || !rail->usable[desc.pos])
+		status = EK_ELAYOUT;
+	else if (desc.image == INPUT_IMAGE_DIGITAL) {
+		status = m_digital_status;
+		if (!status)
+			*static_cast<uint32_t*>(out) = bits::GetBits(m_digital_bits, desc.offset, desc.width);
+	}
+	else if (desc.image == INPUT_IMAGE_ANALOG) {
+		status = m_analog_status;
+		if (!status)
+			memcpy(out, m_analog_buf + desc.offset, desc.width * sizeof(uint16_t));
+	}
+	else if (desc.image == INPUT_IMAGE_DECODED) {
+		status = m_analog_status;
+		if (!status) {
+			DecodedInput_t* input = static_cast<DecodedInput_t*>(out);
+			input->value = m_decodedValues[desc.offset];
+			input->severity = bits::GetBits(&m_decodedSeverities[0], desc.offset * 2, 2);
+		}
+	}
+	else
+		status = EK_EBADPARAM;
+	epicsSpinUnlock(m_inputSpin);
+	return status;
+}
+
+bool devEK9000::ResolveChannel(const devEK9000Terminal* term, int channel, ReadDescriptor_t& out) const {
+	if (term->m_terminalFamily != TERMINAL_FAMILY_ANALOG || channel < 1)
+		return false;
+	/* Runs are sorted by offset, find the last one starting at or before the terminal */
+	const uint32_t start = term->m_inputStart;
+	size_t lo = 0, hi = m_decodeRuns.size();
+	while (lo < hi) {
+		const size_t mid = (lo + hi) / 2;
+		if (m_decodeRuns[mid].offset <= start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (!lo)
+		return false;
+	const DecodeRun_t& run = m_decodeRuns[lo - 1];
+	const uint32_t stride = run.codec->stride;
+	if (run.codec != term->m_codec || channel > term->m_inputSize / int(stride))
+		return false;
+	const uint32_t index = (start - run.offset) / stride + channel - 1;
+	if (index >= run.count)
+		return false;
+	out.image = INPUT_IMAGE_DECODED;
+	out.pos = (uint8_t)term->m_terminalIndex;
+	out.offset = run.first + index;
+	out.width = 1;
+	return true;
+}
+
+void devEK9000::PublishInputs(EInputImage image, int status) {
+	epicsSpinLock(m_inputSpin);
+	if (image == INPUT_IMAGE_DIGITAL) {
+		if (status == EK_EOK)
+			std::swap(m_digital_bits, m_digital_back);
+		m_digital_status = status;
+	}
+	else {
+		if (status == EK_EOK) {
+			std::swap(m_analog_buf, m_analog_back);
+			m_decodedValues.swap(m_decodedValuesBack);
+			m_decodedSeverities.swap(m_decodedSeveritiesBack);
+		}
+		m_analog_status = status;
+	}
+	epicsSpinUnlock(m_inputSpin);
+}
+
+void devEK9000::SetupInputDecode() {
+	uint32_t channels = 0;
+	m_decodeRuns.clear();
+	for (int i = 0; i < m_numTerms; ++i) {
+		const devEK9000Terminal* term = m_terms[i];
+		const TerminalCodec_t* codec = term->m_codec;
+		if (term->m_terminalFamily != TERMINAL_FAMILY_ANALOG || !codec)
+			continue;
+		const uint32_t count = term->m_inputSize / codec->stride;
+		DecodeRun_t* last = m_decodeRuns.empty() ? NULL : &m_decodeRuns.back();
+		if (last && last->codec == codec && last->offset + last->count * codec->stride == uint32_t(term->m_inputStart))
+			last->count += count;
+		else {
+			DecodeRun_t run = {uint32_t(term->m_inputStart), channels, count, codec};
+			m_decodeRuns.push_back(run);
+		}
+		channels += count;
+	}
+	m_decodedValues.assign(channels, 0);
+	m_decodedValuesBack.assign(channels, 0);
+	m_decodedSeverities.assign(bits::PackedSize(channels * 2), 0);
+	m_decodedSeveritiesBack.assign(bits::PackedSize(channels * 2), 0);
+}
+
+void devEK9000::DecodeInputs() {
+	/* Channels of terminals that changed decode whatever they last held, ReadInput doesn't hand those out */
+	for (std::vector<DecodeRun_t>::const_iterator it = m_decodeRuns.begin(); it != m_decodeRuns.end(); ++it)
+		it->codec->decode(m_analog_back + it->offset, it->count, &m_decodedValuesBack[it->first],
+						  &m_decodedSeveritiesBack[0], it->first);
+}
+
 //==========================================================//
 // class devEK9000
 //		Holds useful vars for interacting with EK9000/EL****
@@ -342,32 +639,108 @@ devEK9000::devEK9000(const char* portname, const char* octetPortName, int termCo
 	LastADSErr = 0;
 	m_name = portname;
 	m_readTerminals = false;
+	m_railCount = 0;
+	m_layoutPending = false;
+	m_detached = false;
+	m_bringingUp = false;
+	m_up = false;
+	m_abandoned = false;
+	m_mappedLate = false;
+	m_rail = NULL;
+	m_railCheckPeriod = 0;
+	m_watchdogTime = -1;
+	m_watchdogType = -1;
+	m_coeCacheTTL = 0;
+	m_coeThread = NULL;
+	m_coeEvent = NULL;
+	m_coeMutex = epicsMutexMustCreate();
+	m_coeActive = NULL;
+	/* Here rather than with the images, records can be added to these whether or not the coupler ever comes up */
+	scanIoInit(&m_analog_io);
+	scanIoInit(&m_digital_io);
+	scanIoInit(&m_status_io);
+	m_lockOwner = NULL;
+	m_lockDepth = 0;
+	memset(&m_lastRailCheck, 0, sizeof(m_lastRailCheck));
 	m_octetPortName = octetPortName;
 	m_ebus_ok = true;
 
 	this->m_Mutex = epicsMutexCreate();
+	m_profileMutex = epicsMutexMustCreate();
+	m_profileGroup = NULL;
+	m_outputImageValid = false;
+	m_dout_count = 0;
+	m_octetUser = NULL;
+	m_lastFallbacks = 0;
+	m_fallbacksValid = false;
+	m_pendingRestore = NULL;
+	memset(&m_lastStatusRead, 0, sizeof(m_lastStatusRead));
+	m_wasConnected = false;
+	m_outputVerifyPeriod = 0;
+	memset(&m_lastOutputVerify, 0, sizeof(m_lastOutputVerify));
+	memset(m_counters, 0, sizeof(m_counters));
 	m_analog_status = EK_EERR + 0x100; /* No data yet!! */
 	m_digital_status = EK_EERR + 0x100;
+	m_analog_buf = m_analog_back = NULL;
+	m_digital_bits = m_digital_back = NULL;
+	m_analog_cnt = m_digital_cnt = 0;
+	m_inputSpin = epicsSpinMustCreate();
 }
 
 devEK9000::~devEK9000() {
 	epicsMutexDestroy(this->m_Mutex);
 	for (size_t i = 0; i < m_terms.size(); ++i)
 		delete m_terms[i];
+	for (std::map<std::string, devEK9000OutputGroup*>::iterator it = m_groups.begin(); it != m_groups.end(); ++it)
+		delete it->second;
+	for (size_t i = 0; i < m_profiles.size(); ++i)
+		delete m_profiles[i];
+	delete m_profileGroup;
+	epicsMutexDestroy(m_profileMutex);
+	if (m_octetUser)
+		pasynOctetSyncIO->disconnect(m_octetUser);
+	free(m_analog_buf);
+	free(m_analog_back);
+	free(m_digital_bits);
+	free(m_digital_back);
+	delete static_cast<RailSnapshot_t*>(m_rail);
+	for (size_t i = 0; i < m_retiredRails.size(); ++i)
+		delete m_retiredRails[i];
+	epicsSpinDestroy(m_inputSpin);
 }
 
 devEK9000* devEK9000::FindDevice(const char* name) {
-	// for (auto dev : GlobalDeviceList()) {
-	for (std::list<devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
-		devEK9000* dev = *it;
-		if (!strcmp(name, dev->m_name.data()))
-			return dev;
-	}
-	// return nullptr;
-	return NULL;
+	epicsMutexMustLock(RegistryLock());
+	util::NameMap<devEK9000*>::type::const_iterator it = GlobalDeviceIndex().find(name);
+	devEK9000* dev = it != GlobalDeviceIndex().end() ? it->second : NULL;
+	epicsMutexUnlock(RegistryLock());
+	return dev;
+}
+
+devEK9000OutputGroup* devEK9000::FindOutputGroup(const char* name, bool create) {
+	std::map<std::string, devEK9000OutputGroup*>::iterator it = m_groups.find(name);
+	if (it != m_groups.end())
+		return it->second;
+	if (!create)
+		return NULL;
+	devEK9000OutputGroup* group = new devEK9000OutputGroup(this, name);
+	m_groups.insert(std::make_pair(std::string(name), group));
+	return group;
 }
 
 devEK9000* devEK9000::Create(const char* name, const char* ip, int terminal_count) {
+	devEK9000* pek = Register(name, ip, terminal_count);
+	if (!pek)
+		return NULL;
+
+	if (!pek->BringUp()) {
+		DetachFailed(pek);
+		return NULL;
+	}
+	return pek;
+}
+
+devEK9000* devEK9000::Register(const char* name, const char* ip, int terminal_count) {
 	if (terminal_count < 0 || !name || !ip)
 		return NULL;
 
@@ -377,55 +750,246 @@ devEK9000* devEK9000::Create(const char* name, const char* ip, int terminal_coun
 	int status = drvAsynIPPortConfigure(octetPortName.data(), ip, 0, 0, 0);
 
 	if (status) {
-		epicsPrintf("devEK9000::Create(): Unable to configure drvAsynIPPort.");
+		epicsPrintf("devEK9000::Register(): Unable to configure drvAsynIPPort.");
 		return NULL;
 	}
 
 	status = modbusInterposeConfig(octetPortName.data(), modbusLinkTCP, 5000, 0);
 
 	if (status) {
-		epicsPrintf("devEK9000::Create(): Unable to configure modbus driver.");
+		epicsPrintf("devEK9000::Register(): Unable to configure modbus driver.");
+		return NULL;
+	}
+
+	devEK9000* pek = new devEK9000(name, octetPortName.c_str(), terminal_count, ip);
+
+	/* Copy IP */
+	pek->m_ip = ip;
+
+	std::map<std::string, std::vector<uint16_t> >::const_iterator layout = DeclaredLayouts().find(pek->m_name);
+	if (layout != DeclaredLayouts().end())
+		pek->m_declaredLayout = layout->second;
+
+	epicsMutexMustLock(RegistryLock());
+	GlobalDeviceList().push_back(pek);
+	GlobalDeviceIndex().insert(std::make_pair(pek->m_name, pek));
+	epicsMutexUnlock(RegistryLock());
+	return pek;
+}
+
+void devEK9000::DetachFailed(devEK9000* pek, bool abandoned) {
+	/* Never in the poll set, as it wasn't brought up */
+	epicsMutexMustLock(RegistryLock());
+	pek->m_detached = true;
+	pek->m_abandoned = pek->m_abandoned || abandoned;
+	epicsMutexUnlock(RegistryLock());
+	epicsPrintf("%s: left detached, ek9000Attach(%s) tries again\n", pek->m_name.c_str(), pek->m_name.c_str());
+}
+
+devEK9000* devEK9000::Attach(const char* name, const char* ip, int terminal_count) {
+	devEK9000* dev = FindDevice(name);
+	if (!dev) {
+		if (!ip) {
+			epicsPrintf("devEK9000::Attach(): %s is not configured, an IP is needed to add it\n", name);
+			return NULL;
+		}
+		dev = Create(name, ip, terminal_count);
+		if (!dev)
+			return NULL;
+	}
+	else if (!dev->m_detached) {
+		epicsPrintf("devEK9000::Attach(): %s is already attached\n", name);
 		return NULL;
 	}
+	else if (!dev->IsUp()) {
+		/* Mapped after the parallel bring-up gave up on it, nothing left to do but use it */
+		epicsMutexMustLock(RegistryLock());
+		const bool adopt = dev->m_mappedLate && !dev->m_bringingUp;
+		if (adopt) {
+			dev->m_up = true;
+			dev->m_abandoned = dev->m_mappedLate = false;
+		}
+		else if (!dev->m_bringingUp)
+			dev->m_abandoned = false;
+		epicsMutexUnlock(RegistryLock());
+
+		/* Failed to come up before, the records that were set up against it at the time never were */
+		if (!adopt && !dev->BringUp()) {
+			epicsPrintf("devEK9000::Attach(): %s failed to come up again\n", name);
+			return NULL;
+		}
+		epicsMutexMustLock(RegistryLock());
+		dev->m_detached = false;
+		epicsMutexUnlock(RegistryLock());
+	}
+	else {
+		DeviceLock lock(dev);
+		if (!lock.valid())
+			return NULL;
+		/* The rail may have been worked on while it was detached */
+		if (!dev->m_layoutPending && dev->VerifyConnection())
+			dev->CheckRail();
+		/* Have the poll thread go through a reconnect, which also restores the outputs */
+		dev->m_connected = false;
+		dev->m_detached = false;
+	}
+
+	epicsMutexMustLock(RegistryLock());
+	PublishPollSet();
+	epicsMutexUnlock(RegistryLock());
+	LOG_WARNING(dev, "%s: attached\n", dev->m_name.c_str());
+	return dev;
+}
+
+bool devEK9000::Detach(const char* name) {
+	devEK9000* dev = FindDevice(name);
+	if (!dev || dev->m_detached) {
+		epicsPrintf("devEK9000::Detach(): %s is not attached\n", name);
+		return false;
+	}
 
+	epicsMutexMustLock(RegistryLock());
+	dev->m_detached = true;
+	PublishPollSet();
+	epicsMutexUnlock(RegistryLock());
+	WaitForPollCycle();
+
+	/* The poll thread is done with it, leave the records INVALID rather than showing the last values. The inputs only
+	 * need m_inputSpin */
+	DeviceLock lock(dev);
+	if (lock.valid()) {
+		dev->m_connected = false;
+		lock.unlock();
+	}
+	dev->PublishInputs(INPUT_IMAGE_DIGITAL, EK_ENOCONN);
+	dev->PublishInputs(INPUT_IMAGE_ANALOG, EK_ENOCONN);
+	if (dev->m_init) {
+		scanIoRequest(dev->m_digital_io);
+		scanIoRequest(dev->m_analog_io);
+		scanIoRequest(dev->m_status_io);
+	}
+	LOG_WARNING(dev, "%s: detached\n", dev->m_name.c_str());
+	return true;
+}
+
+bool devEK9000::BringUp() {
+	/* ek9000Attach can retry a coupler whose first attempt outlived the init timeout and is still going */
+	epicsMutexMustLock(RegistryLock());
+	const bool busy = m_bringingUp;
+	m_bringingUp = true;
+	epicsMutexUnlock(RegistryLock());
+	if (busy) {
+		epicsPrintf("devEK9000::BringUp(): %s is still being brought up\n", m_name.c_str());
+		return false;
+	}
+
+	const bool ok = ConnectAndMap();
+	epicsMutexMustLock(RegistryLock());
+	m_bringingUp = false;
+	/* iocInit carried on without it, records must not start finding it now. ek9000Attach picks the mapping up */
+	if (m_abandoned)
+		m_mappedLate = ok;
+	else
+		m_up = m_up || ok;
+	epicsMutexUnlock(RegistryLock());
+	return ok;
+}
+
+bool devEK9000::IsUp() const {
+	epicsMutexMustLock(RegistryLock());
+	const bool up = m_up;
+	epicsMutexUnlock(RegistryLock());
+	return up;
+}
+
+bool devEK9000::ConnectAndMap() {
 	/* check connection */
 	asynUser* usr = pasynManager->createAsynUser(NULL, NULL);
-	pasynManager->connectDevice(usr, octetPortName.data(), 0);
+	pasynManager->connectDevice(usr, m_octetPortName.c_str(), 0);
 	int conn = 0;
 	pasynManager->isConnected(usr, &conn);
 	pasynManager->disconnect(usr);
 	pasynManager->freeAsynUser(usr);
 
 	if (!conn) {
-		epicsPrintf("devEK9000::Create(): Error while connecting to device %s.", name);
-		return NULL;
+		if (m_declaredLayout.empty()) {
+			epicsPrintf("devEK9000::BringUp(): Error while connecting to device %s.\n", m_name.c_str());
+			return false;
+		}
+		/* Boot anyway, the poll thread checks the layout once the coupler answers */
+		epicsPrintf("devEK9000::BringUp(): %s is offline, mapping it from its declared layout\n", m_name.c_str());
+		return MapDeclaredLayout();
 	}
 
-	devEK9000* pek = new devEK9000(name, octetPortName.c_str(), terminal_count, ip);
-
-	/* Copy IP */
-	pek->m_ip = ip;
-
 	/* wdt =  */
 	uint16_t buf = 1;
-	pek->doModbusIO(0, MODBUS_WRITE_SINGLE_REGISTER, 0x1122, &buf, 1);
+	this->doModbusIO(0, MODBUS_WRITE_SINGLE_REGISTER, 0x1122, &buf, 1);
 
-	if (!pek->ComputeTerminalMapping()) {
-		epicsPrintf("devEK9000::Create(): Unable to compute terminal mapping\n");
-		delete pek;
-		return NULL;
+	if (!this->ComputeTerminalMapping()) {
+		epicsPrintf("devEK9000::BringUp(): Unable to compute terminal mapping for %s\n", m_name.c_str());
+		return false;
 	}
+	DeviceLock lock(this);
+	if (lock.valid())
+		ApplyPresets();
+	return true;
+}
 
-	GlobalDeviceList().push_back(pek);
-	return pek;
+void devEK9000::ApplyPresets() {
+	if (m_watchdogTime >= 0 && WriteWatchdogTime((uint16_t)m_watchdogTime) != EK_EOK)
+		LOG_WARNING(this, "%s: unable to set the watchdog time\n", m_name.c_str());
+	if (m_watchdogType >= 0 && WriteWatchdogType((uint16_t)m_watchdogType) != EK_EOK)
+		LOG_WARNING(this, "%s: unable to set the watchdog type\n", m_name.c_str());
+
+	/* Queued, this can be called from the poll thread */
+	for (size_t i = 0; i < m_coePresets.size(); ++i) {
+		const CoEPreset_t& preset = m_coePresets[i];
+		CoERequest_t* req = new CoERequest_t();
+		req->rw = 1;
+		req->term = (uint16_t)preset.pos;
+		req->index = preset.index;
+		req->subindex = preset.subindex;
+		req->len = preset.len;
+		req->reallen = preset.bytes;
+		memcpy(req->data, preset.data, preset.len * sizeof(uint16_t));
+		req->callback = PresetWritten;
+		req->user = this;
+		int status = QueueCoE(req);
+		if (status != EK_EOK) {
+			req->status = status;
+			PresetWritten(req);
+		}
+	}
+}
+
+void devEK9000::PresetWritten(CoERequest_t* req) {
+	devEK9000* dev = static_cast<devEK9000*>(req->user);
+	if (req->status != EK_EOK)
+		LOG_ERROR(dev, "%s: unable to write CoE 0x%04X:%02X of terminal %d: %s\n", dev->m_name.c_str(), req->index,
+				  req->subindex, req->term, ErrorToString(req->status));
+	delete req;
 }
 
 int devEK9000::AddTerminal(const char* name, uint32_t type, int position) {
-	if (position > m_numTerms || !name)
+	if (position < 1 || position > m_numTerms || !name)
 		return EK_EBADPARAM;
 
-	m_terms[position - 1]->Init(type, position);
-	m_terms[position - 1]->SetRecordName(name);
+	devEK9000Terminal* term = m_terms[position - 1];
+	/* Already mapped, possibly with sizes and a codec read from the terminal itself. Only check it's what's expected */
+	if (m_init) {
+		if (uint32_t(term->m_terminalId) != type) {
+			epicsPrintf("%s: %s is configured as EL%u, but the terminal at position %d is EL%d\n", m_name.c_str(),
+						name, type, position, term->m_terminalId);
+			return EK_ETERMIDMIS;
+		}
+	}
+	else {
+		if (m_readTerminals && LayoutTerminalID(position) != type)
+			epicsPrintf("%s: %s is configured as EL%u, but the terminal at position %d is EL%u\n", m_name.c_str(),
+						name, type, position, LayoutTerminalID(position));
+		term->Init(type, position);
+	}
+	term->SetRecordName(name);
 	return EK_EOK;
 }
 
@@ -435,8 +999,8 @@ int devEK9000::InitTerminal(int term) {
 	if (term < 0 || term >= m_numTerms)
 		return EK_EBADPARAM;
 
-	/* Read ther terminal's id */
-	uint16_t tid = this->ReadTerminalID(term);
+	/* Look up the terminal's id */
+	uint16_t tid = this->LayoutTerminalID(term + 1);
 
 	/* Verify that the terminal has the proper id */
 	devEK9000Terminal* terminal = this->m_terms[term];
@@ -457,17 +1021,139 @@ bool devEK9000::ComputeTerminalMapping() {
 	}
 	m_init = true;
 
-	/* Gather a buffer of connected terminals */
-	uint16_t railLayout[0xFF];
-	memset(railLayout, 0, sizeof(railLayout));
-	for (int i = 0; i < 0xFF; i += 64) {
-		if (this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x6001 + i, railLayout + i, 64) != asynSuccess) {
+	/* A warm start only has to confirm the rail hasn't changed since the cache was written */
+	uint16_t serial = 0;
+	const bool caching = !layoutCacheDir.empty() && ReadSerialNumber(serial) == EK_EOK && serial != 0;
+	CachedLayout_t cached;
+	if (caching && LoadLayoutCache(LayoutCachePath(layoutCacheDir, serial), cached) && cached.serial == serial &&
+		VerifyCachedLayout(cached) && ApplyCachedMapping(cached)) {
+		DevInfo("%s: mapped from the layout cache (serial %u)\n", m_name.c_str(), serial);
+	}
+	else {
+		/* Read the whole rail once, records validate against this copy */
+		if (ReadRailLayout() != EK_EOK) {
 			epicsPrintf("%s: Failed to read rail layout from the device\n", __FUNCTION__);
+			/* Nothing is mapped yet, so ek9000Attach can try again */
+			m_init = false;
 			return false;
 		}
+		MapTerminals();
+		if (caching)
+			SaveLayoutCache(serial);
+	}
+
+	if (!m_declaredLayout.empty() &&
+		(m_railCount < (int)m_declaredLayout.size() ||
+		 !std::equal(m_declaredLayout.begin(), m_declaredLayout.end(), m_terminals + 1)))
+		epicsPrintf("%s: rail does not match the declared layout, mapping the rail\n", m_name.c_str());
+
+	LoadOutputImage();
+	return true;
+}
+
+bool devEK9000::VerifyCachedLayout(const CachedLayout_t& cached) {
+	const int railLen = cached.rail.size();
+	if (railLen < 1 || railLen >= TERMINAL_REGISTER_COUNT)
+		return false;
+
+	uint16_t ids[TERMINAL_REGISTER_COUNT];
+	int count = 0;
+	const int len = railLen + 1; /* Include the 0 past the end, so a longer rail shows up too */
+	if (len <= EK9000_MAX_READ_REGISTERS) {
+		memset(ids, 0, sizeof(ids));
+		if (this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x6000, ids, len) != asynSuccess)
+			return false;
+		count = std::find(ids + 1, ids + len, 0) - (ids + 1);
+	}
+	else if (FetchRailLayout(ids, count) != EK_EOK)
+		return false;
+
+	if (count != railLen - 1 || !std::equal(cached.rail.begin(), cached.rail.end(), ids))
+		return false;
+
+	memcpy(m_terminals, ids, sizeof(m_terminals));
+	m_railCount = count;
+	m_readTerminals = true;
+	return true;
+}
+
+bool devEK9000::ApplyCachedMapping(const CachedLayout_t& cached) {
+	if ((int)cached.terms.size() != m_numTerms)
+		return false;
+	/* The sizes in a cache written in the other mode are not the ones this mode would come up with */
+	if (cached.introspection != pdoIntrospection) {
+		epicsPrintf("%s: layout cache was written with PDO introspection %s, remapping\n", m_name.c_str(),
+					cached.introspection ? "on" : "off");
+		return false;
+	}
+	for (int i = 0; i < m_numTerms; i++) {
+		const CachedTerminal_t& entry = cached.terms[i];
+		devEK9000Terminal* term = m_terms[i];
+		term->Init(entry.id, i + 1);
+		if (entry.id != m_terminals[i + 1])
+			return false;
+		/* Sizes read from the terminal are taken as they are. Registry sizes are checked against the registry, which
+		 * may have changed since the cache was written. With introspection on, a terminal that fell back to the
+		 * registry (offline at boot, or the read failed) is introspected again by a full mapping */
+		if (entry.source == SIZE_SOURCE_PDO)
+			SetPdoSizes(term, entry.inputSize, entry.outputSize);
+		else if (pdoIntrospection && term->m_terminalFamily)
+			return false;
+		else if (term->m_inputSize != entry.inputSize || term->m_outputSize != entry.outputSize)
+			return false;
+		term->m_inputStart = entry.inputStart;
+		term->m_outputStart = entry.outputStart;
+	}
+	AllocateImages(cached.analogIn, cached.analogOut, cached.coilIn, cached.coilOut);
+	return true;
+}
+
+void devEK9000::SaveLayoutCache(uint16_t serial) {
+	CachedLayout_t cached;
+	cached.serial = serial;
+	cached.analogIn = m_analog_cnt;
+	cached.analogOut = m_aout_image.size() + EK9000_OUTPUT_REG_START;
+	cached.coilIn = m_digital_cnt + 1;
+	cached.coilOut = m_dout_count + 1;
+	cached.introspection = pdoIntrospection;
+	cached.rail.assign(m_terminals, m_terminals + m_railCount + 1);
+	cached.terms.resize(m_numTerms);
+	for (int i = 0; i < m_numTerms; i++) {
+		const devEK9000Terminal* term = m_terms[i];
+		CachedTerminal_t& entry = cached.terms[i];
+		entry.id = term->m_terminalId;
+		entry.inputStart = term->m_inputStart;
+		entry.outputStart = term->m_outputStart;
+		entry.inputSize = term->m_inputSize;
+		entry.outputSize = term->m_outputSize;
+		entry.source = term->m_sizesFromPdos ? SIZE_SOURCE_PDO : SIZE_SOURCE_REGISTRY;
+	}
+	StoreLayoutCache(LayoutCachePath(layoutCacheDir, serial), cached);
+}
+
+bool devEK9000::MapDeclaredLayout() {
+	if (m_init) {
+		epicsPrintf("devEK9000: Already initialized.\n");
+		return false;
 	}
+	m_init = true;
+
+	/* Stand in for the rail until the poll thread gets to read it */
+	memset(m_terminals, 0, sizeof(m_terminals));
+	m_terminals[0] = 9000;
+	std::copy(m_declaredLayout.begin(), m_declaredLayout.end(), m_terminals + 1);
+	m_railCount = m_declaredLayout.size();
+	m_readTerminals = true;
+	m_layoutPending = true;
 
-	assert(size_t(m_numTerms) <= ArraySize(railLayout));
+	MapTerminals();
+	return true;
+}
+
+void devEK9000::MapTerminals() {
+	assert(size_t(m_numTerms) < ArraySize(m_terminals));
+	if (m_railCount != m_numTerms)
+		epicsPrintf("%s: %d terminals configured, but %d found on the rail\n", m_name.c_str(), m_numTerms, m_railCount);
 
 	/* Figure out the register map */
 	int coil_in = 1, coil_out = 1;
@@ -478,7 +1164,15 @@ bool devEK9000::ComputeTerminalMapping() {
 	/* holding registers can have bit offsets */
 	for (int i = 0; i < this->m_numTerms; i++) {
 		devEK9000Terminal* term = m_terms[i];
-		term->Init(railLayout[i], i);
+		term->Init(m_terminals[i + 1], i + 1);
+		/* Only possible on the real rail, a declared layout is sized from the registry */
+		int inp, outp;
+		if (pdoIntrospection && !m_layoutPending && i < m_railCount && term->m_terminalFamily &&
+			ReadPdoSizes(i + 1, term->m_terminalFamily, inp, outp) == EK_EOK)
+			SetPdoSizes(term, inp, outp);
+		else if (i < m_railCount && !util::FindTerminal(m_terminals[i + 1]))
+			epicsPrintf("%s: unsupported terminal EL%u at position %d, terminals after it may be mapped incorrectly\n",
+						m_name.c_str(), m_terminals[i + 1], i + 1);
 		if (term->m_terminalFamily == TERMINAL_FAMILY_ANALOG) {
 			DevInfo("Mapped %u: inp_start(0x%X) out_start(0x%X) inp_size(0x%X) outp_size(0x%X)\n", term->m_terminalId,
 					reg_in, reg_out, term->m_inputSize, term->m_outputSize);
@@ -496,27 +1190,712 @@ bool devEK9000::ComputeTerminalMapping() {
 			coil_out += term->m_outputSize;
 		}
 	}
-	/* Now that we have counts, allocate buffer space! */
-	scanIoInit(&m_analog_io);
-	scanIoInit(&m_digital_io);
-	scanIoInit(&m_status_io);
-	m_analog_cnt = reg_in;
-	if (m_analog_cnt)
-		m_analog_buf = (uint16_t*)calloc(m_analog_cnt, sizeof(uint16_t)); /* We read status bits too! */
-	else
-		m_analog_buf = NULL;
-	m_digital_cnt = coil_in - 1;
-	if (coil_in != 1)
-		// Despite being 1-bit inputs, the modbus driver gives us one digital input per 16-bit int in the output buffer
-		m_digital_buf = (uint16_t*)calloc(m_digital_cnt, sizeof(uint16_t));
-	else
-		m_digital_buf = NULL;
-	return true;
+	AllocateImages(reg_in, reg_out, coil_in, coil_out);
 }
 
-int devEK9000::VerifyConnection() const {
-	/* asynUsers should be pretty cheap to create */
-	asynUser* usr = pasynManager->createAsynUser(NULL, NULL);
+int devEK9000::ReadPdoSizes(int pos, int family, int& inputSize, int& outputSize) {
+	static const uint16_t assignments[] = {0x1C13, 0x1C12}; /* TxPDOs (inputs), RxPDOs (outputs) */
+	int bits[2] = {0, 0};
+	for (int dir = 0; dir < 2; ++dir) {
+		uint16_t count = 0;
+		int status = CoETransfer(0, (uint16_t)pos, assignments[dir], 1, &count, 0);
+		if (status != EK_EOK)
+			return status;
+		for (uint16_t i = 1; i <= (count & 0xFF); ++i) {
+			uint16_t pdo = 0, entries = 0;
+			if ((status = CoETransfer(0, (uint16_t)pos, assignments[dir], 1, &pdo, i)) != EK_EOK ||
+				(status = CoETransfer(0, (uint16_t)pos, pdo, 1, &entries, 0)) != EK_EOK)
+				return status;
+			/* Each entry is index:16 subindex:8 bit length:8, gaps are entries with index 0 and count all the same */
+			for (uint16_t e = 1; e <= (entries & 0xFF); ++e) {
+				uint16_t entry[2] = {0, 0};
+				if ((status = CoETransfer(0, (uint16_t)pos, pdo, 2, entry, e)) != EK_EOK)
+					return status;
+				bits[dir] += entry[0] & 0xFF;
+			}
+		}
+	}
+
+	if (family == TERMINAL_FAMILY_DIGITAL) {
+		inputSize = bits[0];
+		outputSize = bits[1];
+	}
+	else {
+		/* The coupler rounds each terminal up to whole registers */
+		inputSize = (bits[0] + 15) / 16;
+		outputSize = (bits[1] + 15) / 16;
+	}
+	return EK_EOK;
+}
+
+void devEK9000::SetPdoSizes(devEK9000Terminal* term, int inputSize, int outputSize) {
+	const terminal_t* info = util::FindTerminal(term->m_terminalId);
+	if (!info)
+		LOG_WARNING(this, "%s: unsupported terminal EL%d at position %d sized from its PDOs (%d in, %d out)\n",
+					m_name.c_str(), term->m_terminalId, term->m_terminalIndex, inputSize, outputSize);
+	else if (info->inputSize != inputSize || info->outputSize != outputSize)
+		LOG_WARNING(this, "%s: EL%d at position %d has a non-standard PDO mapping (%d in, %d out)\n", m_name.c_str(),
+					term->m_terminalId, term->m_terminalIndex, inputSize, outputSize);
+
+	/* Compact PDO, the value without the status word: half the registers of a standard terminal */
+	const TerminalCodec_t* codec = util::FindCodec(term->m_terminalId);
+	if (codec && info && inputSize != info->inputSize)
+		codec = codec->stride == 2 && inputSize * 2 == info->inputSize ? &s_compactCodec : NULL;
+	term->m_codec = codec;
+	term->m_inputSize = inputSize;
+	term->m_outputSize = outputSize;
+	term->m_sizesFromPdos = true;
+}
+
+void devEK9000::AllocateImages(int reg_in, int reg_out, int coil_in, int coil_out) {
+	/* Now that we have counts, allocate buffer space! */
+	m_analog_cnt = reg_in;
+	if (m_analog_cnt) {
+		m_analog_buf = (uint16_t*)calloc(m_analog_cnt, sizeof(uint16_t)); /* We read status bits too! */
+		m_analog_back = (uint16_t*)calloc(m_analog_cnt, sizeof(uint16_t));
+	}
+	else
+		m_analog_buf = m_analog_back = NULL;
+	SetupInputDecode();
+	m_digital_cnt = coil_in - 1;
+	if (coil_in != 1) {
+		// Kept packed, one bit per input, straight from the FC2 response
+		m_digital_bits = (uint8_t*)calloc(bits::PackedSize(m_digital_cnt), 1);
+		m_digital_back = (uint8_t*)calloc(bits::PackedSize(m_digital_cnt), 1);
+	}
+	else
+		m_digital_bits = m_digital_back = NULL;
+
+	m_aout_image.assign(reg_out - EK9000_OUTPUT_REG_START, 0);
+	m_aout_owned.assign(m_aout_image.size(), false);
+	m_dout_count = coil_out - 1;
+	m_dout_image.assign(bits::PackedSize(m_dout_count), 0);
+	m_dout_owned.assign(m_dout_image.size(), 0);
+
+	PublishRail(m_terminals, m_railCount);
+}
+
+void devEK9000::LoadOutputImage() {
+	/* Read back the current state of all outputs, so records can initialize from it instead of glitching them */
+	int status = ReadOutputImage(m_aout_image.empty() ? NULL : &m_aout_image[0],
+								 m_dout_image.empty() ? NULL : &m_dout_image[0]);
+	m_outputImageValid = status == EK_EOK;
+	if (!m_outputImageValid)
+		epicsPrintf("%s: Failed to read output image, outputs will not be initialized from the device\n", m_name.c_str());
+}
+
+void devEK9000::ValidateDeclaredLayout() {
+	uint16_t rail[TERMINAL_REGISTER_COUNT];
+	int count = 0;
+	if (FetchRailLayout(rail, count) != EK_EOK) {
+		LOG_WARNING(this, "%s: unable to read the rail layout, will retry on the next connect check\n", m_name.c_str());
+		return;
+	}
+	m_layoutPending = false;
+
+	/* A wrong declaration is treated like a rail change, terminals before the first difference still work */
+	const bool match = count >= m_railCount && std::equal(m_terminals + 1, m_terminals + m_railCount + 1, rail + 1);
+	if (!match)
+		LOG_ERROR(this, "%s: rail does not match the declared layout\n", m_name.c_str());
+	PublishRail(rail, count);
+
+	/* Arm the watchdog, as BringUp would have done */
+	uint16_t buf = 1;
+	this->doModbusIO(0, MODBUS_WRITE_SINGLE_REGISTER, 0x1122, &buf, 1);
+	LoadOutputImage();
+	if (!match)
+		return;
+	ApplyPresets();
+
+	/* Confirmed against the rail, so it's as good as a fresh mapping for the next boot */
+	uint16_t serial = 0;
+	if (!layoutCacheDir.empty() && ReadSerialNumber(serial) == EK_EOK && serial != 0)
+		SaveLayoutCache(serial);
+	LOG_WARNING(this, "%s: rail matches the declared layout, terminal I/O enabled\n", m_name.c_str());
+}
+
+uint32_t RailSnapshot_t::Span(ERailImage image, uint32_t addr, uint32_t count, uint32_t& rail) const {
+	/* Find the last segment starting at or before addr */
+	const std::vector<RailSegment_t>& list = segments[image];
+	size_t lo = 0, hi = list.size();
+	while (lo < hi) {
+		const size_t mid = (lo + hi) / 2;
+		if (list[mid].mapped <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (!lo || addr >= list[lo - 1].mapped + list[lo - 1].count)
+		return 0;
+	const RailSegment_t& seg = list[lo - 1];
+	rail = seg.rail + (addr - seg.mapped);
+	return std::min(count, seg.mapped + seg.count - addr);
+}
+
+bool RailSnapshot_t::Covers(ERailImage image, uint32_t addr, uint32_t count) const {
+	for (uint32_t rail = 0, n = 0; count; addr += n, count -= n)
+		if (!(n = Span(image, addr, count, rail)))
+			return false;
+	return true;
+}
+
+/* Append a terminal's part of an image, merging it with the previous segment where both layouts continue it */
+static void AddSegment(std::vector<RailSegment_t>& segments, uint32_t mapped, uint32_t rail, uint32_t count) {
+	if (!count)
+		return;
+	RailSegment_t* last = segments.empty() ? NULL : &segments.back();
+	if (last && last->mapped + last->count == mapped && last->rail + last->count == rail)
+		last->count += count;
+	else {
+		RailSegment_t seg = {mapped, rail, count};
+		segments.push_back(seg);
+	}
+}
+
+static bool SameSegments(const std::vector<RailSegment_t>& a, const std::vector<RailSegment_t>& b) {
+	if (a.size() != b.size())
+		return false;
+	for (size_t i = 0; i < a.size(); ++i)
+		if (a[i].mapped != b[i].mapped || a[i].rail != b[i].rail || a[i].count != b[i].count)
+			return false;
+	return true;
+}
+
+bool devEK9000::PublishRail(const uint16_t* ids, int count) {
+	RailSnapshot_t* next = new RailSnapshot_t;
+	memset(next->ids, 0, sizeof(next->ids));
+	memcpy(next->ids, ids, (count + 1) * sizeof(uint16_t));
+	next->count = count;
+	next->firstMoved = next->unusable = 0;
+	next->remapped = false;
+	next->retiredAt = 0;
+
+	/* Same walk as MapTerminals, over the rail as it is now. A terminal that is still at its position brings its
+	 * mapped sizes along, one that changed is sized from the registry. Past one we can't size, nothing can be located */
+	uint32_t regIn = 0, regOut = 0, coilIn = 0, coilOut = 0;
+	int unknown = 0;
+	for (int pos = 1; pos < TERMINAL_REGISTER_COUNT; ++pos) {
+		const uint16_t mapped = pos <= m_railCount ? m_terminals[pos] : 0;
+		const bool moved = next->ids[pos] != mapped;
+		if (pos > m_numTerms) {
+			next->usable[pos] = !moved;
+			continue;
+		}
+		if (moved && !next->firstMoved)
+			next->firstMoved = pos;
+		next->usable[pos] = !moved && !unknown;
+		if (!next->usable[pos])
+			++next->unusable;
+		if (unknown)
+			continue;
+
+		const devEK9000Terminal* term = m_terms[pos - 1];
+		int family = term->m_terminalFamily, inputSize = term->m_inputSize, outputSize = term->m_outputSize;
+		if (moved) {
+			/* Introspected sizes need the mailbox, which the poll thread can't wait on */
+			const terminal_t* info = util::FindTerminal(next->ids[pos]);
+			family = devEK9000Terminal::GetTerminalFamily(next->ids[pos]);
+			inputSize = info ? info->inputSize : 0;
+			outputSize = info ? info->outputSize : 0;
+			if (family && (!info || pdoIntrospection)) {
+				unknown = pos;
+				continue;
+			}
+		}
+
+		if (family == TERMINAL_FAMILY_ANALOG) {
+			if (next->usable[pos]) {
+				AddSegment(next->segments[RAIL_ANALOG_IN], term->m_inputStart, regIn, inputSize);
+				AddSegment(next->segments[RAIL_REGISTER_OUT], term->m_outputStart - EK9000_OUTPUT_REG_START, regOut,
+						   outputSize);
+				next->remapped |= uint32_t(term->m_inputStart) != regIn ||
+								  uint32_t(term->m_outputStart - EK9000_OUTPUT_REG_START) != regOut;
+			}
+			regIn += inputSize;
+			regOut += outputSize;
+		}
+		else if (family == TERMINAL_FAMILY_DIGITAL) {
+			/* Digital starts are 1-based */
+			if (next->usable[pos]) {
+				AddSegment(next->segments[RAIL_DIGITAL_IN], term->m_inputStart - 1, coilIn, inputSize);
+				AddSegment(next->segments[RAIL_COIL_OUT], term->m_outputStart - 1, coilOut, outputSize);
+				next->remapped |=
+					uint32_t(term->m_inputStart - 1) != coilIn || uint32_t(term->m_outputStart - 1) != coilOut;
+			}
+			coilIn += inputSize;
+			coilOut += outputSize;
+		}
+	}
+
+	RailSnapshot_t* prev = static_cast<RailSnapshot_t*>(epicsAtomicGetPtrT(&m_rail));
+	epicsSpinLock(m_inputSpin);
+	epicsAtomicSetPtrT(&m_rail, next);
+	epicsSpinUnlock(m_inputSpin);
+
+	bool moved = false;
+	if (prev) {
+		moved = !SameSegments(prev->segments[RAIL_REGISTER_OUT], next->segments[RAIL_REGISTER_OUT]) ||
+				!SameSegments(prev->segments[RAIL_COIL_OUT], next->segments[RAIL_COIL_OUT]);
+		if (next->firstMoved) {
+			const int pos = next->firstMoved;
+			LOG_ERROR(this,
+					  "%s: rail changed, position %d is now EL%u (mapped as EL%u). Records on the positions that "
+					  "changed are INVALID until the rail is restored\n",
+					  m_name.c_str(), pos, next->ids[pos], pos <= m_railCount ? m_terminals[pos] : 0);
+		}
+		if (unknown && unknown < m_numTerms)
+			LOG_ERROR(this,
+					  "%s: unable to size EL%u at position %d, records on positions %d-%d are INVALID until the rail "
+					  "is restored\n",
+					  m_name.c_str(), next->ids[unknown], unknown, unknown + 1, m_numTerms);
+		if (next->remapped)
+			LOG_WARNING(this, "%s: terminals shifted in the process image, records on unchanged positions remapped\n",
+						m_name.c_str());
+		if (!next->unusable && prev->unusable)
+			LOG_WARNING(this, "%s: rail is back to its mapped layout, all terminals usable again\n", m_name.c_str());
+		else if (!next->firstMoved)
+			LOG_WARNING(this, "%s: rail changed past the configured terminals, now %d terminals\n", m_name.c_str(),
+						count);
+
+		/* From the first position that differs on, terminals may have been unplugged and put back, or swapped for
+		 * another of the same type, either way with settings other than the cached ones. That includes a restore */
+		int changed = 1;
+		while (changed < TERMINAL_REGISTER_COUNT && prev->ids[changed] == next->ids[changed])
+			++changed;
+		for (int pos = changed; pos <= m_numTerms; ++pos)
+			InvalidateCoECache(pos);
+
+		prev->retiredAt = epicsAtomicGetSizeT(&s_pollEpoch);
+		m_retiredRails.push_back(prev);
+	}
+	ReclaimRails();
+	return moved;
+}
+
+void devEK9000::ReclaimRails() {
+	const size_t epoch = epicsAtomicGetSizeT(&s_pollEpoch);
+	for (std::vector<RailSnapshot_t*>::iterator it = m_retiredRails.begin(); it != m_retiredRails.end();) {
+		if (!g_PollThread || epoch > (*it)->retiredAt) {
+			delete *it;
+			it = m_retiredRails.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+bool devEK9000::PositionUnchanged(int pos) const {
+	if (pos < 0 || pos >= TERMINAL_REGISTER_COUNT)
+		return false;
+	epicsSpinLock(m_inputSpin);
+	const RailSnapshot_t* rail = Rail();
+	const bool same = rail && rail->ids[pos] == (pos <= m_railCount ? m_terminals[pos] : 0);
+	epicsSpinUnlock(m_inputSpin);
+	return same;
+}
+
+int devEK9000::CheckRail() {
+	uint16_t ids[TERMINAL_REGISTER_COUNT];
+	int count = 0;
+	int status = FetchRailLayout(ids, count);
+	if (status != EK_EOK)
+		return status;
+
+	const RailSnapshot_t* rail = Rail();
+	if (rail && rail->count == count && !memcmp(rail->ids, ids, (count + 1) * sizeof(uint16_t)))
+		return EK_EOK;
+
+	/* The coupler rebuilds its process image when the bus changes, put back outputs that moved or came back */
+	if (PublishRail(ids, count))
+		m_pendingRestore = "rail change";
+	return EK_EOK;
+}
+
+bool devEK9000::CoilsActive(size_t addr, size_t count) const {
+	const RailSnapshot_t* rail = Rail();
+	return rail && rail->Covers(RAIL_COIL_OUT, addr, count);
+}
+
+bool devEK9000::RegistersActive(size_t addr, size_t count) const {
+	const RailSnapshot_t* rail = Rail();
+	return rail && addr >= EK9000_OUTPUT_REG_START &&
+		   rail->Covers(RAIL_REGISTER_OUT, addr - EK9000_OUTPUT_REG_START, count);
+}
+
+int devEK9000::AutoConfigure(const char* dbDir, const char* base, const char* macros) {
+	/* Reuse the layout if the coupler has been mapped, otherwise read it now, or fall back to the declared one */
+	std::vector<uint16_t> ids;
+	if (m_readTerminals)
+		ids.assign(m_terminals + 1, m_terminals + 1 + m_railCount);
+	else {
+		uint16_t rail[TERMINAL_REGISTER_COUNT];
+		int count = 0;
+		DeviceLock lock(this);
+		if (lock.valid() && VerifyConnection() && FetchRailLayout(rail, count) == EK_EOK)
+			ids.assign(rail + 1, rail + 1 + count);
+		else if (!m_declaredLayout.empty()) {
+			epicsPrintf("%s: coupler unreachable, using its declared layout\n", m_name.c_str());
+			ids = m_declaredLayout;
+		}
+		else {
+			epicsPrintf("%s: unable to read the rail layout\n", m_name.c_str());
+			return -1;
+		}
+	}
+
+	if ((int)ids.size() > m_numTerms)
+		epicsPrintf("%s: %u terminals on the rail, only the first %d are configured\n", m_name.c_str(),
+					(unsigned)ids.size(), m_numTerms);
+
+	int loaded = 0;
+	for (int pos = 1; pos <= (int)ids.size() && pos <= m_numTerms; ++pos) {
+		const terminal_t* info = util::FindTerminal(ids[pos - 1]);
+		if (!info) {
+			/* Same as the mapping, nothing after an unknown terminal can be trusted */
+			epicsPrintf("%s: unsupported terminal EL%u at position %d, stopping here\n", m_name.c_str(), ids[pos - 1],
+						pos);
+			break;
+		}
+
+		std::string path = dbDir;
+		path.append("/").append(info->str).append(".template");
+		FILE* fp = fopen(path.c_str(), "r");
+		if (!fp) {
+			epicsPrintf("%s: no template for %s at position %d (%s), skipping it\n", m_name.c_str(), info->str, pos,
+						path.c_str());
+			continue;
+		}
+		fclose(fp);
+
+		/* Built up as a string, user macros can be any length */
+		char num[16];
+		epicsSnprintf(num, sizeof(num), "%d", pos);
+		std::string subs = "TERMINAL=";
+		subs.append(base).append(num).append(",DEVICE=").append(m_name).append(",POS=").append(num);
+		if (macros && *macros)
+			subs.append(",").append(macros);
+		if (dbLoadRecords(path.c_str(), subs.c_str()) != 0) {
+			epicsPrintf("%s: failed to load %s for position %d\n", m_name.c_str(), path.c_str(), pos);
+			return -1;
+		}
+		++loaded;
+	}
+	return loaded;
+}
+
+bool devEK9000::DeclareLayout(const char* name, const std::vector<uint16_t>& ids) {
+	devEK9000* dev = FindDevice(name);
+	if (dev) {
+		if (dev->m_init) {
+			epicsPrintf("devEK9000::DeclareLayout(): %s is already mapped\n", name);
+			return false;
+		}
+		dev->m_declaredLayout = ids;
+	}
+	DeclaredLayouts()[name] = ids;
+	return true;
+}
+
+int devEK9000::DoModbusPDU(const uint8_t* req, size_t reqLen, uint8_t* resp, size_t respSize, size_t& respLen) {
+	if (!m_octetUser && pasynOctetSyncIO->connect(m_octetPortName.c_str(), 0, &m_octetUser, NULL) != asynSuccess) {
+		m_octetUser = NULL;
+		return EK_ENOCONN;
+	}
+
+	size_t written = 0;
+	int eomReason = 0;
+	respLen = 0;
+	if (pasynOctetSyncIO->writeRead(m_octetUser, (const char*)req, reqLen, (char*)resp, respSize, EK9000_PDU_TIMEOUT,
+									&written, &respLen, &eomReason) != asynSuccess)
+		return EK_EMODBUSERR;
+	/* Exception responses come back with the top bit of the function code set */
+	if (respLen < 2 || resp[1] != req[1])
+		return EK_EMODBUSERR;
+	return EK_EOK;
+}
+
+int devEK9000::WriteCoilsPacked(uint16_t addr, const uint8_t* src, size_t srcBit, uint16_t count) {
+	uint8_t req[7 + EK9000_MAX_WRITE_COILS / 8], resp[16];
+	size_t respLen = 0;
+
+	if (!TerminalIOEnabled() || !CoilsActive(addr, count))
+		return EK_ELAYOUT;
+
+	const RailSnapshot_t* rail = Rail();
+	for (uint16_t done = 0; done < count;) {
+		/* Split where the coils stop being contiguous on the rail */
+		uint32_t railStart = 0;
+		const uint16_t n = std::min(rail->Span(RAIL_COIL_OUT, addr + done, count - done, railStart),
+									uint32_t(EK9000_MAX_WRITE_COILS));
+		const uint16_t start = addr + done;
+		const size_t bytes = bits::PackedSize(n);
+
+		/* FC15 PDU, the interpose layer on the octet port adds the MBAP header */
+		req[0] = EK9000_SLAVE_ID;
+		req[1] = MODBUS_WRITE_MULTIPLE_COILS;
+		req[2] = railStart >> 8;
+		req[3] = railStart & 0xFF;
+		req[4] = n >> 8;
+		req[5] = n & 0xFF;
+		req[6] = (uint8_t)bytes;
+		req[6 + bytes] = 0; /* Pad bits past the end must be zero */
+		bits::CopyBits(req + 7, 0, src, srcBit + done, n);
+
+		int status = DoModbusPDU(req, 7 + bytes, resp, sizeof(resp), respLen);
+		if (status != EK_EOK)
+			return status;
+
+		/* Keep the output image in sync */
+		if (size_t(start) + n <= m_dout_count) {
+			bits::CopyBits(&m_dout_image[0], start, req + 7, 0, n);
+			for (uint16_t i = 0; i < n; i += 32)
+				bits::SetBits(&m_dout_owned[0], start + i, std::min(n - i, 32), 0xFFFFFFFFu);
+		}
+		done += n;
+	}
+	return EK_EOK;
+}
+
+int devEK9000::WriteCoils(uint16_t addr, uint32_t value, uint16_t count) {
+	const uint8_t packed[4] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+	return WriteCoilsPacked(addr, packed, 0, count);
+}
+
+int devEK9000::ReadBitsPacked(int function, uint16_t addr, uint8_t* dst, size_t dstBit, uint16_t count) {
+	uint8_t req[6], resp[3 + EK9000_MAX_READ_COILS / 8];
+	size_t respLen = 0;
+
+	for (uint16_t done = 0; done < count;) {
+		const uint16_t n = std::min(count - done, EK9000_MAX_READ_COILS);
+		const uint16_t start = addr + done;
+
+		req[0] = EK9000_SLAVE_ID;
+		req[1] = (uint8_t)function;
+		req[2] = start >> 8;
+		req[3] = start & 0xFF;
+		req[4] = n >> 8;
+		req[5] = n & 0xFF;
+
+		int status = DoModbusPDU(req, sizeof(req), resp, sizeof(resp), respLen);
+		if (status != EK_EOK)
+			return status;
+		if (respLen < 3 + bits::PackedSize(n) || resp[2] != bits::PackedSize(n))
+			return EK_EMODBUSERR;
+
+		/* The response is already in the packed layout, it only needs shifting into place */
+		if ((dstBit + done) % 8 == 0 && n % 8 == 0)
+			memcpy(dst + (dstBit + done) / 8, resp + 3, bits::PackedSize(n));
+		else
+			bits::CopyBits(dst, dstBit + done, resp + 3, 0, n);
+		done += n;
+	}
+	return EK_EOK;
+}
+
+int devEK9000::ReadInputSegments(const RailSnapshot_t* rail, ERailImage image) {
+	/* One read per segment, straight to where the records expect it */
+	const std::vector<RailSegment_t>& segments = rail->segments[image];
+	for (size_t i = 0; i < segments.size(); ++i) {
+		const RailSegment_t& seg = segments[i];
+		int status;
+		if (image == RAIL_DIGITAL_IN)
+			status = ReadBitsPacked(MODBUS_READ_DISCRETE_INPUTS, seg.rail, m_digital_back, seg.mapped, seg.count);
+		else
+			status = doModbusIO(0, MODBUS_READ_INPUT_REGISTERS, seg.rail, m_analog_back + seg.mapped, seg.count);
+		if (status != EK_EOK)
+			return status;
+	}
+	return EK_EOK;
+}
+
+int devEK9000::ReadOutputImage(uint16_t* aout, uint8_t* dout) {
+	/* Just the usable part of the image, from wherever it is on the rail now. The rest belongs to terminals that
+	 * changed */
+	const RailSnapshot_t* rail = Rail();
+	const std::vector<RailSegment_t>& registers = rail->segments[RAIL_REGISTER_OUT];
+	for (size_t s = 0; s < registers.size(); ++s) {
+		const RailSegment_t& seg = registers[s];
+		for (uint32_t i = 0; i < seg.count; i += EK9000_MAX_READ_REGISTERS) {
+			const int len = std::min(seg.count - i, uint32_t(EK9000_MAX_READ_REGISTERS));
+			if (doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, EK9000_OUTPUT_REG_START + seg.rail + i,
+						   aout + seg.mapped + i, len) != asynSuccess)
+				return EK_EMODBUSERR;
+		}
+	}
+	const std::vector<RailSegment_t>& coils = rail->segments[RAIL_COIL_OUT];
+	for (size_t s = 0; s < coils.size(); ++s) {
+		int status = ReadBitsPacked(MODBUS_READ_COILS, coils[s].rail, dout, coils[s].mapped, coils[s].count);
+		if (status != EK_EOK)
+			return status;
+	}
+	return EK_EOK;
+}
+
+bool devEK9000::ClaimRegisters(uint16_t addr, uint16_t len, uint16_t* current) {
+	addr -= EK9000_OUTPUT_REG_START;
+
+	DeviceLock lock(this);
+	if (!lock.valid() || size_t(addr) + len > m_aout_image.size())
+		return false;
+
+	for (uint16_t i = 0; i < len; ++i) {
+		m_aout_owned[addr + i] = true;
+		if (current)
+			current[i] = m_aout_image[addr + i];
+	}
+	return m_outputImageValid;
+}
+
+bool devEK9000::ClaimCoils(uint16_t addr, uint16_t len, uint32_t* current) {
+	DeviceLock lock(this);
+	if (!lock.valid() || len > 32 || size_t(addr) + len > m_dout_count)
+		return false;
+
+	bits::SetBits(&m_dout_owned[0], addr, len, 0xFFFFFFFFu);
+	if (current)
+		*current = bits::GetBits(&m_dout_image[0], addr, len);
+	return m_outputImageValid;
+}
+
+uint32_t devEK9000::OutputCoils(uint16_t addr, uint16_t len) const {
+	if (len > 32 || size_t(addr) + len > m_dout_count)
+		return 0;
+	return bits::GetBits(&m_dout_image[0], addr, len);
+}
+
+uint16_t devEK9000::OutputRegister(uint16_t addr) const {
+	addr -= EK9000_OUTPUT_REG_START;
+	return addr < m_aout_image.size() ? m_aout_image[addr] : 0;
+}
+
+void devEK9000::UpdateOutputImage(int function, uint16_t addr, const uint16_t* data, uint16_t len) {
+	/* Coil writes go through WriteCoilsPacked, which keeps the image up to date itself */
+	if ((function != MODBUS_WRITE_MULTIPLE_REGISTERS && function != MODBUS_WRITE_SINGLE_REGISTER) ||
+		addr < EK9000_OUTPUT_REG_START)
+		return;
+	addr -= EK9000_OUTPUT_REG_START;
+	if (size_t(addr) + len > m_aout_image.size())
+		return;
+
+	for (uint16_t i = 0; i < len; ++i) {
+		m_aout_image[addr + i] = data[i];
+		m_aout_owned[addr + i] = true;
+	}
+}
+
+int devEK9000::WriteRegisters(uint16_t addr, const uint16_t* data, uint16_t len) {
+	if (!TerminalIOEnabled() || !RegistersActive(addr, len))
+		return EK_ELAYOUT;
+
+	/* A terminal's registers stay together, so this only splits where the write crosses into another terminal that
+	 * moved */
+	const RailSnapshot_t* rail = Rail();
+	for (uint16_t done = 0; done < len;) {
+		uint32_t start = 0;
+		const uint16_t n = rail->Span(RAIL_REGISTER_OUT, addr - EK9000_OUTPUT_REG_START + done, len - done, start);
+		if (doModbusIO(0, MODBUS_WRITE_MULTIPLE_REGISTERS, EK9000_OUTPUT_REG_START + start,
+					   const_cast<uint16_t*>(data + done), n) != asynSuccess)
+			return EK_EMODBUSERR;
+		done += n;
+	}
+	UpdateOutputImage(MODBUS_WRITE_MULTIPLE_REGISTERS, addr, data, len);
+	return EK_EOK;
+}
+
+int devEK9000::VerifyOutputImage() {
+	std::vector<uint16_t> aout(m_aout_image.size());
+	std::vector<uint8_t> dout(m_dout_image.size());
+	int status = ReadOutputImage(aout.empty() ? NULL : &aout[0], dout.empty() ? NULL : &dout[0]);
+	if (status != EK_EOK)
+		return status;
+
+	/* Only what ReadOutputImage read */
+	const RailSnapshot_t* rail = Rail();
+	const std::vector<RailSegment_t>& registers = rail->segments[RAIL_REGISTER_OUT];
+	const std::vector<RailSegment_t>& coils = rail->segments[RAIL_COIL_OUT];
+	int drift = 0, first = -1;
+	for (size_t s = 0; s < registers.size(); ++s) {
+		for (size_t i = registers[s].mapped; i < registers[s].mapped + registers[s].count; ++i) {
+			if (m_aout_owned[i] && aout[i] != m_aout_image[i] && drift++ == 0)
+				first = EK9000_OUTPUT_REG_START + i;
+		}
+	}
+	for (size_t s = 0; s < coils.size(); ++s) {
+		const size_t end = coils[s].mapped + coils[s].count;
+		for (size_t i = coils[s].mapped; i < end; i += 32) {
+			const unsigned n = std::min(end - i, size_t(32));
+			const uint32_t diff = (bits::GetBits(&dout[0], i, n) ^ bits::GetBits(&m_dout_image[0], i, n)) &
+								  bits::GetBits(&m_dout_owned[0], i, n);
+			if (diff && drift == 0)
+				first = i + bits::PopCount((diff & (~diff + 1)) - 1);
+			drift += bits::PopCount(diff);
+		}
+	}
+
+	/* Only warn when drift first shows up, the counters track it from then on */
+	if (drift && !epicsAtomicGetIntT(&m_counters[COUNTER_OUTPUT_DRIFT]))
+		LOG_WARNING(this, "%s: %d outputs differ from their commanded value (first at 0x%X)\n", m_name.c_str(), drift,
+					first);
+	epicsAtomicSetIntT(&m_counters[COUNTER_OUTPUT_DRIFT], drift);
+	epicsAtomicAddIntT(&m_counters[COUNTER_OUTPUT_DRIFT_TOTAL], drift);
+	epicsAtomicIncrIntT(&m_counters[COUNTER_OUTPUT_VERIFIES]);
+	return EK_EOK;
+}
+
+int devEK9000::RestoreOutputs(const char* reason) {
+	int writes = 0, status = EK_EOK;
+	const RailSnapshot_t* rail = Rail();
+	const std::vector<RailSegment_t>& registers = rail->segments[RAIL_REGISTER_OUT];
+	const std::vector<RailSegment_t>& coils = rail->segments[RAIL_COIL_OUT];
+
+	/* Write each contiguous run of owned outputs within a usable segment, split at the max transaction size. Both
+	 * write paths write straight from the image, which leaves it unchanged */
+	for (size_t s = 0; s < registers.size() && status == EK_EOK; ++s) {
+		const size_t end = registers[s].mapped + registers[s].count;
+		for (size_t i = registers[s].mapped; i < end && status == EK_EOK;) {
+			if (!m_aout_owned[i]) {
+				++i;
+				continue;
+			}
+			size_t len = 1;
+			while (i + len < end && m_aout_owned[i + len] && len < EK9000_MAX_WRITE_REGISTERS)
+				++len;
+			status = WriteRegisters(EK9000_OUTPUT_REG_START + i, &m_aout_image[i], len);
+			++writes;
+			i += len;
+		}
+	}
+	for (size_t s = 0; s < coils.size() && status == EK_EOK; ++s) {
+		const size_t limit = coils[s].mapped + coils[s].count;
+		for (size_t i = bits::NextSet(&m_dout_owned[0], coils[s].mapped, limit); i < limit && status == EK_EOK;) {
+			const size_t end = bits::RunEnd(&m_dout_owned[0], i, limit);
+			status = WriteCoilsPacked(i, &m_dout_image[0], i, end - i);
+			writes += (end - i + EK9000_MAX_WRITE_COILS - 1) / EK9000_MAX_WRITE_COILS;
+			i = bits::NextSet(&m_dout_owned[0], end, limit);
+		}
+	}
+
+	if (status != EK_EOK) {
+		LOG_WARNING(this, "%s: failed to restore outputs after %s: %s\n", m_name.c_str(), reason, ErrorToString(status));
+		return status;
+	}
+
+	epicsTimeStamp now;
+	epicsTimeGetCurrent(&now);
+	epicsAtomicIncrIntT(&m_counters[COUNTER_OUTPUT_RESTORES]);
+	epicsAtomicSetIntT(&m_counters[COUNTER_OUTPUT_RESTORE_TIME], (int)now.secPastEpoch);
+	LOG_WARNING(this, "%s: restored outputs after %s (%d writes)\n", m_name.c_str(), reason, writes);
+	scanIoRequest(m_status_io);
+	return EK_EOK;
+}
+
+int devEK9000::GetCounter(EDriverCounter counter) const {
+	return epicsAtomicGetIntT(&m_counters[counter]);
+}
+
+int devEK9000::VerifyConnection() const {
+	/* asynUsers should be pretty cheap to create */
+	asynUser* usr = pasynManager->createAsynUser(NULL, NULL);
 	usr->timeout = 0.5; /* 500ms timeout */
 
 	/* Try for connection */
@@ -530,76 +1909,423 @@ int devEK9000::VerifyConnection() const {
 	return yn;
 }
 
-int devEK9000::CoEVerifyConnection(uint16_t termid) {
-	uint16_t dat;
-	if (this->doCoEIO(0, (uint16_t)termid, 1008, 1, &dat, 0) != EK_EOK) {
-		return 0;
+int devEK9000::CoEVerifyConnection(uint16_t termid) {
+	uint16_t dat;
+	if (this->doCoEIO(0, (uint16_t)termid, 1008, 1, &dat, 0) != EK_EOK) {
+		return 0;
+	}
+	return 1;
+}
+
+/* 1 for write and 0 for read */
+/* LENGTH IS IN REGISTERS */
+int devEK9000::doCoEIO(int rw, uint16_t term, uint16_t index, uint16_t len, uint16_t* data, uint16_t subindex,
+					   uint16_t reallen) {
+	/* The terminal at this position may not be the one the record was set up for */
+	if (!TerminalIOEnabled() || !PositionUnchanged(term))
+		return EK_ELAYOUT;
+	if (!rw && ReadCoECache(term, index, subindex, data, len))
+		return EK_EOK;
+	return CoETransfer(rw, term, index, len, data, subindex, reallen);
+}
+
+int devEK9000::CoETransfer(int rw, uint16_t term, uint16_t index, uint16_t len, uint16_t* data, uint16_t subindex,
+						   uint16_t reallen) {
+	if (len > COE_MAX_REGISTERS)
+		return EK_EBADPARAM;
+	CoERequest_t req;
+	req.rw = rw;
+	req.term = term;
+	req.index = index;
+	req.subindex = subindex;
+	req.len = len;
+	req.reallen = reallen;
+	if (rw)
+		memcpy(req.data, data, len * sizeof(uint16_t));
+	req.done = epicsEventMustCreate(epicsEventEmpty);
+
+	EnqueueCoE(&req);
+	if (LockHeld()) {
+		/* The caller holds the lock to keep its transfers together, and the worker can't step without it. Drive the
+		 * queue from here, finishing whatever is ahead of us */
+		epicsTimeStamp start, now;
+		epicsTimeGetCurrent(&start);
+		for (;;) {
+			ServiceCoE();
+			epicsMutexMustLock(m_coeMutex);
+			bool done = req.state == COE_STATE_DONE;
+			epicsTimeGetCurrent(&now);
+			if (!done && epicsTimeDiffInSeconds(&now, &start) >= COE_WAIT_TIMEOUT && WithdrawCoE(&req)) {
+				LOG_WARNING(this, "%s: CoE transfer of 0x%04X:%02X on terminal %d timed out\n", m_name.c_str(), index,
+							subindex, term);
+				done = true;
+			}
+			epicsMutexUnlock(m_coeMutex);
+			if (done)
+				break;
+			epicsThreadSleep(COE_POLL_INTERVAL);
+		}
+	}
+	else if (epicsEventWaitWithTimeout(req.done, COE_WAIT_TIMEOUT) != epicsEventWaitOK) {
+		epicsMutexMustLock(m_coeMutex);
+		const bool withdrawn = WithdrawCoE(&req);
+		epicsMutexUnlock(m_coeMutex);
+		if (withdrawn)
+			LOG_WARNING(this, "%s: CoE transfer of 0x%04X:%02X on terminal %d timed out\n", m_name.c_str(), index,
+						subindex, term);
+		else {
+			/* Already at the terminal, or just finished. The worker completes it within COE_TIMEOUT either way */
+			epicsEventMustWait(req.done);
+		}
+	}
+	epicsEventDestroy(req.done);
+
+	if (rw && req.status == EK_EADSERR)
+		LastADSErr = req.adsError;
+	if (!rw && req.status == EK_EOK)
+		memcpy(data, req.data, len * sizeof(uint16_t));
+	else if (!rw && req.status == EK_EADSERR)
+		data[0] = req.adsError;
+	return req.status;
+}
+
+int devEK9000::QueueCoE(CoERequest_t* req) {
+	if (!TerminalIOEnabled() || !PositionUnchanged(req->term))
+		return EK_ELAYOUT;
+	if (req->len > COE_MAX_REGISTERS)
+		return EK_EBADPARAM;
+	EnqueueCoE(req);
+	return EK_EOK;
+}
+
+bool devEK9000::WithdrawCoE(CoERequest_t* req) {
+	/* Once the mailbox has been written the terminal is busy with it, and the next request can't go until it's done */
+	if (req->state != COE_STATE_START || req == m_coeActive)
+		return false;
+	std::deque<CoERequest_t*>::iterator it = std::find(m_coeQueue.begin(), m_coeQueue.end(), req);
+	if (it == m_coeQueue.end())
+		return false;
+	m_coeQueue.erase(it);
+	req->status = EK_EERR;
+	req->adsError = 0;
+	req->state = COE_STATE_DONE;
+	return true;
+}
+
+void devEK9000::EnqueueCoE(CoERequest_t* req) {
+	epicsMutexMustLock(m_coeMutex);
+	req->state = COE_STATE_START;
+	m_coeQueue.push_back(req);
+	if (!m_coeThread) {
+		std::string name = "EK9000_CoE_" + m_name;
+		m_coeEvent = epicsEventMustCreate(epicsEventEmpty);
+		m_coeThread = epicsThreadMustCreate(name.c_str(), epicsThreadPriorityMedium,
+											epicsThreadGetStackSize(epicsThreadStackMedium), CoEThreadFunc, this);
+	}
+	epicsEventSignal(m_coeEvent);
+	epicsMutexUnlock(m_coeMutex);
+}
+
+void devEK9000::CoEThreadFunc(void* param) {
+	devEK9000* dev = static_cast<devEK9000*>(param);
+	while (true) {
+		epicsEventMustWait(dev->m_coeEvent);
+		int failures = 0;
+		for (bool busy = true; busy;) {
+			{
+				DeviceLock lock(dev);
+				if (lock.valid()) {
+					failures = 0;
+					busy = dev->ServiceCoE();
+				}
+				else if (++failures * COE_POLL_INTERVAL >= COE_TIMEOUT) {
+					/* Nobody would ever finish them otherwise */
+					LOG_ERROR(dev, "%s: unable to lock the device, failing queued CoE transfers\n", dev->m_name.c_str());
+					dev->FailCoE(EK_EBADMUTEX);
+					busy = false;
+				}
+			}
+			/* Give the poll thread a turn between steps */
+			if (busy)
+				epicsThreadSleep(COE_POLL_INTERVAL);
+		}
+	}
+}
+
+bool devEK9000::ServiceCoE() {
+	/* Claim the head. It can't be withdrawn while it's active, so it's safe to use without m_coeMutex */
+	epicsMutexMustLock(m_coeMutex);
+	CoERequest_t* req = m_coeQueue.empty() ? NULL : m_coeQueue.front();
+	m_coeActive = req;
+	int state = req ? req->state : COE_STATE_DONE;
+	epicsMutexUnlock(m_coeMutex);
+	if (!req)
+		return false;
+
+	epicsTimeStamp now;
+	epicsTimeGetCurrent(&now);
+	int status = EK_EOK;
+	uint16_t adsError = 0;
+
+	switch (state) {
+		case COE_STATE_START:
+			{
+				uint16_t mailbox[COE_MAX_REGISTERS + 7] = {
+					1,																/* 0x1400 = exec */
+					(uint16_t)(req->rw ? req->term | 0x8000 : req->term),			/* Bit 15 set for a write */
+					req->index,														/* 0x1402 = obj */
+					req->subindex,													/* 0x1403 = subindex */
+					(uint16_t)(req->rw ? (req->reallen ? req->reallen : req->len * 2) : 0), /* 0x1404 = len */
+					0,																/* 0x1405 = error code */
+				};
+				if (req->rw)
+					memcpy(mailbox + 6, req->data, req->len * sizeof(uint16_t));
+				if (this->doModbusIO(0, MODBUS_WRITE_MULTIPLE_REGISTERS, 0x1400, mailbox, req->rw ? req->len + 7 : 9)) {
+					status = EK_EERR;
+					state = COE_STATE_DONE;
+					break;
+				}
+				req->started = now;
+				state = COE_STATE_POLL;
+				break;
+			}
+		case COE_STATE_POLL:
+			{
+				/* Exec word and the error code in one go */
+				uint16_t regs[6] = {0};
+				const bool ok = this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x1400, regs, 6) == asynSuccess;
+				if (!ok || (regs[0] | 0x200) == 0x200) {
+					if (epicsTimeDiffInSeconds(&now, &req->started) >= COE_TIMEOUT) {
+						status = ok && regs[5] ? EK_EADSERR : EK_EERR;
+						adsError = regs[5];
+						state = COE_STATE_DONE;
+					}
+				}
+				else if ((regs[0] & 0x400) != 0x400) {
+					status = EK_EADSERR;
+					adsError = regs[5];
+					state = COE_STATE_DONE;
+				}
+				else
+					state = req->rw ? COE_STATE_DONE : COE_STATE_FETCH;
+				break;
+			}
+		case COE_STATE_FETCH:
+			status = this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x1406, req->data, req->len) ? EK_EERR : EK_EOK;
+			state = COE_STATE_DONE;
+			break;
+		default:
+			break;
+	}
+
+	/* Only the thread servicing the queue pops its head, so req is still there */
+	epicsMutexMustLock(m_coeMutex);
+	m_coeActive = NULL;
+	const bool finished = state == COE_STATE_DONE;
+	if (finished)
+		m_coeQueue.pop_front();
+	req->state = state;
+	const bool busy = !m_coeQueue.empty();
+	epicsMutexUnlock(m_coeMutex);
+
+	if (finished)
+		CompleteCoE(req, status, adsError);
+	return busy;
+}
+
+void devEK9000::CompleteCoE(CoERequest_t* req, int status, uint16_t adsError) {
+	req->status = status;
+	req->adsError = adsError;
+	RefreshCoEValue(req);
+	/* Neither may touch req after this, the owner is free to reuse or free it */
+	if (req->callback)
+		req->callback(req);
+	else if (req->done)
+		epicsEventSignal(req->done);
+}
+
+void devEK9000::FailCoE(int status) {
+	std::deque<CoERequest_t*> failed;
+	epicsMutexMustLock(m_coeMutex);
+	for (std::deque<CoERequest_t*>::iterator it = m_coeQueue.begin(); it != m_coeQueue.end();) {
+		if (*it == m_coeActive) {
+			++it;
+			continue;
+		}
+		(*it)->state = COE_STATE_DONE;
+		failed.push_back(*it);
+		it = m_coeQueue.erase(it);
+	}
+	epicsMutexUnlock(m_coeMutex);
+
+	/* The cache needs the device lock, so it's left alone. Only the head can have reached the terminal */
+	for (size_t i = 0; i < failed.size(); ++i) {
+		CoERequest_t* req = failed[i];
+		req->status = status;
+		req->adsError = 0;
+		if (req->callback)
+			req->callback(req);
+		else if (req->done)
+			epicsEventSignal(req->done);
+	}
+}
+
+void devEK9000::RefreshCoEValue(const CoERequest_t* req) {
+	if (req->status != EK_EOK) {
+		/* Can't tell how much of a failed write made it */
+		if (req->rw && req->term >= 1 && req->term <= m_terms.size()) {
+			std::map<uint32_t, CoEValue_t>& values = m_terms[req->term - 1]->m_coeValues;
+			std::map<uint32_t, CoEValue_t>::iterator it = values.find(CoEKey(req->index, req->subindex));
+			if (it != values.end())
+				it->second.valid = false;
+		}
+		return;
+	}
+
+	CoEValue_t* value = req->len <= 4 ? CoECacheEntry(req->term, req->index, req->subindex) : NULL;
+	if (!value)
+		return;
+	value->valid = true;
+	value->len = req->len;
+	memcpy(value->data, req->data, req->len * sizeof(uint16_t));
+	epicsTimeGetCurrent(&value->stamp);
+	if (value->scan)
+		scanIoRequest(value->scan);
+}
+
+CoEValue_t* devEK9000::CoECacheEntry(uint16_t pos, uint16_t index, uint16_t subindex) {
+	if (pos < 1 || pos > m_terms.size())
+		return NULL;
+	std::map<uint32_t, CoEValue_t>& values = m_terms[pos - 1]->m_coeValues;
+	const uint32_t key = CoEKey(index, subindex);
+	std::map<uint32_t, CoEValue_t>::iterator it = values.find(key);
+	if (it == values.end()) {
+		CoEValue_t value;
+		memset(&value, 0, sizeof(value));
+		/* Nothing is static unless a link says so: even identity objects and settings change behind our back */
+		value.ttl = m_coeCacheTTL;
+		it = values.insert(std::make_pair(key, value)).first;
+	}
+	return &it->second;
+}
+
+IOSCANPVT devEK9000::WatchCoE(uint16_t pos, uint16_t index, uint16_t subindex) {
+	DeviceLock lock(this);
+	if (!lock.valid())
+		return NULL;
+	CoEValue_t* value = CoECacheEntry(pos, index, subindex);
+	if (!value)
+		return NULL;
+	if (!value->scan)
+		scanIoInit(&value->scan);
+	return value->scan;
+}
+
+bool devEK9000::GetCoEValue(uint16_t pos, uint16_t index, uint16_t subindex, uint16_t* data, uint16_t len) {
+	if (pos < 1 || pos > m_terms.size())
+		return false;
+	DeviceLock lock(this);
+	if (!lock.valid())
+		return false;
+	const std::map<uint32_t, CoEValue_t>& values = m_terms[pos - 1]->m_coeValues;
+	std::map<uint32_t, CoEValue_t>::const_iterator it = values.find(CoEKey(index, subindex));
+	if (it == values.end() || !it->second.valid || it->second.len < len)
+		return false;
+	memcpy(data, it->second.data, len * sizeof(uint16_t));
+	return true;
+}
+
+bool devEK9000::ReadCoECache(uint16_t pos, uint16_t index, uint16_t subindex, uint16_t* data, uint16_t len) {
+	/* Whatever was cached for a position that has since changed belongs to some other terminal */
+	if (!TerminalIOEnabled() || !PositionUnchanged(pos))
+		return false;
+	if (pos < 1 || pos > m_terms.size())
+		return false;
+	DeviceLock lock(this);
+	if (!lock.valid())
+		return false;
+	const std::map<uint32_t, CoEValue_t>& values = m_terms[pos - 1]->m_coeValues;
+	std::map<uint32_t, CoEValue_t>::const_iterator it = values.find(CoEKey(index, subindex));
+	if (it == values.end() || !it->second.valid || it->second.len < len || it->second.ttl == 0)
+		return false;
+	if (it->second.ttl > 0) {
+		epicsTimeStamp now;
+		epicsTimeGetCurrent(&now);
+		if (epicsTimeDiffInSeconds(&now, &it->second.stamp) >= it->second.ttl)
+			return false;
 	}
-	return 1;
+	memcpy(data, it->second.data, len * sizeof(uint16_t));
+	return true;
 }
 
-/* 1 for write and 0 for read */
-/* LENGTH IS IN REGISTERS */
-int devEK9000::doCoEIO(int rw, uint16_t term, uint16_t index, uint16_t len, uint16_t* data, uint16_t subindex,
-					   uint16_t reallen) {
-	/* write */
-	if (rw) {
-		uint16_t tmp_data[512] = {
-			1,
-			(uint16_t)(term | 0x8000), /* Bit 15 needs to be 1 to indicate a write */
-			index,
-			subindex,
-			reallen ? reallen : (uint16_t)(len * 2),
-			0, /* Error code */
-		};
-
-		memcpy(tmp_data + 6, data, len * sizeof(uint16_t));
-		this->doModbusIO(0, MODBUS_WRITE_MULTIPLE_REGISTERS, 0x1400, tmp_data, len + 7);
-		if (!this->Poll(0.005, TIMEOUT_COUNT)) {
-			this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x1400, tmp_data, 6);
-			/* Write tmp data */
-			if ((tmp_data[0] & 0x400) != 0x400) {
-				LastADSErr = tmp_data[5];
-				return EK_EADSERR;
-			}
-		}
-		else
-			return EK_EERR;
-		return EK_EOK;
+void devEK9000::SetCoETTL(uint16_t pos, uint16_t index, uint16_t subindex, double ttl) {
+	DeviceLock lock(this);
+	if (!lock.valid())
+		return;
+	CoEValue_t* value = CoECacheEntry(pos, index, subindex);
+	if (value)
+		value->ttl = ttl;
+}
+
+void devEK9000::InvalidateCoECache(int pos) {
+	DeviceLock lock(this);
+	if (!lock.valid())
+		return;
+	/* Entries stay, they carry the TTL overrides and scan lists */
+	for (size_t i = 0; i < m_terms.size(); ++i) {
+		if (pos && (int)i != pos - 1)
+			continue;
+		std::map<uint32_t, CoEValue_t>& values = m_terms[i]->m_coeValues;
+		for (std::map<uint32_t, CoEValue_t>::iterator it = values.begin(); it != values.end(); ++it)
+			it->second.valid = false;
 	}
-	/* read */
-	else {
-		uint16_t tmp_data[512] = {
-			1,		  /* 0x1400 = exec */
-			term,	  /* 0x1401 = term id */
-			index,	  /* 0x1402 = obj */
-			subindex, /* 0x1403 = subindex */
-			0,		  /* 0x1404 = len = 0 */
-			0,		  0, 0, 0,
-		};
-
-		/* tell it what to do */
-		this->doModbusIO(0, MODBUS_WRITE_MULTIPLE_REGISTERS, 0x1400, tmp_data, 9);
-
-		/* poll */
-		if (this->Poll(0.005, TIMEOUT_COUNT)) {
-			uint16_t dat = 0;
-			this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x1405, &dat, 1);
-			if (dat != 0) {
-				data[0] = dat;
-				return EK_EADSERR;
+}
+
+void devEK9000::ReportCoECache(int pos) {
+	DeviceLock lock(this);
+	if (!lock.valid())
+		return;
+	epicsTimeStamp now;
+	epicsTimeGetCurrent(&now);
+	epicsPrintf("Device: %s\n", m_name.c_str());
+	for (size_t i = 0; i < m_terms.size(); ++i) {
+		const std::map<uint32_t, CoEValue_t>& values = m_terms[i]->m_coeValues;
+		if ((pos && (int)i != pos - 1) || values.empty())
+			continue;
+		epicsPrintf("\tTerminal %d (EL%d):\n", (int)i + 1, m_terms[i]->m_terminalId);
+		for (std::map<uint32_t, CoEValue_t>::const_iterator it = values.begin(); it != values.end(); ++it) {
+			const CoEValue_t& value = it->second;
+			char ttl[32];
+			if (value.ttl < 0)
+				epicsSnprintf(ttl, sizeof(ttl), "static");
+			else
+				epicsSnprintf(ttl, sizeof(ttl), "%gs", value.ttl);
+			epicsPrintf("\t\t0x%04X:%02X ttl=%s%s", it->first >> 16, it->first & 0xFFFF, ttl, value.scan ? " intr" : "");
+			if (!value.valid) {
+				epicsPrintf(" invalid\n");
+				continue;
 			}
-			return EK_EERR;
+			epicsPrintf(" age=%.1fs data=", epicsTimeDiffInSeconds(&now, &value.stamp));
+			for (uint16_t r = 0; r < value.len; ++r)
+				epicsPrintf("%04X", value.data[value.len - r - 1]);
+			epicsPrintf("\n");
 		}
-		epicsThreadSleep(0.05);
-		/* read result */
-		int res = this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x1406, data, len);
-		if (res)
-			return EK_EERR;
-		return EK_EOK;
 	}
 }
 
+asynStatus devEK9000::lock() {
+	asynStatus status = drvModbusAsyn::lock();
+	if (status == asynSuccess && m_lockDepth++ == 0)
+		epicsAtomicSetPtrT(&m_lockOwner, (void*)epicsThreadGetIdSelf());
+	return status;
+}
+
+asynStatus devEK9000::unlock() {
+	if (--m_lockDepth == 0)
+		epicsAtomicSetPtrT(&m_lockOwner, NULL);
+	return drvModbusAsyn::unlock();
+}
+
 int devEK9000::doEK9000IO(int rw, uint16_t addr, uint16_t len, uint16_t* data) {
 	int status = 0;
 	/* write */
@@ -608,6 +2334,7 @@ int devEK9000::doEK9000IO(int rw, uint16_t addr, uint16_t len, uint16_t* data) {
 		if (status) {
 			return status + 0x100;
 		}
+		UpdateOutputImage(MODBUS_WRITE_MULTIPLE_REGISTERS, addr, data, len);
 		return EK_EOK;
 	}
 	/* read */
@@ -782,42 +2509,37 @@ int devEK9000::WriteWritelockMode(uint16_t mode) {
 	return this->doEK9000IO(1, 0x1124, 1, &mode);
 }
 
-/* Read terminal ID */
-uint16_t devEK9000::ReadTerminalID(uint16_t index) {
-	assert(index < 0xFF);
-	if (m_readTerminals)
-		return m_terminals[index];
+/* Read the rail layout */
+int devEK9000::ReadRailLayout() {
+	m_readTerminals = false;
+	int status = FetchRailLayout(m_terminals, m_railCount);
+	m_readTerminals = status == EK_EOK;
+	return status;
+}
 
-	memset(m_terminals, 0, sizeof(m_terminals));
+int devEK9000::FetchRailLayout(uint16_t* ids, int& count) {
+	memset(ids, 0, TERMINAL_REGISTER_COUNT * sizeof(uint16_t));
+	count = 0;
 	// Read the terminal register space. 0x6000 will contain 9000, corresponding to the bus coupler.
 	// registers thereafter will contain a numeric ID corresponding to the terminal type. i.e. 0x6001 will contain 3064
-	// if the second terminal is an EL3064 read 125 registers in a loop, as that's the max number that can be read in a
-	// single modbus transaction
-	for (int off = 0; off < TERMINAL_REGISTER_COUNT; off += 125) {
-		// Check if there are no further terminals on the rail, otherwise continue reading
-		if (off > 0 && m_terminals[off] == 0)
+	// if the first terminal is an EL3064, and the list ends with a 0. Read 125 registers at a time, as that's the max
+	// number that can be read in a single modbus transaction, and stop once we're past the end of the rail
+	for (int off = 0; off < TERMINAL_REGISTER_COUNT; off += EK9000_MAX_READ_REGISTERS) {
+		const int len = std::min(TERMINAL_REGISTER_COUNT - off, EK9000_MAX_READ_REGISTERS);
+		if (this->doModbusIO(0, MODBUS_READ_HOLDING_REGISTERS, 0x6000 + off, ids + off, len) != asynSuccess)
+			return EK_EMODBUSERR;
+		if (std::find(ids + off, ids + off + len, 0) != ids + off + len)
 			break;
-		const size_t toRead = util::clamp(ArraySize(m_terminals) - off, 0UL, 125UL);
-		if (this->doModbusIO(0, MODBUS_READ_INPUT_REGISTERS, 0x6000, m_terminals + off, toRead) != asynSuccess) {
-			LOG_WARNING(this, "%s: Failed to read terminal layout\n", m_name.data());
-			break;
-		}
 	}
 
-	m_readTerminals = true;
-	return m_terminals[index];
+	count = std::find(ids + 1, ids + TERMINAL_REGISTER_COUNT, 0) - (ids + 1);
+	return EK_EOK;
 }
 
-int devEK9000::Poll(float duration, int timeout) {
-	uint16_t dat = 0;
-	this->doModbusIO(EK9000_SLAVE_ID, MODBUS_READ_HOLDING_REGISTERS, 0x1400, &dat, 1);
-	while ((dat | 0x200) == 0x200 && timeout > 0) {
-		epicsThreadSleep(duration);
-		timeout--;
-		this->doModbusIO(EK9000_SLAVE_ID, MODBUS_READ_HOLDING_REGISTERS, 0x1400, &dat, 1);
-	}
-
-	return timeout <= 0 ? 1 : 0;
+uint16_t devEK9000::LayoutTerminalID(int pos) const {
+	if (!m_readTerminals || pos < 1 || pos > m_railCount)
+		return 0;
+	return m_terminals[pos];
 }
 
 int devEK9000::LastError() {
@@ -868,6 +2590,8 @@ const char* devEK9000::ErrorToString(int i) {
 			return "Invalid terminal ID";
 		case EK_EMODBUSERR:
 			return "Modbus driver error";
+		case EK_ELAYOUT:
+			return "Rail layout not confirmed";
 		default:
 			assert(!"Invalid parameter passed to ErrorToString");
 			return "Unknown";
@@ -909,7 +2633,8 @@ void ek9000Configure(const iocshArgBuf* args) {
 	char ipbuf[64];
 	(void)snprintf(ipbuf, sizeof(ipbuf), "%s:%i", ip, port);
 
-	dev = devEK9000::Create(name, ipbuf, num);
+	/* With parallel init the coupler is only registered here, ek9000_init brings it up */
+	dev = devEK9000::parallelInit ? devEK9000::Register(name, ipbuf, num) : devEK9000::Create(name, ipbuf, num);
 
 	if (!dev) {
 		epicsPrintf("Unable to create device: Unspecified error.\n");
@@ -936,13 +2661,8 @@ void ek9000ConfigureTerminal(const iocshArgBuf* args) {
 		return;
 	}
 
-	uint32_t tid = 0;
-	for (size_t i = 0; i < ArraySize(s_terminalInfos); i++) {
-		if (strcmp(s_terminalInfos[i].str, type) == 0) {
-			tid = s_terminalInfos[i].id;
-			break;
-		}
-	}
+	const terminal_t* info = util::FindTerminalByName(type);
+	uint32_t tid = info ? info->id : 0;
 	if (tid == 0) {
 		epicsPrintf("Unable to create terminal %s: No terminal with the ID %s found.\n", name, type);
 		return;
@@ -1013,6 +2733,12 @@ void ek9000Stat(const iocshArgBuf* args) {
 	epicsPrintf("\tSoftware Version: %u.%u.%u\n", svermaj, svermin, sverpat);
 	epicsPrintf("\tFallbacks triggered: %u\n", wtd);
 	epicsPrintf("\tMfg date: %u/%u/%u\n", month, day, year);
+	const RailSnapshot_t* rail = dev->Rail();
+	if (rail && rail->unusable)
+		epicsPrintf("\tRail: %d terminals, %d configured positions INVALID (first change at %d)%s\n", rail->count,
+					rail->unusable, rail->firstMoved, rail->remapped ? ", others remapped" : "");
+	else if (rail)
+		epicsPrintf("\tRail: %d terminals, as mapped\n", rail->count);
 
 	for (int i = 0; i < dev->m_numTerms; i++) {
 		if (dev->m_terms[i]->m_recordName.empty())
@@ -1024,6 +2750,8 @@ void ek9000Stat(const iocshArgBuf* args) {
 		epicsPrintf("\t\tOutput Start: %u\n", dev->m_terms[i]->m_outputStart);
 		epicsPrintf("\t\tInput Size: %u\n", dev->m_terms[i]->m_inputSize);
 		epicsPrintf("\t\tInput Start: %u\n", dev->m_terms[i]->m_inputStart);
+		if (rail && !rail->usable[i + 1])
+			epicsPrintf("\t\tINVALID: not found on the rail as mapped\n");
 	}
 }
 
@@ -1038,13 +2766,17 @@ void ek9000DisableDebug(const iocshArgBuf*) {
 }
 
 void ek9000List(const iocshArgBuf*) {
+	epicsMutexMustLock(RegistryLock());
 	// for (auto dev : GlobalDeviceList()) {
 	for (std::list<devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
 		devEK9000* dev = *it;
 		epicsPrintf("Device: %s\n\tSlave Count: %i\n", dev->m_name.data(), dev->m_numTerms);
 		epicsPrintf("\tIP: %s\n", dev->m_ip.data());
 		epicsPrintf("\tConnected: %s\n", dev->VerifyConnection() ? "TRUE" : "FALSE");
+		if (dev->m_detached)
+			epicsPrintf("\tDetached\n");
 	}
+	epicsMutexUnlock(RegistryLock());
 }
 
 void ek9000SetWatchdogTime(const iocshArgBuf* args) {
@@ -1090,6 +2822,244 @@ void ek9000SetPollTime(const iocshArgBuf* args) {
 	devEK9000::pollDelay = time;
 }
 
+void ek9000ListGroups(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	int level = args[1].ival;
+	epicsMutexMustLock(RegistryLock());
+	for (std::list<devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
+		devEK9000* dev = *it;
+		if (ek9k && *ek9k && strcmp(ek9k, dev->m_name.data()) != 0)
+			continue;
+		epicsPrintf("Device: %s\n", dev->m_name.data());
+		for (std::map<std::string, devEK9000OutputGroup*>::iterator g = dev->m_groups.begin();
+			 g != dev->m_groups.end(); ++g)
+			g->second->Report(level);
+	}
+	epicsMutexUnlock(RegistryLock());
+}
+
+void ek9000SetOutputVerify(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	double period = args[1].dval;
+	if (!ek9k)
+		return;
+	devEK9000* dev = devEK9000::FindDevice(ek9k);
+	if (!dev) {
+		epicsPrintf("Invalid device: %s\n", ek9k);
+		return;
+	}
+	dev->m_outputVerifyPeriod = period > 0 ? period : 0;
+}
+
+void ek9000SetRailCheck(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	double period = args[1].dval;
+	if (!ek9k)
+		return;
+	devEK9000* dev = devEK9000::FindDevice(ek9k);
+	if (!dev) {
+		epicsPrintf("Invalid device: %s\n", ek9k);
+		return;
+	}
+	dev->m_railCheckPeriod = period > 0 ? period : 0;
+}
+
+void ek9000Attach(const iocshArgBuf* args) {
+	const char* name = args[0].sval;
+	const char* ip = args[1].sval;
+	int count = args[2].ival;
+	if (!name) {
+		epicsPrintf("Usage: ek9000Attach name [ip num_terminals]\n");
+		return;
+	}
+	devEK9000::Attach(name, ip, count);
+}
+
+void ek9000Detach(const iocshArgBuf* args) {
+	const char* name = args[0].sval;
+	if (!name) {
+		epicsPrintf("Usage: ek9000Detach name\n");
+		return;
+	}
+	devEK9000::Detach(name);
+}
+
+void ek9000SetParallelInit(const iocshArgBuf* args) {
+	int enable = args[0].ival;
+	double timeout = args[1].dval;
+	if (!GlobalDeviceList().empty())
+		epicsPrintf("ek9000SetParallelInit: only affects couplers configured after this call\n");
+	devEK9000::parallelInit = enable != 0;
+	if (timeout > 0)
+		devEK9000::parallelInitTimeout = timeout;
+}
+
+void ek9000SetLayoutCache(const iocshArgBuf* args) {
+	const char* dir = args[0].sval;
+	devEK9000::layoutCacheDir = dir ? dir : "";
+}
+
+/* Parse a list of terminal names (EL3064) or bare IDs (3064) separated by commas or whitespace, '#' comments */
+static bool ParseLayout(const char* text, std::vector<uint16_t>& ids, const char* func) {
+	ids.clear();
+	for (const char* p = text; *p;) {
+		if (*p == '#') {
+			while (*p && *p != '\n')
+				++p;
+			continue;
+		}
+		if (*p == ',' || isspace((unsigned char)*p)) {
+			++p;
+			continue;
+		}
+		const char* tok = p;
+		while (*p && *p != ',' && *p != '#' && !isspace((unsigned char)*p))
+			++p;
+		util::StrView_t name = {tok, size_t(p - tok)};
+
+		char buf[32];
+		const terminal_t* info = name.CopyTo(buf) ? util::FindTerminalByName(buf) : NULL;
+		epicsUInt16 id = info ? info->id : 0;
+		if (!info) {
+			/* Not in the registry, still fine to declare as long as it's a number */
+			if (name.len >= 2 && !strncmp(name.str, "EL", 2)) {
+				name.str += 2;
+				name.len -= 2;
+			}
+			if (!util::parseNumber(name, id, 10) || !id) {
+				epicsPrintf("%s: invalid terminal '%.*s'\n", func, (int)(p - tok), tok);
+				return false;
+			}
+		}
+		if (ids.size() >= TERMINAL_REGISTER_COUNT - 1) {
+			epicsPrintf("%s: too many terminals\n", func);
+			return false;
+		}
+		ids.push_back(id);
+	}
+	if (ids.empty()) {
+		epicsPrintf("%s: layout is empty\n", func);
+		return false;
+	}
+	return true;
+}
+
+void ek9000AutoConfigure(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	const char* dbDir = args[1].sval;
+	const char* base = args[2].sval;
+	const char* macros = args[3].sval;
+	if (!ek9k) {
+		epicsPrintf("Usage: ek9000AutoConfigure ek9k [db_dir record_base macros]\n");
+		return;
+	}
+	devEK9000* dev = devEK9000::FindDevice(ek9k);
+	if (!dev) {
+		epicsPrintf("ek9000AutoConfigure: invalid device: %s\n", ek9k);
+		return;
+	}
+	if (interruptAccept) {
+		epicsPrintf("ek9000AutoConfigure: records can only be loaded before iocInit\n");
+		return;
+	}
+
+	/* Default to the module's installed templates, and to records named after the coupler */
+	std::string dir = dbDir && *dbDir ? dbDir : "";
+	if (dir.empty()) {
+		const char* top = getenv("TOP");
+		dir = std::string(top ? top : ".") + "/db";
+	}
+	std::string prefix = base && *base ? base : std::string(ek9k) + ":";
+
+	const int loaded = dev->AutoConfigure(dir.c_str(), prefix.c_str(), macros);
+	if (loaded >= 0)
+		epicsPrintf("ek9000AutoConfigure: loaded %d terminals for %s\n", loaded, ek9k);
+}
+
+void ek9000DeclareLayout(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	const char* layout = args[1].sval;
+	if (!ek9k || !layout) {
+		epicsPrintf("Usage: ek9000DeclareLayout ek9k \"EL1004,EL3064,...\"\n");
+		return;
+	}
+	std::vector<uint16_t> ids;
+	if (ParseLayout(layout, ids, "ek9000DeclareLayout"))
+		devEK9000::DeclareLayout(ek9k, ids);
+}
+
+void ek9000LoadLayout(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	const char* path = args[1].sval;
+	if (!ek9k || !path) {
+		epicsPrintf("Usage: ek9000LoadLayout ek9k file\n");
+		return;
+	}
+	FILE* fp = fopen(path, "r");
+	if (!fp) {
+		epicsPrintf("ek9000LoadLayout: unable to open %s: %s\n", path, strerror(errno));
+		return;
+	}
+	std::string text;
+	char buf[512];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+		text.append(buf, n);
+	fclose(fp);
+
+	std::vector<uint16_t> ids;
+	if (ParseLayout(text.c_str(), ids, "ek9000LoadLayout"))
+		devEK9000::DeclareLayout(ek9k, ids);
+}
+
+void ek9000SetPdoIntrospection(const iocshArgBuf* args) {
+	if (!GlobalDeviceList().empty())
+		epicsPrintf("ek9000SetPdoIntrospection: only affects couplers configured after this call\n");
+	devEK9000::pdoIntrospection = args[0].ival != 0;
+}
+
+void ek9000LoadConfig(const iocshArgBuf* args) {
+	const char* path = args[0].sval;
+	if (!path) {
+		epicsPrintf("Usage: ek9000LoadConfig file\n");
+		return;
+	}
+	LoadRailConfig(path);
+}
+
+void ek9000CoECache(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	const char* action = args[1].sval;
+	int pos = args[2].ival;
+	if (!ek9k || (action && *action && strcmp(action, "dump") && strcmp(action, "invalidate"))) {
+		epicsPrintf("Usage: ek9000CoECache ek9k [dump|invalidate] [terminal]\n");
+		return;
+	}
+	devEK9000* dev = devEK9000::FindDevice(ek9k);
+	if (!dev) {
+		epicsPrintf("Invalid device: %s\n", ek9k);
+		return;
+	}
+	if (action && !strcmp(action, "invalidate"))
+		dev->InvalidateCoECache(pos);
+	else
+		dev->ReportCoECache(pos);
+}
+
+void ek9000SetCoECacheTTL(const iocshArgBuf* args) {
+	const char* ek9k = args[0].sval;
+	double ttl = args[1].dval;
+	if (!ek9k)
+		return;
+	devEK9000* dev = devEK9000::FindDevice(ek9k);
+	if (!dev) {
+		epicsPrintf("Invalid device: %s\n", ek9k);
+		return;
+	}
+	/* Only for objects cached from now on, link TTLs and the static ones keep theirs */
+	dev->m_coeCacheTTL = ttl;
+}
+
 int ek9000RegisterFunctions() {
 
 	/* ek9000SetWatchdogTime(ek9k, time[int]) */
@@ -1151,42 +3121,196 @@ int ek9000RegisterFunctions() {
 		iocshRegister(&func2, ek9000ConfigureTerminal);
 	}
 
-	/* ek9000Stat */
+	/* ek9000Stat */
+	{
+		static const iocshArg arg1 = {"EK9000 Name", iocshArgString};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9000Stat", 1, args};
+		static const iocshFuncDef func2 = {"ek9kStat", 1, args};
+		iocshRegister(&func, ek9000Stat);
+		iocshRegister(&func2, ek9000Stat);
+	}
+
+	/* ek9000EnableDebug */
+	{
+		static const iocshArg arg1 = {"EK9k", iocshArgString};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9000EnableDebug", 1, args};
+		static const iocshFuncDef func2 = {"ek9kEnableDbg", 1, args};
+		iocshRegister(&func, ek9000EnableDebug);
+		iocshRegister(&func2, ek9000EnableDebug);
+	}
+
+	/* ek9000DisableDebug */
+	{
+		static const iocshArg arg1 = {"EK9K", iocshArgString};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9kDisableDebug", 1, args};
+		static const iocshFuncDef func2 = {"ek9kDisableDbg", 1, args};
+		iocshRegister(&func, ek9000DisableDebug);
+		iocshRegister(&func2, ek9000DisableDebug);
+	}
+
+	/* ek9000List */
+	{
+		static iocshFuncDef func = {"ek9000List", 0, NULL};
+		static iocshFuncDef func2 = {"ek9kList", 0, NULL};
+		iocshRegister(&func, ek9000List);
+		iocshRegister(&func2, ek9000List);
+	}
+
+	/* ek9000ListGroups(ek9k, level) */
+	{
+		static const iocshArg arg1 = {"EK9000 Name", iocshArgString};
+		static const iocshArg arg2 = {"Level", iocshArgInt};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000ListGroups", 2, args};
+		static const iocshFuncDef func2 = {"ek9kListGroups", 2, args};
+		iocshRegister(&func, ek9000ListGroups);
+		iocshRegister(&func2, ek9000ListGroups);
+	}
+
+	/* ek9000SetOutputVerify(ek9k, period[double]) */
+	{
+		static const iocshArg arg1 = {"EK9000 Name", iocshArgString};
+		static const iocshArg arg2 = {"Period (s)", iocshArgDouble};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000SetOutputVerify", 2, args};
+		static const iocshFuncDef func2 = {"ek9kSetOutputVerify", 2, args};
+		iocshRegister(&func, ek9000SetOutputVerify);
+		iocshRegister(&func2, ek9000SetOutputVerify);
+	}
+
+	/* ek9000SetParallelInit(enable, timeout[double]) */
+	{
+		static const iocshArg arg1 = {"Enable", iocshArgInt};
+		static const iocshArg arg2 = {"Timeout (s)", iocshArgDouble};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000SetParallelInit", 2, args};
+		static const iocshFuncDef func2 = {"ek9kSetParallelInit", 2, args};
+		iocshRegister(&func, ek9000SetParallelInit);
+		iocshRegister(&func2, ek9000SetParallelInit);
+	}
+
+	/* ek9000Attach(name, ip, num_terminals) */
+	{
+		static const iocshArg arg1 = {"Name", iocshArgString};
+		static const iocshArg arg2 = {"IP", iocshArgString};
+		static const iocshArg arg3 = {"Num Terminals", iocshArgInt};
+		static const iocshArg* const args[] = {&arg1, &arg2, &arg3};
+		static const iocshFuncDef func = {"ek9000Attach", 3, args};
+		static const iocshFuncDef func2 = {"ek9kAttach", 3, args};
+		iocshRegister(&func, ek9000Attach);
+		iocshRegister(&func2, ek9000Attach);
+	}
+
+	/* ek9000Detach(name) */
+	{
+		static const iocshArg arg1 = {"Name", iocshArgString};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9000Detach", 1, args};
+		static const iocshFuncDef func2 = {"ek9kDetach", 1, args};
+		iocshRegister(&func, ek9000Detach);
+		iocshRegister(&func2, ek9000Detach);
+	}
+
+	/* ek9000SetRailCheck(ek9k, period[double]) */
+	{
+		static const iocshArg arg1 = {"Name", iocshArgString};
+		static const iocshArg arg2 = {"Period", iocshArgDouble};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000SetRailCheck", 2, args};
+		static const iocshFuncDef func2 = {"ek9kSetRailCheck", 2, args};
+		iocshRegister(&func, ek9000SetRailCheck);
+		iocshRegister(&func2, ek9000SetRailCheck);
+	}
+
+	/* ek9000SetLayoutCache(dir[string]) */
+	{
+		static const iocshArg arg1 = {"Directory", iocshArgString};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9000SetLayoutCache", 1, args};
+		static const iocshFuncDef func2 = {"ek9kSetLayoutCache", 1, args};
+		iocshRegister(&func, ek9000SetLayoutCache);
+		iocshRegister(&func2, ek9000SetLayoutCache);
+	}
+
+	/* ek9000SetPdoIntrospection(enable) */
+	{
+		static const iocshArg arg1 = {"Enable", iocshArgInt};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9000SetPdoIntrospection", 1, args};
+		static const iocshFuncDef func2 = {"ek9kSetPdoIntrospection", 1, args};
+		iocshRegister(&func, ek9000SetPdoIntrospection);
+		iocshRegister(&func2, ek9000SetPdoIntrospection);
+	}
+
+	/* ek9000LoadConfig(file) */
+	{
+		static const iocshArg arg1 = {"File", iocshArgString};
+		static const iocshArg* const args[] = {&arg1};
+		static const iocshFuncDef func = {"ek9000LoadConfig", 1, args};
+		static const iocshFuncDef func2 = {"ek9kLoadConfig", 1, args};
+		iocshRegister(&func, ek9000LoadConfig);
+		iocshRegister(&func2, ek9000LoadConfig);
+	}
+
+	/* ek9000AutoConfigure(ek9k, db_dir, record_base, macros) */
+	{
+		static const iocshArg arg1 = {"Name", iocshArgString};
+		static const iocshArg arg2 = {"DB Dir", iocshArgString};
+		static const iocshArg arg3 = {"Record Base", iocshArgString};
+		static const iocshArg arg4 = {"Macros", iocshArgString};
+		static const iocshArg* const args[] = {&arg1, &arg2, &arg3, &arg4};
+		static const iocshFuncDef func = {"ek9000AutoConfigure", 4, args};
+		static const iocshFuncDef func2 = {"ek9kAutoConfigure", 4, args};
+		iocshRegister(&func, ek9000AutoConfigure);
+		iocshRegister(&func2, ek9000AutoConfigure);
+	}
+
+	/* ek9000DeclareLayout(ek9k, layout[string]) */
 	{
-		static const iocshArg arg1 = {"EK9000 Name", iocshArgString};
-		static const iocshArg* const args[] = {&arg1};
-		static const iocshFuncDef func = {"ek9000Stat", 1, args};
-		static const iocshFuncDef func2 = {"ek9kStat", 1, args};
-		iocshRegister(&func, ek9000Stat);
-		iocshRegister(&func2, ek9000Stat);
+		static const iocshArg arg1 = {"Name", iocshArgString};
+		static const iocshArg arg2 = {"Layout", iocshArgString};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000DeclareLayout", 2, args};
+		static const iocshFuncDef func2 = {"ek9kDeclareLayout", 2, args};
+		iocshRegister(&func, ek9000DeclareLayout);
+		iocshRegister(&func2, ek9000DeclareLayout);
 	}
 
-	/* ek9000EnableDebug */
+	/* ek9000LoadLayout(ek9k, file[string]) */
 	{
-		static const iocshArg arg1 = {"EK9k", iocshArgString};
-		static const iocshArg* const args[] = {&arg1};
-		static const iocshFuncDef func = {"ek9000EnableDebug", 1, args};
-		static const iocshFuncDef func2 = {"ek9kEnableDbg", 1, args};
-		iocshRegister(&func, ek9000EnableDebug);
-		iocshRegister(&func2, ek9000EnableDebug);
+		static const iocshArg arg1 = {"Name", iocshArgString};
+		static const iocshArg arg2 = {"File", iocshArgString};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000LoadLayout", 2, args};
+		static const iocshFuncDef func2 = {"ek9kLoadLayout", 2, args};
+		iocshRegister(&func, ek9000LoadLayout);
+		iocshRegister(&func2, ek9000LoadLayout);
 	}
 
-	/* ek9000DisableDebug */
+	/* ek9000CoECache(ek9k, action, terminal) */
 	{
-		static const iocshArg arg1 = {"EK9K", iocshArgString};
-		static const iocshArg* const args[] = {&arg1};
-		static const iocshFuncDef func = {"ek9kDisableDebug", 1, args};
-		static const iocshFuncDef func2 = {"ek9kDisableDbg", 1, args};
-		iocshRegister(&func, ek9000DisableDebug);
-		iocshRegister(&func2, ek9000DisableDebug);
+		static const iocshArg arg1 = {"EK9000 Name", iocshArgString};
+		static const iocshArg arg2 = {"dump|invalidate", iocshArgString};
+		static const iocshArg arg3 = {"Terminal (0 for all)", iocshArgInt};
+		static const iocshArg* const args[] = {&arg1, &arg2, &arg3};
+		static const iocshFuncDef func = {"ek9000CoECache", 3, args};
+		static const iocshFuncDef func2 = {"ek9kCoECache", 3, args};
+		iocshRegister(&func, ek9000CoECache);
+		iocshRegister(&func2, ek9000CoECache);
 	}
 
-	/* ek9000List */
+	/* ek9000SetCoECacheTTL(ek9k, ttl[double]) */
 	{
-		static iocshFuncDef func = {"ek9000List", 0, NULL};
-		static iocshFuncDef func2 = {"ek9kList", 0, NULL};
-		iocshRegister(&func, ek9000List);
-		iocshRegister(&func2, ek9000List);
+		static const iocshArg arg1 = {"EK9000 Name", iocshArgString};
+		static const iocshArg arg2 = {"TTL (s)", iocshArgDouble};
+		static const iocshArg* const args[] = {&arg1, &arg2};
+		static const iocshFuncDef func = {"ek9000SetCoECacheTTL", 2, args};
+		static const iocshFuncDef func2 = {"ek9kSetCoECacheTTL", 2, args};
+		iocshRegister(&func, ek9000SetCoECacheTTL);
+		iocshRegister(&func2, ek9000SetCoECacheTTL);
 	}
 
 	return 0;
@@ -1221,18 +3345,125 @@ static long ek9000_init_record(void*) {
 	return 0;
 }
 
+/**
+ * Parallel bring-up of the couplers registered by ek9000Configure with ek9000SetParallelInit enabled. Each coupler is
+ * connected and mapped by its own thread, and ek9000_init waits for all of them up to the timeout. A coupler that failed
+ * or isn't up by then is left detached (see devEK9000::DetachFailed). A thread still running carries on, and
+ * ek9000Attach picks the coupler up once it's done.
+ */
+struct BringUpJob_t {
+	class devEK9000* dev;
+	bool done;
+	bool ok;
+	bool abandoned; /* ek9000_init stopped waiting, the thread frees the job */
+};
+
+static epicsMutexId s_bringUpLock;
+static epicsEventId s_bringUpEvent;
+
+static void BringUpThreadFunc(void* param) {
+	BringUpJob_t* job = static_cast<BringUpJob_t*>(param);
+	const bool ok = job->dev->BringUp();
+
+	epicsMutexMustLock(s_bringUpLock);
+	job->ok = ok;
+	job->done = true;
+	const bool abandoned = job->abandoned;
+	epicsMutexUnlock(s_bringUpLock);
+
+	if (abandoned) {
+		if (ok)
+			epicsPrintf("%s: finished bring-up after the init timeout, ek9000Attach(%s) to poll it\n",
+						job->dev->m_name.c_str(), job->dev->m_name.c_str());
+		delete job;
+	}
+	else
+		epicsEventSignal(s_bringUpEvent);
+}
+
+static void BringUpCouplers(double timeout) {
+	std::vector<BringUpJob_t*> jobs;
+	for (std::list<class devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
+		if ((*it)->m_init)
+			continue;
+		BringUpJob_t* job = new BringUpJob_t();
+		job->dev = *it;
+		jobs.push_back(job);
+	}
+	if (jobs.empty())
+		return;
+
+	if (!s_bringUpLock) {
+		s_bringUpLock = epicsMutexMustCreate();
+		s_bringUpEvent = epicsEventMustCreate(epicsEventEmpty);
+	}
+
+	epicsTimeStamp deadline;
+	epicsTimeGetCurrent(&deadline);
+	epicsTimeAddSeconds(&deadline, timeout);
+
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		std::string threadName = "EK9000_" + jobs[i]->dev->m_name;
+		epicsThreadCreate(threadName.c_str(), epicsThreadPriorityMedium,
+						  epicsThreadGetStackSize(epicsThreadStackMedium), BringUpThreadFunc, jobs[i]);
+	}
+
+	/* Wait for all of them, or the deadline */
+	while (true) {
+		size_t done = 0;
+		epicsMutexMustLock(s_bringUpLock);
+		for (size_t i = 0; i < jobs.size(); ++i)
+			done += jobs[i]->done;
+		epicsMutexUnlock(s_bringUpLock);
+		if (done == jobs.size())
+			break;
+
+		epicsTimeStamp now;
+		epicsTimeGetCurrent(&now);
+		const double left = epicsTimeDiffInSeconds(&deadline, &now);
+		if (left <= 0)
+			break;
+		epicsEventWaitWithTimeout(s_bringUpEvent, left);
+	}
+
+	epicsMutexMustLock(s_bringUpLock);
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		BringUpJob_t* job = jobs[i];
+		if (job->done && job->ok) {
+			delete job;
+			continue;
+		}
+
+		devEK9000::DetachFailed(job->dev, !job->done);
+		if (job->done) {
+			epicsPrintf("%s: bring-up failed\n", job->dev->m_name.c_str());
+			delete job;
+		}
+		else {
+			epicsPrintf("%s: not up after %.1f seconds, giving up on it\n", job->dev->m_name.c_str(), timeout);
+			job->abandoned = true;
+		}
+	}
+	epicsMutexUnlock(s_bringUpLock);
+}
+
 static long ek9000_init(int after) {
 	if (after == 0) {
 		epicsPrintf("Initializing EK9000 Couplers.\n");
+		if (devEK9000::parallelInit)
+			BringUpCouplers(devEK9000::parallelInitTimeout);
 		// for (auto dev : GlobalDeviceList()) {
 		for (std::list<class devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end();
 			 ++it) {
 			class devEK9000* dev = (*it);
-			if (!dev->m_init && !dev->ComputeTerminalMapping()) {
+			if (!dev->m_init && !dev->m_detached && !dev->BringUp()) {
 				epicsPrintf("Unable to compute terminal mapping\n");
 				return 1;
 			}
 		}
+		epicsMutexMustLock(RegistryLock());
+		PublishPollSet();
+		epicsMutexUnlock(RegistryLock());
 		epicsPrintf("Initialization Complete.\n");
 		Utl_InitThread();
 	}
@@ -1243,7 +3474,7 @@ static long ek9000_init(int after) {
 //
 // Device support types for CoE configuration
 // 		- Strings for CoE configuration should be like
-//			this: @CoE ek9k,terminal,index,subindex
+//			this: @CoE ek9k,terminal,index,subindex,type[,ttl]
 //
 //======================================================//
 // Common funcs/defs
@@ -1259,6 +3490,8 @@ struct ek9k_coe_param_t {
 		COE_TYPE_INT32,
 		COE_TYPE_INT64
 	} type;
+	bool hasTTL;
+	double ttl; /* Cache TTL from the link, "static" is -1 */
 };
 
 struct ek9k_param_t {
@@ -1269,9 +3502,166 @@ struct ek9k_param_t {
 
 struct ek9k_conf_pvt_t {
 	ek9k_coe_param_t param;
+	CoERequest_t req;  /* Reused for each transfer, the record stays active until it's done */
+	CALLBACK callback; /* Processes the record again once req is done */
+	dbCommon* record;
 };
 
 bool CoE_ParseString(const char* str, ek9k_coe_param_t* param);
+
+/* Registers the mailbox transfers for each type */
+static uint16_t CoE_Registers(int type) {
+	switch (type) {
+		case ek9k_coe_param_t::COE_TYPE_INT32:
+			return 2;
+		case ek9k_coe_param_t::COE_TYPE_INT64:
+			return 4;
+		default:
+			return 1;
+	}
+}
+
+/* Size of the object, for writes */
+static uint16_t CoE_Bytes(int type) {
+	switch (type) {
+		case ek9k_coe_param_t::COE_TYPE_BOOL:
+		case ek9k_coe_param_t::COE_TYPE_INT8:
+			return 1;
+		case ek9k_coe_param_t::COE_TYPE_INT16:
+			return 2;
+		case ek9k_coe_param_t::COE_TYPE_INT32:
+			return 4;
+		default:
+			return 8;
+	}
+}
+
+static epicsInt64 CoE_Decode(int type, const uint16_t* data) {
+	switch (type) {
+		case ek9k_coe_param_t::COE_TYPE_INT32:
+			{
+				uint32_t val;
+				memcpy(&val, data, sizeof(val));
+				return static_cast<epicsInt64>(val);
+			}
+		case ek9k_coe_param_t::COE_TYPE_INT64:
+			{
+				uint64_t val;
+				memcpy(&val, data, sizeof(val));
+				return static_cast<epicsInt64>(val);
+			}
+		default:
+			return static_cast<epicsInt64>(data[0]);
+	}
+}
+
+static void CoE_Encode(int type, epicsInt64 val, uint16_t* data) {
+	switch (type) {
+		case ek9k_coe_param_t::COE_TYPE_INT32:
+			{
+				uint32_t buf = static_cast<epicsInt32>(val);
+				memcpy(data, &buf, sizeof(buf));
+				break;
+			}
+		case ek9k_coe_param_t::COE_TYPE_INT64:
+			{
+				uint64_t buf = val;
+				memcpy(data, &buf, sizeof(buf));
+				break;
+			}
+		default:
+			data[0] = static_cast<epicsInt16>(val);
+			break;
+	}
+}
+
+/* The worker holds the device lock here, so just hand the record to a callback thread */
+static void ek9k_coe_done(CoERequest_t* req) {
+	ek9k_conf_pvt_t* dpvt = static_cast<ek9k_conf_pvt_t*>(req->user);
+	callbackRequestProcessCallback(&dpvt->callback, priorityMedium, dpvt->record);
+}
+
+static void ek9k_coe_free(CoERequest_t* req) {
+	delete req;
+}
+
+/* Queue a transfer for the record and leave it active until ek9k_coe_done. False if it couldn't be queued */
+static bool ek9k_coe_start(dbCommon* prec, ek9k_conf_pvt_t* dpvt, int rw, epicsInt64 val) {
+	CoERequest_t& req = dpvt->req;
+	req.rw = rw;
+	req.term = dpvt->param.pterm->m_terminalIndex;
+	req.index = dpvt->param.index;
+	req.subindex = dpvt->param.subindex;
+	req.len = CoE_Registers(dpvt->param.type);
+	req.reallen = rw ? CoE_Bytes(dpvt->param.type) : 0;
+	if (rw)
+		CoE_Encode(dpvt->param.type, val, req.data);
+	req.callback = ek9k_coe_done;
+	req.user = dpvt;
+	dpvt->record = prec;
+
+	/* Set first, the transfer may finish before QueueCoE returns */
+	prec->pact = TRUE;
+	if (dpvt->param.ek9k->QueueCoE(&req) != EK_EOK) {
+		prec->pact = FALSE;
+		return false;
+	}
+	return true;
+}
+
+/* Value of the object as the driver last saw it: any age for records processed by I/O Intr, else only if fresh */
+static bool ek9k_coe_last_value(ek9k_conf_pvt_t* dpvt, epicsInt64& val, bool fresh = false) {
+	class devEK9000* dev = dpvt->param.ek9k;
+	const uint16_t pos = dpvt->param.pterm->m_terminalIndex;
+	const uint16_t len = CoE_Registers(dpvt->param.type);
+	uint16_t buf[4];
+	if (fresh ? !dev->ReadCoECache(pos, dpvt->param.index, dpvt->param.subindex, buf, len)
+			  : !dev->GetCoEValue(pos, dpvt->param.index, dpvt->param.subindex, buf, len))
+		return false;
+	val = CoE_Decode(dpvt->param.type, buf);
+	return true;
+}
+
+static ek9k_conf_pvt_t* ek9k_coe_init_dpvt(dbCommon* prec, const char* link) {
+	ek9k_conf_pvt_t* dpvt = new ek9k_conf_pvt_t();
+	if (!CoE_ParseString(link, &dpvt->param)) {
+		delete dpvt;
+		prec->dpvt = NULL;
+		return NULL;
+	}
+	prec->dpvt = dpvt;
+	if (dpvt->param.hasTTL)
+		dpvt->param.ek9k->SetCoETTL(dpvt->param.pterm->m_terminalIndex, dpvt->param.index, dpvt->param.subindex,
+									dpvt->param.ttl);
+	return dpvt;
+}
+
+/* Input records only, an output record's readback is an input record on the same object */
+static long ek9k_coe_get_ioint_info(int cmd, void* prec, IOSCANPVT* iopvt) {
+	ek9k_conf_pvt_t* dpvt = static_cast<ek9k_conf_pvt_t*>(static_cast<dbCommon*>(prec)->dpvt);
+	if (!dpvt || !dpvt->param.ek9k)
+		return 1;
+
+	class devEK9000* dev = dpvt->param.ek9k;
+	const uint16_t pos = dpvt->param.pterm->m_terminalIndex;
+	*iopvt = dev->WatchCoE(pos, dpvt->param.index, dpvt->param.subindex);
+	if (!*iopvt)
+		return 1;
+
+	/* Read it once, so the record has a value without waiting for something else to touch the object */
+	epicsInt64 val;
+	if (cmd == 0 && !ek9k_coe_last_value(dpvt, val)) {
+		CoERequest_t* req = new CoERequest_t();
+		req->term = pos;
+		req->index = dpvt->param.index;
+		req->subindex = dpvt->param.subindex;
+		req->len = CoE_Registers(dpvt->param.type);
+		req->callback = ek9k_coe_free;
+		if (dev->QueueCoE(req) != EK_EOK)
+			delete req;
+	}
+	return 0;
+}
 //======================================================//
 
 //-----------------------------------------------------------------//
@@ -1288,7 +3678,12 @@ struct devEK9KCoERO_t {
 	DEVSUPFUN get_ioint_info;
 	DEVSUPFUN read_longin; /*returns: (-1,0)=>(failure,success)*/
 } devEK9KCoERO = {
-	5, NULL, (DEVSUPFUN)ek9k_confli_init, ek9k_confli_init_record, NULL, ek9k_confli_read_record,
+	5,
+	NULL,
+	(DEVSUPFUN)ek9k_confli_init,
+	ek9k_confli_init_record,
+	(DEVSUPFUN)ek9k_coe_get_ioint_info,
+	ek9k_confli_read_record,
 };
 
 epicsExportAddress(dset, devEK9KCoERO);
@@ -1299,15 +3694,10 @@ static long ek9k_confli_init(int) {
 
 static long ek9k_confli_init_record(void* prec) {
 	int64inRecord* precord = static_cast<int64inRecord*>(prec);
-	ek9k_coe_param_t param;
-	precord->dpvt = calloc(1, sizeof(ek9k_conf_pvt_t));
-	ek9k_conf_pvt_t* dpvt = static_cast<ek9k_conf_pvt_t*>(precord->dpvt);
-
-	if (!CoE_ParseString(precord->inp.value.instio.string, &param)) {
+	if (!ek9k_coe_init_dpvt((dbCommon*)precord, precord->inp.value.instio.string)) {
 		epicsPrintf("ek9k_confli_init_record: Malformed input link string for record %s\n", precord->name);
 		return 1;
 	}
-	dpvt->param = param;
 	return 0;
 }
 
@@ -1318,58 +3708,32 @@ static long ek9k_confli_read_record(void* prec) {
 	if (!dpvt || !dpvt->param.ek9k)
 		return 1;
 
-	DeviceLock lock(dpvt->param.ek9k);
+	/* Scanned because the driver just refreshed the object, no need to read it again */
+	if (precord->scan == menuScanI_O_Intr) {
+		if (!ek9k_coe_last_value(dpvt, precord->val)) {
+			recGblSetSevr(prec, COMM_ALARM, INVALID_ALARM);
+			return 1;
+		}
+		return 0;
+	}
 
-	int err = EK_EBADPARAM;
-	switch (dpvt->param.type) {
-		case ek9k_coe_param_t::COE_TYPE_BOOL:
-			{
-				uint16_t buf = 0;
-				err = dpvt->param.ek9k->doCoEIO(0, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 1, &buf,
-												dpvt->param.subindex);
-				precord->val = static_cast<epicsInt64>(buf);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT8:
-			{
-				uint16_t buf = 0;
-				err = dpvt->param.ek9k->doCoEIO(0, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 1, &buf,
-												dpvt->param.subindex);
-				precord->val = static_cast<epicsInt64>(buf);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT16:
-			{
-				uint16_t buf = 0;
-				err = dpvt->param.ek9k->doCoEIO(0, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 1, &buf,
-												dpvt->param.subindex);
-				precord->val = static_cast<epicsInt64>(buf);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT32:
-			{
-				uint32_t buf = 0;
-				err = dpvt->param.ek9k->doCoEIO(0, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 2,
-												reinterpret_cast<uint16_t*>(&buf), dpvt->param.subindex);
-				precord->val = static_cast<epicsInt64>(buf);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT64:
-			{
-				uint64_t buf = 0;
-				err = dpvt->param.ek9k->doCoEIO(0, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 4,
-												reinterpret_cast<uint16_t*>(&buf), dpvt->param.subindex);
-				precord->val = static_cast<epicsInt64>(buf);
-				break;
-			}
-		default: // Really should not get here
-			assert(0);
-			break;
+	if (!precord->pact) {
+		/* Still fresh in the cache, no transfer needed */
+		if (ek9k_coe_last_value(dpvt, precord->val, true))
+			return 0;
+		if (!ek9k_coe_start((dbCommon*)precord, dpvt, 0, 0)) {
+			recGblSetSevr(prec, COMM_ALARM, INVALID_ALARM);
+			return 1;
+		}
+		return 0;
 	}
-	if (err != EK_EOK) {
+
+	/* Processed again by ek9k_coe_done */
+	if (dpvt->req.status != EK_EOK) {
 		recGblSetSevr(prec, COMM_ALARM, INVALID_ALARM);
 		return 1;
 	}
+	precord->val = CoE_Decode(dpvt->param.type, dpvt->req.data);
 	return 0;
 }
 
@@ -1389,7 +3753,12 @@ struct devEK9KCoERW_t {
 	DEVSUPFUN get_ioint_info;
 	DEVSUPFUN write_longout; /*(-1,0)=>(failure,success*/
 } devEK9KCoERW = {
-	5, NULL, (DEVSUPFUN)ek9k_conflo_init, ek9k_conflo_init_record, NULL, ek9k_conflo_write_record,
+	5,
+	NULL,
+	(DEVSUPFUN)ek9k_conflo_init,
+	ek9k_conflo_init_record,
+	NULL, /* No I/O Intr, it would never write */
+	ek9k_conflo_write_record,
 };
 
 epicsExportAddress(dset, devEK9KCoERW);
@@ -1400,150 +3769,109 @@ static long ek9k_conflo_init(int) {
 
 static long ek9k_conflo_init_record(void* prec) {
 	int64outRecord* precord = static_cast<int64outRecord*>(prec);
-	ek9k_coe_param_t param;
-	precord->dpvt = calloc(1, sizeof(ek9k_conf_pvt_t));
-	ek9k_conf_pvt_t* dpvt = static_cast<ek9k_conf_pvt_t*>(precord->dpvt);
-
-	if (!CoE_ParseString(precord->out.value.instio.string, &param)) {
+	if (!ek9k_coe_init_dpvt((dbCommon*)precord, precord->out.value.instio.string)) {
 		epicsPrintf("ek9k_conflo_init_record: Malformed input link string for record %s\n", precord->name);
 		return 1;
 	}
-	dpvt->param = param;
 	return 0;
 }
 
 static long ek9k_conflo_write_record(void* prec) {
 	int64outRecord* precord = static_cast<int64outRecord*>(prec);
 	ek9k_conf_pvt_t* dpvt = static_cast<ek9k_conf_pvt_t*>(precord->dpvt);
-	int ret = EK_EOK;
 
 	if (!dpvt || !dpvt->param.ek9k)
 		return 1;
 
-	DeviceLock lock(dpvt->param.ek9k);
-
-	switch (dpvt->param.type) {
-		case ek9k_coe_param_t::COE_TYPE_BOOL:
-			{
-				uint16_t buf = static_cast<epicsInt16>(precord->val);
-				ret = dpvt->param.ek9k->doCoEIO(1, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 1, &buf,
-												dpvt->param.subindex, 1);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT8:
-			{
-				uint16_t buf = static_cast<epicsInt16>(precord->val);
-				ret = dpvt->param.ek9k->doCoEIO(1, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 1, &buf,
-												dpvt->param.subindex, 1);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT16:
-			{
-				uint16_t buf = static_cast<epicsInt16>(precord->val);
-				ret = dpvt->param.ek9k->doCoEIO(1, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 1, &buf,
-												dpvt->param.subindex, 2);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT32:
-			{
-				uint32_t buf = static_cast<epicsInt32>(precord->val);
-				ret = dpvt->param.ek9k->doCoEIO(1, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 2,
-												reinterpret_cast<uint16_t*>(&buf), dpvt->param.subindex, 4);
-				break;
-			}
-		case ek9k_coe_param_t::COE_TYPE_INT64:
-			{
-				uint64_t buf = precord->val;
-				ret = dpvt->param.ek9k->doCoEIO(1, dpvt->param.pterm->m_terminalIndex, dpvt->param.index, 4,
-												reinterpret_cast<uint16_t*>(&buf), dpvt->param.subindex, 8);
-				break;
-			}
-		default:
-			break;
+	if (!precord->pact) {
+		if (!ek9k_coe_start((dbCommon*)precord, dpvt, 1, precord->val)) {
+			epicsPrintf("ek9k_conflo_write_record(): Error writing data to record.\n");
+			recGblSetSevr(prec, COMM_ALARM, INVALID_ALARM);
+		}
+		return 0;
 	}
 
-	if (ret != EK_EOK) {
+	if (dpvt->req.status != EK_EOK) {
 		epicsPrintf("ek9k_conflo_write_record(): Error writing data to record.\n");
 		recGblSetSevr(prec, COMM_ALARM, INVALID_ALARM);
 	}
-
 	return 0;
 }
 
 //-----------------------------------------------------------------//
 
+/* Case insensitive prefix match, like epicsStrnCaseCmp(str, prefix, strlen(prefix)) on a C string */
+static bool CoE_TypeIs(const util::StrView_t& str, const char* prefix) {
+	const size_t len = strlen(prefix);
+	return str.len >= len && epicsStrnCaseCmp(str.str, prefix, len) == 0;
+}
+
 bool CoE_ParseString(const char* str, ek9k_coe_param_t* param) {
 	class devEK9000* pcoupler = 0;
-	devEK9000Terminal* pterm = 0;
 	int termid;
 	size_t bufcnt = 0;
-	char buf[512];
-	char* buffers[5];
-	memset(buffers, 0, sizeof(buffers));
-
-	if (str[0] == 0)
-		return false;
-
-	memset(buf, 0, sizeof(buf));
-	strncpy(buf, str, sizeof(buf) - 1);
+	util::StrView_t buffers[6];
 
-	/* Tokenize & separate into substrings */
-	for (char* tok = strtok((char*)str, ","); tok; tok = strtok(NULL, ",")) {
-		buffers[bufcnt] = tok;
-		++bufcnt;
+	/* Positional: device,terminal,index,subindex,type[,ttl] */
+	util::LinkParser parser(str);
+	while (parser.Next()) {
+		if (parser.KeyId() != util::LINK_KEY_NONE || bufcnt >= ArraySize(buffers))
+			return false;
+		buffers[bufcnt++] = parser.Value();
 	}
 
-	if (!buffers[0])
-		return 1;
-
-	const size_t strl = strlen(str);
-	for (size_t i = 0; i < strl; i++)
-		if (buf[i] == ',')
-			buf[i] = 0;
+	if (bufcnt < 5)
+		return false;
 
 	/* Finally actually parse the integers, find the ek9k, etc. */
-	// for (auto dev : GlobalDeviceList()) {
-	for (std::list<class devEK9000*>::iterator it = GlobalDeviceList().begin(); it != GlobalDeviceList().end(); ++it) {
-		class devEK9000* dev = *it;
-		if (strncmp(dev->m_name.data(), buffers[0], dev->m_name.size()) == 0) {
-			pcoupler = dev;
-			break;
-		}
-	}
+	char name[256];
+	if (buffers[0].CopyTo(name))
+		pcoupler = devEK9000::FindDevice(name);
 
 	if (!pcoupler) {
 		epicsPrintf("Coupler not found.\n");
 		return false;
 	}
-
-	if (bufcnt < 4)
+	/* Registered, but there's no mapping to address its terminals by */
+	if (!pcoupler->IsUp()) {
+		epicsPrintf("Coupler %s did not come up.\n", name);
 		return false;
+	}
 
 	/* Determine the CoE type */
-	if (epicsStrnCaseCmp(buffers[4], "bool", 4) == 0)
+	if (CoE_TypeIs(buffers[4], "bool"))
 		param->type = ek9k_coe_param_t::COE_TYPE_BOOL;
-	else if (epicsStrnCaseCmp(buffers[4], "int16", 5) == 0 || epicsStrnCaseCmp(buffers[4], "uint16", 6) == 0)
+	else if (CoE_TypeIs(buffers[4], "int16") || CoE_TypeIs(buffers[4], "uint16"))
 		param->type = ek9k_coe_param_t::COE_TYPE_INT16;
-	else if (epicsStrnCaseCmp(buffers[4], "int32", 5) == 0 || epicsStrnCaseCmp(buffers[4], "uint32", 6) == 0)
+	else if (CoE_TypeIs(buffers[4], "int32") || CoE_TypeIs(buffers[4], "uint32"))
 		param->type = ek9k_coe_param_t::COE_TYPE_INT32;
-	else if (epicsStrnCaseCmp(buffers[4], "int64", 5) == 0 || epicsStrnCaseCmp(buffers[4], "uint64", 6) == 0)
+	else if (CoE_TypeIs(buffers[4], "int64") || CoE_TypeIs(buffers[4], "uint64"))
 		param->type = ek9k_coe_param_t::COE_TYPE_INT64;
-	else if (epicsStrnCaseCmp(buffers[4], "int8", 4) == 0 || epicsStrnCaseCmp(buffers[4], "uint8", 5) == 0)
+	else if (CoE_TypeIs(buffers[4], "int8") || CoE_TypeIs(buffers[4], "uint8"))
 		param->type = ek9k_coe_param_t::COE_TYPE_INT8;
 	else
 		return false;
 
-	if (!util::parseNumber(buffers[1], termid, 10))
-		return 1;
-	pterm = pcoupler->m_terms[termid - 1];
+	if (!util::parseNumber(buffers[1], termid, 10) || termid < 1 || termid > (int)pcoupler->m_terms.size())
+		return false;
 
-	param->pterm = pterm;
+	param->pterm = pcoupler->m_terms[termid - 1];
 	param->ek9k = pcoupler;
 	if (!util::parseNumber(buffers[2], param->index, 16))
-		return 1;
+		return false;
 
 	if (!util::parseNumber(buffers[3], param->subindex, 16))
-		return 1;
+		return false;
+
+	/* Optional cache TTL in seconds, or static */
+	param->hasTTL = bufcnt > 5;
+	if (param->hasTTL) {
+		char ttl[64];
+		if (CoE_TypeIs(buffers[5], "static"))
+			param->ttl = -1;
+		else if (!buffers[5].CopyTo(ttl) || epicsParseDouble(ttl, &param->ttl, NULL) != 0 || param->ttl < 0)
+			return false;
+	}
 
 	return true;
 }
@@ -1563,6 +3891,7 @@ enum {
 	STATUS_WR = 0x2,
 	STATUS_RW = STATUS_RD | STATUS_WR,
 	STATUS_STATIC = 0x4, /* These registers will never change during runtime, only need to read these once */
+	STATUS_DRIVER = 0x8, /* Not a register, addr is an EDriverCounter */
 };
 typedef int StatusFlags;
 
@@ -1594,7 +3923,12 @@ CONSTEXPR StatusReg status_regs[] = {
 	{"wdtType",         0x1122, STATUS_RW                },
 	{"wdtFallback",     0x1123, STATUS_RW                },
 	{"writelock",       0x1124, STATUS_RW                },
-	{"ebusMode",        0x1140, STATUS_RW                }
+	{"ebusMode",        0x1140, STATUS_RW                },
+	{"outputVerifies",  COUNTER_OUTPUT_VERIFIES,    STATUS_RD | STATUS_DRIVER},
+	{"outputDrift",     COUNTER_OUTPUT_DRIFT,       STATUS_RD | STATUS_DRIVER},
+	{"outputDriftTotal", COUNTER_OUTPUT_DRIFT_TOTAL, STATUS_RD | STATUS_DRIVER},
+	{"outputRestores",  COUNTER_OUTPUT_RESTORES,    STATUS_RD | STATUS_DRIVER},
+	{"outputRestoreTime", COUNTER_OUTPUT_RESTORE_TIME, STATUS_RD | STATUS_DRIVER},
 };
 // clang-format on
 
@@ -1668,7 +4002,7 @@ static long ek9k_status_write_record(void* prec) {
 	ek9k_param_t* dpvt = static_cast<ek9k_param_t*>(precord->dpvt);
 	class devEK9000* dev = dpvt->ek9k;
 
-	if (!dev)
+	if (!dev || (dpvt->flags & STATUS_DRIVER))
 		return 1;
 
 	DeviceLock lock(dpvt->ek9k);
@@ -1689,6 +4023,11 @@ static long ek9k_status_read_record(void* prec) {
 	if (!dev)
 		return 1;
 
+	if (dpvt->flags & STATUS_DRIVER) {
+		precord->val = dev->GetCounter(static_cast<EDriverCounter>(dpvt->reg));
+		return 0;
+	}
+
 	if (dpvt->flags & STATUS_STATIC) {
 		if (dev->doEK9000IO(0, dpvt->reg, 1, &buf) != EK_EOK) {
 			recGblSetSevr(precord, COMM_ALARM, INVALID_ALARM);
@@ -1721,64 +4060,82 @@ static long ek9k_status_get_ioint_info(int cmd, void* prec, IOSCANPVT* iopvt) {
 /* The string will be in the format EK9K,0x1002 */
 bool ek9k_parse_string(const char* str, ek9k_param_t& param) {
 
-	LinkSpec_t spec;
-	if (!util::ParseLinkSpecification(str, INST_IO, spec))
+	if (!util::LinkParser::IsKeyValueLink(str))
 		return false;
 
+	param.ek9k = NULL;
 	param.reg = 0;
 	param.flags = 0;
 
-	for (size_t i = 0; i < spec.size(); ++i) {
-		if (spec[i].first == "device") {
-			param.ek9k = devEK9000::FindDevice(spec[i].second.c_str());
-			if (!param.ek9k) {
-				epicsPrintf("Unable to find device '%s' specified in instio string '%s'\n", spec[i].second.c_str(),
-							str);
-				return false;
-			}
-		}
-		else if (spec[i].first == "type") {
-
-			// Find param
-			for (size_t s = 0; s < ArraySize(status_regs); ++s) {
-				if (!strcmp(spec[i].second.c_str(), status_regs[s].configName)) {
-					param.reg = status_regs[s].addr;
-					param.flags = status_regs[s].flags;
+	util::LinkParser parser(str);
+	while (parser.Next()) {
+		const util::StrView_t& value = parser.Value();
+		switch (parser.KeyId()) {
+			case util::LINK_KEY_DEVICE:
+				{
+					char name[256];
+					param.ek9k = value.CopyTo(name) ? devEK9000::FindDevice(name) : NULL;
+					if (!param.ek9k) {
+						epicsPrintf("Unable to find device '%.*s' specified in instio string '%s'\n", (int)value.len,
+									value.str, str);
+						return false;
+					}
 					break;
 				}
-			}
-			if (param.reg == 0) {
-				epicsPrintf("Malformed instio string '%s', does not specify register\n", spec[i].second.c_str());
-				return false;
-			}
-		}
-		else if (spec[i].first == "addr") {
-			if (!util::parseNumber(spec[i].second.c_str(), param.reg, 16)) {
-				epicsStdoutPrintf("Malformed integer '%s' in instio string for key 'addr'\n", spec[i].second.c_str());
-				return false;
-			}
-		}
-		else if (spec[i].first == "flags") {
-			for (size_t n = 0; n < spec[i].second.length(); ++n) {
-				char c = spec[i].second[n];
-				if (c == 'r')
-					param.flags |= STATUS_RD;
-				else if (c == 'w')
-					param.flags |= STATUS_WR;
-				else if (c == 's')
-					param.flags |= STATUS_STATIC;
-				else {
-					epicsPrintf("Unknown status flag '%c' in instio string '%s' for key 'flags'\n", c,
-								spec[i].second.c_str());
+			case util::LINK_KEY_TYPE:
+				{
+					// Find param
+					bool found = false;
+					for (size_t s = 0; s < ArraySize(status_regs); ++s) {
+						if (value == status_regs[s].configName) {
+							param.reg = status_regs[s].addr;
+							param.flags = status_regs[s].flags;
+							found = true;
+							break;
+						}
+					}
+					if (!found) {
+						epicsPrintf("Malformed instio string '%.*s', does not specify register\n", (int)value.len,
+									value.str);
+						return false;
+					}
+					break;
+				}
+			case util::LINK_KEY_ADDR:
+				if (!util::parseNumber(value, param.reg, 16)) {
+					epicsStdoutPrintf("Malformed integer '%.*s' in instio string for key 'addr'\n", (int)value.len,
+									  value.str);
 					return false;
 				}
-			}
-		}
-		else {
-			epicsPrintf("Extraneous key '%s' in instio string '%s'\n", spec[i].first.c_str(), str);
-			return false;
+				break;
+			case util::LINK_KEY_FLAGS:
+				for (size_t n = 0; n < value.len; ++n) {
+					char c = value.str[n];
+					if (c == 'r')
+						param.flags |= STATUS_RD;
+					else if (c == 'w')
+						param.flags |= STATUS_WR;
+					else if (c == 's')
+						param.flags |= STATUS_STATIC;
+					else {
+						epicsPrintf("Unknown status flag '%c' in instio string '%s' for key 'flags'\n", c, str);
+						return false;
+					}
+				}
+				break;
+			default:
+				epicsPrintf("Extraneous key '%.*s' in instio string '%s'\n", (int)parser.Key().len, parser.Key().str,
+							str);
+				return false;
 		}
 	}
 
+	/* Same as records on the terminals, a coupler that failed to come up is left alone until it's attached */
+	if (!param.ek9k || !param.ek9k->IsUp()) {
+		epicsPrintf("No usable device specified in instio string '%s'\n", str);
+		param.ek9k = NULL;
+		return false;
+	}
+
 	return true;
 }
@@ -34,6 +34,7 @@
 #include <devSup.h>
 #include <alarm.h>
 #include <epicsString.h>
+#include <epicsTime.h>
 #include <dbScan.h>
 #include <boRecord.h>
 #include <iocsh.h>
@@ -41,6 +42,10 @@
 #include <epicsStdio.h>
 #include <errlog.h>
 #include <epicsMessageQueue.h>
+#include <epicsSpin.h>
+#include <epicsAtomic.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
 
 #include <drvModbusAsyn.h>
 #include <asynPortDriver.h>
@@ -48,12 +53,17 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
+#include <deque>
 #include <functional>
 #include <list>
+#include <map>
+#include <new>
+#include <string>
 #include <vector>
 
 #include "ekUtil.h"
 #include "ekCoE.h"
+#include "terminal_codec.h"
 
 #define PORT_PREFIX "PORT_"
 
@@ -61,11 +71,24 @@
 
 /* Beginning of the block of register space containing status info. Spans from 0x1010 <-> 0x1040 */
 #define EK9000_STATUS_START 0x1010
+#define EK9000_STATUS_FALLBACKS 0x1021
 #define EK9000_STATUS_EBUS_STATUS 0x1040
 #define EK9000_STATUS_END 0x1040
 
 #define TERMINAL_REGISTER_COUNT 0xFF
 
+/* Start of the analog output image (holding registers) */
+#define EK9000_OUTPUT_REG_START 0x800
+
+/* Largest read/write the coupler accepts in a single transaction */
+#define EK9000_MAX_READ_REGISTERS 125
+#define EK9000_MAX_READ_COILS 2000
+#define EK9000_MAX_WRITE_REGISTERS 123
+#define EK9000_MAX_WRITE_COILS 1968
+
+/* Timeout for transactions we send over the octet port ourselves */
+#define EK9000_PDU_TIMEOUT 1.0
+
 /* This device's error types */
 enum {
 	EK_EOK = 0,			/* OK */
@@ -85,7 +108,8 @@ enum {
 	EK_EBADMUTEX = 14,	/* Mutex error */
 	EK_EMUTEXTIMEOUT = 15,
 	EK_EBADTERMID = 16, /* Invalid terminal id */
-	EK_EMODBUSERR = 17	/* Modbus error */
+	EK_EMODBUSERR = 17, /* Modbus error */
+	EK_ELAYOUT = 18		/* Rail layout not confirmed, or it doesn't match the declared one */
 };
 
 /* Buffered IO types */
@@ -95,10 +119,139 @@ enum EIOType {
 	READ_STATUS	  /* For status registers (e.g. num TCP connections, hardware ver, etc) */
 };
 
+/* Counters kept by the driver itself. Published by EK9000ConfigRO records like the coupler's status registers */
+enum EDriverCounter {
+	COUNTER_OUTPUT_VERIFIES,	/* Number of output image verifications */
+	COUNTER_OUTPUT_DRIFT,		/* Outputs that didn't match their commanded value at the last verification */
+	COUNTER_OUTPUT_DRIFT_TOTAL, /* Sum of the above over all verifications */
+	COUNTER_OUTPUT_RESTORES,	/* Number of times the outputs were re-pushed after a fallback or reconnect */
+	COUNTER_OUTPUT_RESTORE_TIME, /* Time of the last re-push, seconds past the EPICS epoch */
+	COUNTER_COUNT
+};
+
 /* Forward decls */
 class devEK9000;
 class devEK9000Terminal;
+class devEK9000OutputGroup;
+class devEK9000Profile;
+struct CachedLayout_t;
+
+/* Process images of the coupler, as indexed by RailSnapshot_t::segments */
+enum ERailImage {
+	RAIL_ANALOG_IN,	   /* Input registers */
+	RAIL_DIGITAL_IN,   /* Discrete inputs, 0-based */
+	RAIL_REGISTER_OUT, /* Output registers, from EK9000_OUTPUT_REG_START */
+	RAIL_COIL_OUT,	   /* Coils, 0-based */
+	RAIL_IMAGE_COUNT
+};
+
+/* A stretch of a process image that is contiguous both as mapped and on the rail */
+struct RailSegment_t {
+	uint32_t mapped; /* Offset the records were resolved against */
+	uint32_t rail;	 /* Offset on the rail as it is now */
+	uint32_t count;
+};
+
+/**
+ * The rail as the poll thread last read it, and where the mapped terminals are on it. Snapshots are immutable once
+ * published (see devEK9000::PublishRail). Readers look at them under the device lock or m_inputSpin, both of which
+ * the swap takes; replaced ones are freed once the poll thread is past them, like PollSet_t.
+ *
+ * Records keep the offsets they were resolved against at init. When the rail changes, every configured terminal
+ * still at its position is located on the new rail, and the segments translate its offsets to where it is now. Records
+ * on positions that changed, or that can't be located because a terminal of unknown size precedes them, fail with
+ * EK_ELAYOUT until the rail is restored.
+ */
+struct RailSnapshot_t {
+	uint16_t ids[TERMINAL_REGISTER_COUNT];	  /* Coupler ID, then the terminal at each position */
+	int count;								  /* Number of terminals on the rail */
+	int firstMoved;							  /* First configured position that changed since mapping, 0 if none */
+	int unusable;							  /* Number of configured positions not usable */
+	bool usable[TERMINAL_REGISTER_COUNT];	  /* Position holds the terminal it was mapped with, at a known offset */
+	bool remapped;							  /* Some segment has moved on the rail */
+	std::vector<RailSegment_t> segments[RAIL_IMAGE_COUNT]; /* Usable parts of each image, sorted by mapped offset */
+	size_t retiredAt;									   /* s_pollEpoch when it was replaced */
+
+	/**
+	 * Translate a mapped offset to the rail
+	 * @returns How many of the count items from addr are contiguous on the rail, starting at rail. 0 if addr belongs
+	 * to a terminal that isn't usable
+	 */
+	uint32_t Span(ERailImage image, uint32_t addr, uint32_t count, uint32_t& rail) const;
+
+	/* Whether every item of [addr, addr + count) is usable */
+	bool Covers(ERailImage image, uint32_t addr, uint32_t count) const;
+};
+
+/* A CoE value written to a terminal each time its coupler is brought up, see ek9000LoadConfig */
+struct CoEPreset_t {
+	int pos;		   /* Rail position, 1-based */
+	uint16_t index;	   /* Object index */
+	uint16_t subindex; /* Object subindex */
+	uint16_t len;	   /* Length in registers */
+	uint16_t bytes;	   /* Length of the object in bytes */
+	uint16_t data[4];
+};
+
+/* Largest CoE object a single request can carry, in registers */
+#define COE_MAX_REGISTERS 64
+
+/**
+ * A CoE transfer through the coupler's mailbox at 0x1400, queued with devEK9000::QueueCoE. The mailbox handles one
+ * transfer at a time, so requests are run in order, one modbus transaction per step: start, poll until the terminal
+ * answers, then fetch the result of a read. The device lock is only held for each step, so the poll thread gets in
+ * between them.
+ */
+struct CoERequest_t {
+	int rw;			   /* 1 to write, 0 to read */
+	uint16_t term;	   /* Rail position, 1-based */
+	uint16_t index;	   /* Object index */
+	uint16_t subindex; /* Object subindex */
+	uint16_t len;	   /* Length in registers */
+	uint16_t reallen;  /* Length in bytes for writes, 0 for len * 2 */
+	uint16_t data[COE_MAX_REGISTERS];
+	int status;		   /* EK_E* once done */
+	uint16_t adsError; /* ADS error code when status is EK_EADSERR */
 
+	/**
+	 * Called once the request is done, normally by the CoE worker with the device lock held. Requests failed because
+	 * the worker couldn't get the lock are completed without it. May free the request, must not wait on another one
+	 */
+	void (*callback)(CoERequest_t* req);
+	void* user;
+
+	/* Owned by the queue */
+	int state;
+	epicsTimeStamp started;
+	epicsEventId done;
+
+	CoERequest_t()
+		: rw(0), term(0), index(0), subindex(0), len(0), reallen(0), status(EK_EOK), adsError(0), callback(NULL),
+		  user(NULL), state(0), done(NULL) {
+		memset(data, 0, sizeof(data));
+		memset(&started, 0, sizeof(started));
+	}
+};
+
+/**
+ * Cached value of a CoE object, refreshed whenever a transfer of it completes, writes included. Reads are served from
+ * it while it's fresh. See devEK9000::ReadCoECache and devEK9000::WatchCoE
+ */
+struct CoEValue_t {
+	IOSCANPVT scan; /* Requested on each refresh, NULL until an I/O Intr record watches the object */
+	bool valid;
+	uint16_t len; /* In registers */
+	uint16_t data[4];
+	epicsTimeStamp stamp; /* Time of the last refresh */
+	double ttl;			  /* Seconds it stays fresh, < 0 if it never changes on its own and 0 to not serve it */
+};
+
+/* Key for devEK9000Terminal::m_coeValues */
+inline uint32_t CoEKey(uint16_t index, uint16_t subindex) {
+	return ((uint32_t)index << 16) | subindex;
+}
+
+/* Every configured coupler, attached or not. Only for the init and iocsh paths, the poll thread has its own set */
 std::list<devEK9000*>& GlobalDeviceList();
 
 enum {
@@ -132,22 +285,24 @@ public:
 
 	static void GetTerminalInfo(int termid, int& inp_size, int& out_size);
 
+	/* TERMINAL_FAMILY_ANALOG or TERMINAL_FAMILY_DIGITAL by ID range, 0 for terminals without process data */
+	static int GetTerminalFamily(uint32_t termid);
+
 	/* Do EK9000 IO */
 	int doEK9000IO(int type, int startaddr, uint16_t* buf, int len);
 
 	/* Same calling convention as above, but use the buffered data! */
 	int getEK9000IO(EIOType type, int startaddr, uint16_t* buf, int len);
 
-	void SetRecordName(const char* rec) {
-		m_recordName = rec;
-	}
+	/* Set the legacy record name, and index it for ProcessRecordName */
+	void SetRecordName(const char* rec);
 
 public:
 	/* Name of record */
 	std::string m_recordName;
 	/* Terminal family */
 	int m_terminalFamily;
-	/* Zero-based index of the terminal */
+	/* Position of the terminal in the rail (first=1) */
 	int m_terminalIndex;
 	/* the device */
 	devEK9000* m_device;
@@ -161,6 +316,12 @@ public:
 	int m_inputStart;
 	/* Output image start */
 	int m_outputStart;
+	/* Codec the poll thread decodes the inputs with, NULL if the record does it. See devEK9000::SetPdoSizes */
+	const TerminalCodec_t* m_codec;
+	/* Sizes were read from the terminal's PDO assignment rather than the registry */
+	bool m_sizesFromPdos;
+	/* Cached CoE objects by CoEKey, guarded by the device lock */
+	std::map<uint32_t, CoEValue_t> m_coeValues;
 };
 
 //==========================================================//
@@ -178,6 +339,45 @@ private:
 	/* Mutex to lock modbus driver */
 	epicsMutexId m_Mutex;
 
+	/* Lay out the process image from m_terminals and size the input buffers and output image */
+	void MapTerminals();
+
+	/* Allocate the input buffers and output image for the given image extents, see CachedLayout_t */
+	void AllocateImages(int analogIn, int analogOut, int coilIn, int coilOut);
+
+	/* Check a cached layout against the rail and load it into m_terminals if it still matches */
+	bool VerifyCachedLayout(const CachedLayout_t& cached);
+
+	/* Take the terminal offsets from the cache rather than computing them. False if the cache is stale */
+	bool ApplyCachedMapping(const CachedLayout_t& cached);
+
+	/* Write the current layout and mapping to the cache, if one is configured */
+	void SaveLayoutCache(uint16_t serial);
+
+	/* Seed the output image from the device, setting m_outputImageValid */
+	void LoadOutputImage();
+
+	/* Append to the CoE queue and wake the worker, starting it if needed */
+	void EnqueueCoE(CoERequest_t* req);
+
+	/* Hand a request taken off the CoE queue back to its owner. Caller holds the device lock, not m_coeMutex */
+	void CompleteCoE(CoERequest_t* req, int status, uint16_t adsError);
+
+	/* Take req back out of the CoE queue if it hasn't reached the terminal yet. Caller holds m_coeMutex */
+	bool WithdrawCoE(CoERequest_t* req);
+
+	/* Complete every queued request but the one being serviced with status, for when the worker can't get at the
+	 * device */
+	void FailCoE(int status);
+
+	/* Cache the result of a finished transfer and request its scan, or drop the value if a write failed */
+	void RefreshCoEValue(const CoERequest_t* req);
+
+	/* Find or add the cache entry of an object. Caller must hold the lock */
+	CoEValue_t* CoECacheEntry(uint16_t pos, uint16_t index, uint16_t subindex);
+
+	static void CoEThreadFunc(void* param);
+
 public:
 	DELETE_CTOR(devEK9000());
 	devEK9000(const char* portName, const char* octetPortName, int termCount, const char* ip);
@@ -214,25 +414,192 @@ public:
 	int m_analog_status;
 	int m_digital_status;
 	int m_status_status;
-	/* The actual analog/digital data */
+	/**
+	 * The actual analog/digital data. Digital inputs are bit-packed as they come in the FC2 response, see ekBits.h.
+	 * Each image is double buffered: the poll thread reads into the back buffer and swaps it in under m_inputSpin, so
+	 * readers never wait on modbus I/O. The front buffers and the statuses above are only accessed under m_inputSpin.
+	 */
 	uint16_t* m_analog_buf;
-	uint16_t* m_digital_buf;
+	uint16_t* m_analog_back;
+	uint8_t* m_digital_bits;
+	uint8_t* m_digital_back;
+	epicsSpinId m_inputSpin;
+
+	/**
+	 * Analog input channels of terminals with a generated codec (see terminal_codec.h) are decoded once per cycle for
+	 * the whole image, rather than by each record. Consecutive channels of the same terminal type are merged into runs,
+	 * each decoded by one statically dispatched loop. Values and severities are double buffered along with the analog
+	 * image.
+	 */
+	struct DecodeRun_t {
+		uint32_t offset; /* First input register of the run */
+		uint32_t first;	 /* Decoded index of the first channel */
+		uint32_t count;	 /* Number of channels */
+		const TerminalCodec_t* codec;
+	};
+	std::vector<DecodeRun_t> m_decodeRuns;
+	std::vector<int32_t> m_decodedValues, m_decodedValuesBack;
+	/* Packed, 2 bits per channel */
+	std::vector<uint8_t> m_decodedSeverities, m_decodedSeveritiesBack;
+
 	uint16_t m_analog_cnt;
 	uint16_t m_digital_cnt;
 	/* Buffer for status info */
 	uint16_t m_status_buf[EK9000_STATUS_END - EK9000_STATUS_START + 1];
 
-	/* Cache of terminal layout */
+	/**
+	 * Rail layout, read once by ComputeTerminalMapping (or copied from the declared layout by MapDeclaredLayout): the
+	 * coupler's ID followed by the ID of the terminal at each position. This is the layout the terminals were mapped
+	 * and records resolved against; the rail as it is now is in m_rail. Read-only afterwards, so records can check it
+	 * without the lock
+	 */
 	uint16_t m_terminals[TERMINAL_REGISTER_COUNT];
+	int m_railCount; /* Number of terminals found on the rail */
 	bool m_readTerminals;
 
+	/**
+	 * Layout the user expects on the rail, see ek9000DeclareLayout. Lets the coupler be mapped while it is offline; the
+	 * mapping is then pending until the poll thread has compared it with the real rail on first connect. A mismatch
+	 * is handled like a rail change, see PublishRail
+	 */
+	std::vector<uint16_t> m_declaredLayout;
+	bool m_layoutPending;
+
+	/* Taken out of the poll set by ek9000Detach, or left out after a failed bring-up. The object stays alive, records
+	 * still point at it */
+	bool m_detached;
+
+	/* BringUp is running, and has succeeded once. Guarded by the registry lock */
+	bool m_bringingUp;
+	bool m_up;
+	/* Given up on by the parallel bring-up while it was still running. It may still finish, but its mapping is only
+	 * used once ek9000Attach adopts it (m_mappedLate), never by records set up during iocInit */
+	bool m_abandoned;
+	bool m_mappedLate;
+
+	/* Current RailSnapshot_t, swapped with epicsAtomicSetPtrT. Replaced snapshots wait in m_retiredRails until the poll
+	 * thread has moved past them */
+	EpicsAtomicPtrT m_rail;
+	std::vector<RailSnapshot_t*> m_retiredRails;
+
+	/* Pending CoE requests, the head one is in progress. Guarded by m_coeMutex, taken inside the device lock and never
+	 * held across modbus I/O */
+	std::deque<CoERequest_t*> m_coeQueue;
+	epicsMutexId m_coeMutex;
+	/* Request ServiceCoE is doing I/O for, it stays at the head of the queue until then */
+	CoERequest_t* m_coeActive;
+	/* Services the queue, started with the first request */
+	epicsThreadId m_coeThread;
+	epicsEventId m_coeEvent;
+
+	/* Thread holding the device lock, and how many times it took it */
+	EpicsAtomicPtrT m_lockOwner;
+	int m_lockDepth;
+
+	/* Watchdog settings and CoE values applied by ApplyPresets, -1 to leave the watchdog at its defaults */
+	int m_watchdogTime;
+	int m_watchdogType;
+	std::vector<CoEPreset_t> m_coePresets;
+
+	/* TTL of cached CoE objects not known to be static, see ek9000SetCoECacheTTL */
+	double m_coeCacheTTL;
+
+	/* Period for comparing the rail against m_rail, 0 to disable */
+	double m_railCheckPeriod;
+	epicsTimeStamp m_lastRailCheck;
+
+	/* Named output groups, see ekOutputGroup.h */
+	std::map<std::string, devEK9000OutputGroup*> m_groups;
+
+	/**
+	 * Output image: the last value commanded for every analog output register (from EK9000_OUTPUT_REG_START) and every
+	 * coil, seeded from the hardware at init. Outputs claimed by a record are flagged as owned; only those are verified.
+	 * Only accessed with the device lock held.
+	 */
+	std::vector<uint16_t> m_aout_image;
+	std::vector<bool> m_aout_owned;
+	/* Coils are bit-packed in the FC15 layout, see ekBits.h */
+	std::vector<uint8_t> m_dout_image;
+	std::vector<uint8_t> m_dout_owned;
+	size_t m_dout_count;
+	bool m_outputImageValid;
+
+	/* Our own connection to the octet port, for transactions drvModbusAsyn can't express (i.e. packed coils) */
+	asynUser* m_octetUser;
+
+	/* Period for verifying the output image against the hardware, 0 to disable */
+	double m_outputVerifyPeriod;
+	epicsTimeStamp m_lastOutputVerify;
+
+	/* Last fallback count read from the status block, to notice the watchdog firing */
+	uint16_t m_lastFallbacks;
+	bool m_fallbacksValid;
+	/* Time of the last status block read, each coupler keeps its own 1s cadence */
+	epicsTimeStamp m_lastStatusRead;
+	/* Why the outputs need putting back, NULL if they don't. Only cleared once RestoreOutputs succeeds */
+	const char* m_pendingRestore;
+	/* Set once the coupler has been connected, so a later connect is known to be a reconnect */
+	bool m_wasConnected;
+
+	/* Driver counters, accessed with epicsAtomic */
+	int m_counters[COUNTER_COUNT];
+
+	/* Output profiles stepped by the poll thread, see ekProfile.h */
+	std::vector<devEK9000Profile*> m_profiles;
+	epicsMutexId m_profileMutex;
+	/* Private group the profile outputs are written through */
+	devEK9000OutputGroup* m_profileGroup;
+
+	/* Dpvts of the records on this coupler, see CommitDpvt */
+	util::Arena m_dpvtArena;
+
 public:
 	static devEK9000* FindDevice(const char* name);
 
+	/* Look up an output group by name, optionally creating it if it doesn't exist yet */
+	devEK9000OutputGroup* FindOutputGroup(const char* name, bool create);
+
+	/**
+	 * Copy a dpvt filled in by util::setupCommonDpvt into this coupler's arena, so the dpvts of a coupler's records sit
+	 * next to each other. They are never freed.
+	 */
+	template <class DpvtT> DpvtT* CommitDpvt(const DpvtT& dpvt) {
+		return new (m_dpvtArena.Alloc(sizeof(DpvtT))) DpvtT(dpvt);
+	}
+
+	/* Register a profile to be stepped by the poll thread */
+	void AddProfile(devEK9000Profile* profile);
+
+	/* Step all profiles and write any outputs that changed. Called from the poll thread */
+	void RunProfiles();
+
+	/* The actual BringUp */
+	bool ConnectAndMap();
+
 public:
 	/* Allows for better error handling (instead of using print statements to indicate error) */
 	static devEK9000* Create(const char* name, const char* ip, int terminal_count);
 
+	/* Configure the ports and register the coupler, without talking to it. BringUp does the rest */
+	static devEK9000* Register(const char* name, const char* ip, int terminal_count);
+
+	/* Keep a coupler that failed to come up registered, but out of polling. Its asyn ports keep the name taken, so
+	 * ek9000Attach retries the bring-up instead of configuring a new one. abandoned marks one whose bring-up is still
+	 * running, so a late success doesn't make it usable behind iocInit's back */
+	static void DetachFailed(devEK9000* pek, bool abandoned = false);
+
+	/* Put a detached coupler back into the poll set, or configure and bring up a new one, at any time */
+	static devEK9000* Attach(const char* name, const char* ip, int terminal_count);
+
+	/* Stop polling a coupler and mark its inputs disconnected. Returns once the poll thread has let go of it */
+	static bool Detach(const char* name);
+
+	/* Connect, arm the watchdog and read the rail layout and mapping. Fails if it's already running */
+	bool BringUp();
+
+	/* Whether BringUp has succeeded, so records can be set up against the mapping */
+	bool IsUp() const;
+
 	int AddTerminal(const char* name, uint32_t type, int position);
 
 	/* Initializes a terminal (after it's been added). This should be called from the init_record routines */
@@ -241,6 +608,124 @@ public:
 	/* Called to set proper image start addresses and such */
 	bool ComputeTerminalMapping();
 
+	/* Map an offline coupler from m_declaredLayout instead of the rail */
+	bool MapDeclaredLayout();
+
+	/* Write the watchdog settings and queue the CoE presets once the mapping is confirmed. Caller must hold the lock */
+	void ApplyPresets();
+
+	/* Completion of a queued preset write */
+	static void PresetWritten(CoERequest_t* req);
+
+	/* Compare a pending declared layout with the rail. Called from the poll thread with the lock held */
+	void ValidateDeclaredLayout();
+
+	/* False while the mapping is unconfirmed or the coupler is detached; no I/O is done on the terminals then */
+	bool TerminalIOEnabled() const {
+		return !m_layoutPending && !m_detached;
+	}
+
+	/* The rail as last seen, NULL until the coupler has been mapped. Caller must hold the lock or m_inputSpin */
+	const RailSnapshot_t* Rail() const {
+		return static_cast<const RailSnapshot_t*>(epicsAtomicGetPtrT(&m_rail));
+	}
+
+	/**
+	 * Locate the mapped terminals on the rail in ids, and swap in a snapshot of it. Caller must hold the lock
+	 * @returns true if outputs of usable terminals may have been reset, because they moved or came back
+	 */
+	bool PublishRail(const uint16_t* ids, int count);
+
+	/* Whether the terminal at pos is the one it was mapped with. Safe to call without the lock */
+	bool PositionUnchanged(int pos) const;
+
+	/* Free the retired snapshots the poll thread can no longer be looking at. Caller must hold the lock */
+	void ReclaimRails();
+
+	/* Read the rail and publish it if it changed. Called from the poll thread with the lock held */
+	int CheckRail();
+
+	/* Whether a write to these mapped outputs lands on a terminal that is still on the rail. Caller must hold the lock */
+	bool CoilsActive(size_t addr, size_t count) const;
+	bool RegistersActive(size_t addr, size_t count) const;
+
+	/* Declare the terminal IDs expected on a coupler's rail, before or after ek9000Configure */
+	static bool DeclareLayout(const char* name, const std::vector<uint16_t>& ids);
+
+	/**
+	 * Load the template from dbDir for each terminal on the rail, with TERMINAL=<base><pos>,DEVICE=<name>,POS=<pos> plus
+	 * any extra macros. Must be called before iocInit. Returns the number of terminals loaded, or -1 on error
+	 */
+	int AutoConfigure(const char* dbDir, const char* base, const char* macros);
+
+public:
+	/* Output image, see m_aout_image */
+
+	/* Read the whole output image from the device into aout/dout (sized to the image). Caller must hold the lock */
+	int ReadOutputImage(uint16_t* aout, uint8_t* dout);
+
+	/**
+	 * Claim holding registers for a record, and get their current value from the output image
+	 * @param addr Holding register address
+	 * @param current Receives len values, may be NULL
+	 * @returns true if current holds a value read back from the hardware
+	 */
+	bool ClaimRegisters(uint16_t addr, uint16_t len, uint16_t* current);
+
+	/* Same as above for up to 32 coils starting at the 0-based coil address addr. current receives them packed */
+	bool ClaimCoils(uint16_t addr, uint16_t len, uint32_t* current);
+
+	/* Up to 32 coils from the output image, packed with the first coil in bit 0. Caller must hold the lock */
+	uint32_t OutputCoils(uint16_t addr, uint16_t len) const;
+
+	/* Holding register addr from the output image. Caller must hold the lock */
+	uint16_t OutputRegister(uint16_t addr) const;
+
+	/* Record a successful holding register write in the output image. Caller must hold the lock */
+	void UpdateOutputImage(int function, uint16_t addr, const uint16_t* data, uint16_t len);
+
+	/**
+	 * Write len output registers at the mapped address addr, wherever they are on the rail now, and record them in
+	 * the output image. Caller must hold the lock
+	 * @returns EK_ELAYOUT if any of them belongs to a terminal that isn't usable
+	 */
+	int WriteRegisters(uint16_t addr, const uint16_t* data, uint16_t len);
+
+public:
+	/* Bit-packed I/O. These bypass drvModbusAsyn's one word per bit buffers and build the PDU directly */
+
+	/**
+	 * Send a raw modbus PDU (starting with the unit ID) over the octet port and read back the response
+	 * @returns EK_EOK if the response carries the request's function code
+	 */
+	int DoModbusPDU(const uint8_t* req, size_t reqLen, uint8_t* resp, size_t respSize, size_t& respLen);
+
+	/**
+	 * Write count coils starting at the mapped 0-based coil address addr with FC15, taking their values from the packed
+	 * image src starting at srcBit. Splits into as many transactions as needed. Caller must hold the lock
+	 */
+	int WriteCoilsPacked(uint16_t addr, const uint8_t* src, size_t srcBit, uint16_t count);
+
+	/* Write up to 32 coils, value holds them packed with the first coil in bit 0. Caller must hold the lock */
+	int WriteCoils(uint16_t addr, uint32_t value, uint16_t count);
+
+	/* Read count coils (FC1) or discrete inputs (FC2) into the packed image dst from dstBit. Caller must hold the lock */
+	int ReadBitsPacked(int function, uint16_t addr, uint8_t* dst, size_t dstBit, uint16_t count);
+
+	/* Read the usable parts of an input image into its back buffer, in the mapped layout. Caller must hold the lock */
+	int ReadInputSegments(const RailSnapshot_t* rail, ERailImage image);
+
+	/* Compare the owned outputs against the hardware, updating the drift counters. Caller must hold the lock */
+	int VerifyOutputImage();
+
+	/**
+	 * Re-push the last commanded value of every owned output, in as few writes as possible. Used after the coupler
+	 * dropped its outputs to their fallback values. Caller must hold the lock
+	 */
+	int RestoreOutputs(const char* reason);
+
+	int GetCounter(EDriverCounter counter) const;
+
 public:
 	/* Error handling functions */
 
@@ -276,10 +761,103 @@ public:
 	 */
 	int getEK9000IO(EIOType type, int startaddr, uint16_t* buf, uint16_t len);
 
-	/* Do CoE I/O */
+	/**
+	 * Resolve a record's location in the input image, checking it against the image size
+	 * @param term Terminal the inputs belong to
+	 * @param image INPUT_IMAGE_ANALOG or INPUT_IMAGE_DIGITAL
+	 * @param offset Input register index, or 0-based discrete input address
+	 * @param width Number of registers, or number of inputs (<= 32)
+	 * @returns false if the location is outside of the image
+	 */
+	bool ResolveInput(const devEK9000Terminal* term, EInputImage image, int offset, int width,
+					  ReadDescriptor_t& out) const;
+
+	/**
+	 * Resolve a terminal channel in the decoded image
+	 * @param channel 1-based channel
+	 * @returns false if the terminal has no codec or the channel is out of range
+	 */
+	bool ResolveChannel(const devEK9000Terminal* term, int channel, ReadDescriptor_t& out) const;
+
+	/**
+	 * Copy a record's data out of the buffered input image. No I/O and no device lock.
+	 * @param out Receives desc.width registers for analog images, a uint32_t with the inputs packed into it (first
+	 * in bit 0) for digital images, or a DecodedInput_t for decoded images
+	 */
+	int ReadInput(const ReadDescriptor_t& desc, void* out);
+
+	/* Build the decode runs from the terminal mapping and the generated codec table */
+	void SetupInputDecode();
+
+	/* Decode all codec channels in the back buffer into the back value/severity arrays */
+	void DecodeInputs();
+
+	/* Swap in a freshly read back buffer if status is OK, and publish the status. Called from the poll thread */
+	void PublishInputs(EInputImage image, int status);
+
+	/**
+	 * Do CoE I/O, waiting for it to finish. See CoERequest_t. A caller holding the device lock keeps it, and drives the
+	 * queue itself until its transfer is done, so a sequence of transfers under the lock isn't interleaved
+	 */
 	int doCoEIO(int rw, uint16_t term, uint16_t index, uint16_t len, uint16_t* data, uint16_t subindex,
 				uint16_t reallen = 0);
 
+	/* doCoEIO without the layout checks, for use while mapping */
+	int CoETransfer(int rw, uint16_t term, uint16_t index, uint16_t len, uint16_t* data, uint16_t subindex,
+					uint16_t reallen = 0);
+
+	/**
+	 * Queue a CoE request and return right away; its callback is called once it's done. Returns EK_ELAYOUT without
+	 * queueing it if the terminal can't be trusted to be the one at that position
+	 */
+	int QueueCoE(CoERequest_t* req);
+
+	/**
+	 * Start tracking the value of a CoE object of the terminal at pos, and return the scan list requested each time a
+	 * transfer of it completes, from any caller. For I/O Intr records
+	 */
+	IOSCANPVT WatchCoE(uint16_t pos, uint16_t index, uint16_t subindex);
+
+	/* Copy out the last value of a CoE object, however old. False if it hasn't been transferred since invalidated */
+	bool GetCoEValue(uint16_t pos, uint16_t index, uint16_t subindex, uint16_t* data, uint16_t len);
+
+	/* Like GetCoEValue, but only while the value is within its TTL */
+	bool ReadCoECache(uint16_t pos, uint16_t index, uint16_t subindex, uint16_t* data, uint16_t len);
+
+	/* Override the TTL of an object, < 0 to mark it static */
+	void SetCoETTL(uint16_t pos, uint16_t index, uint16_t subindex, double ttl);
+
+	/* Drop the cached values of the terminal at pos, or of every terminal if pos is 0 */
+	void InvalidateCoECache(int pos);
+
+	/* Print the CoE cache of the terminal at pos, or of every terminal if pos is 0 */
+	void ReportCoECache(int pos);
+
+	/**
+	 * Advance the request at the head of the CoE queue by one modbus transaction. Caller must hold the device lock,
+	 * so there's only ever one thread doing this
+	 * @returns true if there's more to do
+	 */
+	bool ServiceCoE();
+
+	/* Whether the calling thread holds the device lock */
+	bool LockHeld() const {
+		return epicsAtomicGetPtrT(&m_lockOwner) == (void*)epicsThreadGetIdSelf();
+	}
+
+	/* Tracks the owner for LockHeld */
+	virtual asynStatus lock();
+	virtual asynStatus unlock();
+
+	/**
+	 * Add up the entries of the PDOs assigned to the terminal at pos (0x1C13 for inputs, 0x1C12 for outputs). Sizes are
+	 * in registers for analog terminals, in bits for digital ones, like devEK9000Terminal::m_inputSize
+	 */
+	int ReadPdoSizes(int pos, int family, int& inputSize, int& outputSize);
+
+	/* Give a terminal sizes other than the registry's, picking the codec that matches them */
+	void SetPdoSizes(devEK9000Terminal* term, int inputSize, int outputSize);
+
 	/* Reads the value of the CoE register */
 	int ReadCOECode();
 
@@ -328,13 +906,14 @@ public:
 	/* Enable/disable writing to second modbus client */
 	int WriteWritelockMode(uint16_t mode);
 
-	/* Read terminal type */
-	uint16_t ReadTerminalID(uint16_t index);
+	/* Read the rail layout into m_terminals. Caller must hold the lock, or be the only user of the device */
+	int ReadRailLayout();
 
-	/* Poll the ek9000 until data is ready/error */
-	/* Return 0 for OK, 1 for error */
-	/* Duration is the space between each request, timeout is the number of requests to timeout after */
-	inline int Poll(float duration, int timeout);
+	/* Read the rail layout into ids (TERMINAL_REGISTER_COUNT long), leaving m_terminals alone */
+	int FetchRailLayout(uint16_t* ids, int& count);
+
+	/* ID of the terminal at the 1-based rail position, from the layout. Does no I/O. 0 if there is no terminal there */
+	uint16_t LayoutTerminalID(int pos) const;
 
 	/* Try connect to terminal with CoE */
 	/* Returns 1 for connection, 0 for not */
@@ -353,6 +932,13 @@ public:
 
 	static bool debugEnabled;
 	static int pollDelay;
+	/* Bring couplers up in parallel in ek9000_init rather than in ek9000Configure, see ek9000SetParallelInit */
+	static bool parallelInit;
+	static double parallelInitTimeout;
+	/* Directory for the rail layout cache, see ek9000SetLayoutCache. Empty to disable */
+	static std::string layoutCacheDir;
+	/* Size terminals from their PDO assignment rather than the registry, see ek9000SetPdoIntrospection */
+	static bool pdoIntrospection;
 
 public:
 	/* Needed for the list impl */
@@ -374,8 +960,7 @@ public:
 	}
 
 	~DeviceLock() {
-		if (!m_unlocked)
-			m_mutex.unlock();
+		unlock();
 	}
 
 	inline int status() const {
@@ -385,8 +970,9 @@ public:
 		return m_status == asynSuccess;
 	}
 
+	/* Only releases what was actually taken */
 	inline void unlock() {
-		if (!m_unlocked)
+		if (!m_unlocked && valid())
 			m_mutex.unlock();
 		m_unlocked = true;
 	}
@@ -27,8 +27,10 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <algorithm>
 
 #include "devEK9000.h"
+#include "ekBits.h"
 
 static long EL10XX_dev_report(int) {
 	return 0;
@@ -38,42 +40,53 @@ static long EL10XX_init(int) {
 	return 0;
 }
 
-static inline void type_specific_setup(biRecord*, uint16_t) {
+static inline uint16_t get_nobt(biRecord*) {
+	return 1;
 }
-static inline void type_specific_setup(mbbiDirectRecord* record, uint16_t numbits) {
-	record->nobt = numbits;
-	record->mask = (1 << numbits) - 1;
+static inline uint16_t get_nobt(mbbiDirectRecord* record) {
+	return record->nobt;
+}
+
+static inline bool type_specific_setup(biRecord*, TerminalDpvt_t*) {
+	return true;
+}
+/* mbbiDirect covers the whole terminal, or up to 32 channels starting at channel= for wider terminals */
+static inline bool type_specific_setup(mbbiDirectRecord* record, TerminalDpvt_t* dpvt) {
+	const int first = dpvt->channel > 0 ? dpvt->channel - 1 : 0;
+	if (first >= dpvt->pterm->m_inputSize)
+		return false;
+	record->nobt = std::min(dpvt->pterm->m_inputSize - first, 32);
+	record->mask = bits::Mask(record->nobt);
 	record->shft = 0;
+	return true;
 }
 
 template <class RecordT> static long EL10XX_init_record(void* precord) {
 	RecordT* pRecord = (RecordT*)precord;
-	pRecord->dpvt = util::allocDpvt();
-	TerminalDpvt_t* dpvt = (TerminalDpvt_t*)pRecord->dpvt;
-	uint16_t termid = 0;
-
 	/* Get terminal */
-	if (!util::setupCommonDpvt<RecordT>(pRecord, *dpvt)) {
-		LOG_ERROR(dpvt->pdrv, "Unable to setup dpvt for record %s\n", pRecord->name);
+	InputDpvt_t setup;
+	if (!util::setupCommonDpvt<RecordT>(pRecord, setup)) {
+		LOG_ERROR(setup.pdrv, "Unable to setup dpvt for record %s\n", pRecord->name);
 		return 1;
 	}
+	InputDpvt_t* dpvt = setup.pdrv->CommitDpvt(setup);
+	pRecord->dpvt = dpvt;
 
-	type_specific_setup(pRecord, dpvt->pterm->m_inputSize);
-
-	// Verify terminal ID
-	{
-		DeviceLock lock(dpvt->pdrv);
-
-		/* Verify lock OK */
-		if (!lock.valid()) {
-			LOG_ERROR(dpvt->pdrv, "failed to obtain device lock\n");
-			return 1;
-		}
-
-		/* Read termid */
-		termid = dpvt->pdrv->ReadTerminalID(dpvt->pterm->m_terminalIndex);
+	const bool mbbi = util::is_same<RecordT, mbbiDirectRecord>::value;
+	// Resolve the record's inputs once. channel is 1-based index, m_inputStart is also 1-based, but modbus inputs are
+	// 0-based, hence the -2 for single bits. mbbiDirect records start at channel=, or the first input
+	const int addr = mbbi ? dpvt->pterm->m_inputStart - 1 + (dpvt->channel > 0 ? dpvt->channel - 1 : 0)
+						  : dpvt->pterm->m_inputStart + (dpvt->channel - 2);
+	if (!type_specific_setup(pRecord, dpvt) ||
+		!dpvt->pdrv->ResolveInput(dpvt->pterm, INPUT_IMAGE_DIGITAL, addr, get_nobt(pRecord), dpvt->input)) {
+		LOG_ERROR(dpvt->pdrv, "%s: channel %d is out of range for EL%d\n", pRecord->name, dpvt->channel,
+				  dpvt->pterm->m_terminalId);
+		return 1;
 	}
 
+	// Verify terminal ID against the rail layout read when the coupler was mapped
+	const uint16_t termid = dpvt->pdrv->LayoutTerminalID(dpvt->pterm->m_terminalIndex);
+
 	pRecord->udf = FALSE;
 
 	/* Invalid term id */
@@ -103,7 +116,7 @@ static inline void set_mbbi_rval(mbbiDirectRecord* record, uint32_t val) {
 
 template <class RecordT> static long EL10XX_read_record(void* prec) {
 	RecordT* pRecord = (RecordT*)prec;
-	TerminalDpvt_t* dpvt = (TerminalDpvt_t*)pRecord->dpvt;
+	InputDpvt_t* dpvt = (InputDpvt_t*)pRecord->dpvt;
 
 	/* Check for invalid */
 	if (!util::DpvtValid(dpvt))
@@ -111,16 +124,9 @@ template <class RecordT> static long EL10XX_read_record(void* prec) {
 
 	const bool mbbi = util::is_same<RecordT, mbbiDirectRecord>::value;
 
-	/* Do the actual IO */
-	uint16_t buf[32];
-	const uint16_t num = mbbi ? dpvt->pterm->m_inputSize : 1;
-	uint16_t addr =
-		mbbi ? dpvt->pterm->m_inputStart - 1
-			 : dpvt->pterm->m_inputStart + (dpvt->channel - 2); // For non-mbbi records compute the coil offset.
-																// channel is 1-based index, m_inputStart is also
-																// 1-based, but modbus coils are 0-based, hence the -2
-	assert(num <= sizeof(buf));
-	int status = dpvt->pterm->getEK9000IO(READ_DIGITAL, addr, buf, num);
+	/* Inputs are buffered bit-packed: a bi is a single bit, an mbbiDirect a shift and mask of one word */
+	uint32_t value = 0;
+	int status = dpvt->pdrv->ReadInput(dpvt->input, &value);
 
 	/* Error states */
 	if (status != EK_EOK) {
@@ -129,18 +135,14 @@ template <class RecordT> static long EL10XX_read_record(void* prec) {
 		return 1;
 	}
 
-	// for mbbi, we need to composite our channel data into a single bit vector and leave .VAL alone
+	// for mbbi the bits are the raw value, leave .VAL alone
 	if (mbbi) {
-		uint32_t outVec = 0;
-		STATIC_ASSERT(sizeof(buf) / sizeof(buf[0]) <= sizeof(outVec) * 8);
-		for (size_t i = 0; i < ArraySize(buf); ++i)
-			outVec |= (buf[i] << i) & (1 << i);
 		// Template hack because we have no if constexpr before C++17
-		set_mbbi_rval(pRecord, outVec);
+		set_mbbi_rval(pRecord, value);
 	}
 	else {
-		pRecord->val = buf[0];
-		pRecord->rval = buf[0];
+		pRecord->val = value;
+		pRecord->rval = value;
 	}
 	pRecord->udf = FALSE;
 	return 0;
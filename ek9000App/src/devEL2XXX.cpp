@@ -22,12 +22,16 @@
 #include <mbboDirectRecord.h>
 #include <callback.h>
 #include <recGbl.h>
+#include <dbEvent.h>
 #include <drvModbusAsyn.h>
 
 #include <stddef.h>
 #include <stdint.h>
+#include <algorithm>
 
 #include "devEK9000.h"
+#include "ekBits.h"
+#include "ekOutputGroup.h"
 
 //======================================================//
 //
@@ -42,9 +46,29 @@ static inline uint16_t get_nobt(mbboDirectRecord* record) {
 	return record->nobt;
 }
 
+/* Record value, packed with the first coil in bit 0 */
+static inline uint32_t get_coil_bits(boRecord* record) {
+	return record->val ? 1 : 0;
+}
+static inline uint32_t get_coil_bits(mbboDirectRecord* record) {
+	return record->rval;
+}
+
+/* 0-based address of the record's first coil. mbboDirect covers the whole terminal, or up to 32 channels starting at
+ * channel= for wider terminals */
+static inline uint16_t get_coil_addr(boRecord* record, TerminalDpvt_t* dpvt) {
+	/* channel - 1 for a 0-based index, and subtract another 1 because modbus coils start at 0, and outputStart is
+	 * 1-based */
+	return dpvt->pterm->m_outputStart + (dpvt->channel - 2);
+}
+static inline uint16_t get_coil_addr(mbboDirectRecord* record, TerminalDpvt_t* dpvt) {
+	return dpvt->pterm->m_outputStart - 1 + (dpvt->channel > 0 ? dpvt->channel - 1 : 0);
+}
+
 template <class RecordT> static void EL20XX_WriteCallback(CALLBACK* callback) {
 	RecordT* pRecord;
 	int status = 0;
+	uint32_t rbv = 0;
 	void* record;
 	callbackGetUser(record, callback);
 	pRecord = (RecordT*)record;
@@ -68,26 +92,11 @@ template <class RecordT> static void EL20XX_WriteCallback(CALLBACK* callback) {
 			return;
 		}
 
-		const bool mbbo = util::is_same<mbboDirectRecord, RecordT>::value;
-
-		uint16_t buf[32];
-		const uint16_t length = get_nobt(pRecord); // Will be 1 for bo, nobt for mbboDirect
-		if (mbbo) {
-			// Inflate packed bit data into the input buffer
-			for (int i = 0; i < length; ++i) {
-				buf[i] = (pRecord->rval & (1 << i)) >> i;
-			}
-		}
-		else {
-			buf[0] = pRecord->val;
-		}
-
-		const uint16_t addr = mbbo ? dpvt->pterm->m_outputStart - 1 : dpvt->pterm->m_outputStart + (dpvt->channel - 2);
-
-		/* Write to buffer */
-		/** The logic here: channel - 1 for a 0-based index, and subtract another 1 because modbus coils start at 0, and
-		 * inputStart is 1-based **/
-		status = dpvt->pterm->doEK9000IO(MODBUS_WRITE_MULTIPLE_COILS, addr, buf, length);
+		/* Packed straight into the FC15 payload */
+		status = dpvt->pdrv->WriteCoils(get_coil_addr(pRecord, dpvt), get_coil_bits(pRecord), get_nobt(pRecord));
+		/* Read back what the output image says the coils are now */
+		if (!status)
+			rbv = dpvt->pdrv->OutputCoils(get_coil_addr(pRecord, dpvt), get_nobt(pRecord));
 	}
 
 	/* check for errors... */
@@ -101,7 +110,7 @@ template <class RecordT> static void EL20XX_WriteCallback(CALLBACK* callback) {
 	/* OK, we've written a value, everything looks good.  We need to reprocess this! */
 	struct typed_rset* prset = (struct typed_rset*)(pRecord->rset);
 	dbScanLock((struct dbCommon*)pRecord);
-	pRecord->rbv = pRecord->val;
+	pRecord->rbv = rbv;
 	pRecord->udf = FALSE;
 	(*prset->process)((struct dbCommon*)pRecord); /* This will set PACT false! */
 	dbScanUnlock((struct dbCommon*)pRecord);
@@ -115,55 +124,89 @@ static long EL20XX_init(int) {
 	return 0;
 }
 
-static inline void type_specific_setup(boRecord* record, int16_t numbits){};
-static inline void type_specific_setup(mbboDirectRecord* record, int16_t numbits) {
-	record->nobt = numbits;
-	record->mask = (1 << numbits) - 1;
+static inline bool type_specific_setup(boRecord* record, TerminalDpvt_t* dpvt) {
+	return true;
+}
+static inline bool type_specific_setup(mbboDirectRecord* record, TerminalDpvt_t* dpvt) {
+	const int first = dpvt->channel > 0 ? dpvt->channel - 1 : 0;
+	if (first >= dpvt->pterm->m_outputSize)
+		return false;
+	record->nobt = std::min(dpvt->pterm->m_outputSize - first, 32);
+	record->mask = bits::Mask(record->nobt);
 	record->shft = 0;
+	return true;
 }
 
 template <class RecordT> static long EL20XX_init_record(void* precord) {
 	RecordT* pRecord = (RecordT*)precord;
-	pRecord->dpvt = util::allocDpvt();
-	TerminalDpvt_t* dpvt = (TerminalDpvt_t*)pRecord->dpvt;
 
 	/* Grab terminal info */
-	if (!util::setupCommonDpvt<RecordT>(pRecord, *dpvt)) {
-		LOG_ERROR(dpvt->pdrv, "Unable to setup dpvt for %s\n", pRecord->name);
+	TerminalDpvt_t setup;
+	if (!util::setupCommonDpvt<RecordT>(pRecord, setup)) {
+		LOG_ERROR(setup.pdrv, "Unable to setup dpvt for %s\n", pRecord->name);
 		return 1;
 	}
+	TerminalDpvt_t* dpvt = setup.pdrv->CommitDpvt(setup);
+	pRecord->dpvt = dpvt;
 
-	type_specific_setup(pRecord, dpvt->pterm->m_outputSize);
-
-	/* Verify the connection */
-	if (!dpvt->pdrv->VerifyConnection()) {
-		LOG_ERROR(dpvt->pdrv, "%s\n", devEK9000::ErrorToString(EK_ENOCONN));
+	if (!type_specific_setup(pRecord, dpvt)) {
+		LOG_ERROR(dpvt->pdrv, "%s: channel %d is out of range for EL%d\n", pRecord->name, dpvt->channel,
+				  dpvt->pterm->m_terminalId);
 		return 1;
 	}
 
-	/* Lock mutex for modbus */
-	DeviceLock lock(dpvt->pdrv);
-
-	/* Check mutex status */
-	if (!lock.valid()) {
-		LOG_ERROR(dpvt->pdrv, "unable to obtain device lock\n");
+	/* Terminal ID at our position, from the coupler's cached layout */
+	const uint16_t termid = dpvt->pdrv->LayoutTerminalID(dpvt->pterm->m_terminalIndex);
+	if (termid == 0 || termid != dpvt->pterm->m_terminalId) {
+		LOG_ERROR(dpvt->pdrv, "%s: %s != %u\n", devEK9000::ErrorToString(EK_ETERMIDMIS), pRecord->name, termid);
 		return 1;
 	}
 
-	/* Read terminal ID */
-	uint16_t termid = 0;
-	termid = dpvt->pdrv->ReadTerminalID(dpvt->pterm->m_terminalIndex);
+	/* Initialize from the current state of the coils, so the first write doesn't glitch the other channels. Without
+	 * a readback there's nothing to convert, and the record stays UDF until it's written */
+	uint32_t current = 0;
+	if (!dpvt->pdrv->ClaimCoils(get_coil_addr(pRecord, dpvt), get_nobt(pRecord), &current))
+		return 2;
+	pRecord->rval = current;
+	pRecord->rbv = current;
+	return 0;
+}
 
-	/* Verify terminal ID */
-	if (termid == 0 || termid != dpvt->pterm->m_terminalId) {
-		LOG_ERROR(dpvt->pdrv, "%s: %s != %u\n", devEK9000::ErrorToString(EK_ETERMIDMIS), pRecord->name, termid);
-		return 1;
+/* Called by the group once the commit carrying the record's value is done */
+template <class RecordT> static void EL20XX_GroupDone(dbCommon* record, int status) {
+	RecordT* pRecord = (RecordT*)record;
+	TerminalDpvt_t* dpvt = (TerminalDpvt_t*)pRecord->dpvt;
+	bool readback = false;
+	uint32_t rbv = 0;
+	if (status == EK_EOK) {
+		DeviceLock lock(dpvt->pdrv);
+		if ((readback = lock.valid()))
+			rbv = dpvt->pdrv->OutputCoils(get_coil_addr(pRecord, dpvt), get_nobt(pRecord));
+	}
+
+	dbScanLock(record);
+	if (readback && pRecord->rbv != rbv) {
+		pRecord->rbv = rbv;
+		db_post_events(pRecord, &pRecord->rbv, DBE_VALUE | DBE_LOG);
 	}
+	devEK9000OutputGroup::PostStatus(record, status);
+	dbScanUnlock(record);
+}
+
+/* Stage the record's value into its output group. The group's commit record does the actual write, RBV and the alarm
+ * follow once it's done */
+template <class RecordT> static long EL20XX_stage_record(RecordT* pRecord, TerminalDpvt_t* dpvt) {
+	dpvt->group->StageCoils(get_coil_addr(pRecord, dpvt), get_coil_bits(pRecord), get_nobt(pRecord),
+							(dbCommon*)pRecord, EL20XX_GroupDone<RecordT>);
+	pRecord->udf = FALSE;
 	return 0;
 }
 
 template <class T> static long EL20XX_write_record(void* precord) {
 	T* prec = (T*)precord;
+	TerminalDpvt_t* dpvt = (TerminalDpvt_t*)prec->dpvt;
+	if (util::DpvtValid(dpvt) && dpvt->group)
+		return EL20XX_stage_record(prec, dpvt);
 	if (prec->pact)
 		prec->pact = FALSE;
 	else {
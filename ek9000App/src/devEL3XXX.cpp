@@ -38,10 +38,12 @@
 
 static long EL3XXX_dev_report(int interest);
 static long EL3XXX_init(int after);
-static long EL3XXX_init_record(void* precord);
+template <class PdoT> static long EL3XXX_init_record(void* precord);
 static long EL3XXX_get_ioint_info(int cmd, void* prec, IOSCANPVT* iopvt);
 static long EL3XXX_linconv(void* precord, int after);
 
+struct EL331XInputPDO_t;
+
 static long EL3XXX_linconv(void*, int) {
 	return 0;
 }
@@ -54,36 +56,32 @@ static long EL3XXX_init(int) {
 	return 0;
 }
 
-static long EL3XXX_init_record(void* precord) {
+/**
+ * Terminals with a codec are picked up already decoded by the poll thread. Anything else is decoded by the record,
+ * reading one PdoT per channel, with channels 2 registers apart.
+ */
+template <class PdoT> static long EL3XXX_init_record(void* precord) {
 	aiRecord* pRecord = static_cast<aiRecord*>(precord);
-	pRecord->dpvt = util::allocDpvt();
-	TerminalDpvt_t* dpvt = static_cast<TerminalDpvt_t*>(pRecord->dpvt);
-	uint16_t termid = 0;
-
-	if (!util::setupCommonDpvt(pRecord, *dpvt)) {
-		LOG_ERROR(dpvt->pdrv, "Unable to setup dpvt for record %s\n", pRecord->name);
+	InputDpvt_t setup;
+	if (!util::setupCommonDpvt(pRecord, setup)) {
+		LOG_ERROR(setup.pdrv, "Unable to setup dpvt for record %s\n", pRecord->name);
 		return 1;
 	}
-
-	// Read and validate terminal ID
-	{
-		DeviceLock lock(dpvt->pdrv);
-
-		if (!lock.valid()) {
-			LOG_ERROR(dpvt->pdrv, "unable to obtain device lock\n");
-			return 1;
-		}
-
-		/* Check connection to terminal */
-		if (!dpvt->pterm->m_device->VerifyConnection()) {
-			LOG_ERROR(dpvt->pdrv, "%s\n", devEK9000::ErrorToString(EK_ENOCONN));
-			return 1;
-		}
-
-		/* Check that slave # is OK */
-		termid = dpvt->pdrv->ReadTerminalID(dpvt->pterm->m_terminalIndex);
+	InputDpvt_t* dpvt = setup.pdrv->CommitDpvt(setup);
+	pRecord->dpvt = dpvt;
+
+	const int offset = dpvt->pterm->m_inputStart + ((dpvt->channel - 1) * 2);
+	const int width = STRUCT_SIZE_TO_MODBUS_SIZE(sizeof(PdoT));
+	if (!dpvt->pdrv->ResolveChannel(dpvt->pterm, dpvt->channel, dpvt->input) &&
+		!dpvt->pdrv->ResolveInput(dpvt->pterm, INPUT_IMAGE_ANALOG, offset, width, dpvt->input)) {
+		LOG_ERROR(dpvt->pdrv, "%s: channel %d is out of range for EL%d\n", pRecord->name, dpvt->channel,
+				  dpvt->pterm->m_terminalId);
+		return 1;
 	}
 
+	// Look up the terminal ID in the rail layout, it was read once for the whole coupler
+	const uint16_t termid = dpvt->pdrv->LayoutTerminalID(dpvt->pterm->m_terminalIndex);
+
 	/* This is important; if the terminal id is different than what we want, report an error */
 	if (termid != dpvt->pterm->m_terminalId || termid == 0) {
 		LOG_ERROR(dpvt->pdrv, "%s: %s != %u\n", devEK9000::ErrorToString(EK_ETERMIDMIS), pRecord->name, termid);
@@ -93,6 +91,23 @@ static long EL3XXX_init_record(void* precord) {
 	return 0;
 }
 
+/* Pick up a channel decoded by the poll thread */
+static long EL3XXX_read_decoded(aiRecord* pRecord, InputDpvt_t* dpvt) {
+	DecodedInput_t input;
+	int status = dpvt->pdrv->ReadInput(dpvt->input, &input);
+	if (status != EK_EOK) {
+		recGblSetSevr(pRecord, COMM_ALARM, INVALID_ALARM);
+		LOG_WARNING(dpvt->pdrv, "%s\n", devEK9000::ErrorToString(status));
+		return 1;
+	}
+
+	pRecord->rval = input.value;
+	if (input.severity)
+		recGblSetSevr(pRecord, HW_LIMIT_ALARM, input.severity);
+	pRecord->udf = FALSE;
+	return 0;
+}
+
 //======================================================//
 //
 //	EL30XX Device support
@@ -112,7 +127,7 @@ struct devEL30XX_t {
 	6,
 	(DEVSUPFUN)EL3XXX_dev_report,
 	(DEVSUPFUN)EL3XXX_init,
-	(DEVSUPFUN)EL3XXX_init_record,
+	(DEVSUPFUN)EL3XXX_init_record<EL30XXStandardInputPDO_t>,
 	(DEVSUPFUN)EL3XXX_get_ioint_info,
 	(DEVSUPFUN)EL30XX_read_record,
 	(DEVSUPFUN)EL3XXX_linconv,
@@ -120,21 +135,7 @@ struct devEL30XX_t {
 
 epicsExportAddress(dset, devEL30XX);
 
-#pragma pack(1)
-// This PDO type applies to EL30XX, EL31XX and EL32XX. For 31XX and 32XX some align bits are interpreted differently.
-struct EL30XXStandardInputPDO_t {
-	uint8_t underrange : 1;
-	uint8_t overrange : 1;
-	uint8_t limit1 : 2;
-	uint8_t limit2 : 2;
-	uint8_t _r1 : 2; // First bit in this align is error for EL31XX
-	uint8_t _r2 : 6; // Last bit in this align is Sync error for EL31XX
-	uint8_t txpdo_state : 1;
-	uint8_t txpdo_toggle : 1;
-	int16_t value; // Must be signed to accommodate bipolar terminals. Unsigned representation still defines range as
-				   // 0-32767, so this is safe.
-};
-#pragma pack()
+// EL30XXStandardInputPDO_t is in terminal_codec.h
 
 // Associate our PDO struct with the terminals
 DEFINE_SINGLE_CHANNEL_INPUT_PDO(EL30XXStandardInputPDO_t, EL3001);
@@ -197,13 +198,16 @@ static long EL30XX_read_record(void* prec) {
 	/*static_assert(sizeof(buf) <= sizeof(EL30XXStandardInputPDO_t),
 				  "SEL30XXStandardInputPDO is greater than 4 bytes in size, contact the author about this error!");
 		*/
-	TerminalDpvt_t* dpvt = static_cast<TerminalDpvt_t*>(pRecord->dpvt);
+	InputDpvt_t* dpvt = static_cast<InputDpvt_t*>(pRecord->dpvt);
 
 	/* Check for invalid */
 	if (!util::DpvtValid(dpvt))
 		return 1;
 
-	int status = dpvt->pterm->getEK9000IO(READ_ANALOG, dpvt->pterm->m_inputStart + ((dpvt->channel - 1) * 2), buf, 2);
+	if (dpvt->input.image == INPUT_IMAGE_DECODED)
+		return EL3XXX_read_decoded(pRecord, dpvt);
+
+	int status = dpvt->pdrv->ReadInput(dpvt->input, buf);
 	if (status == EK_EOK) {
 		spdo = reinterpret_cast<EL30XXStandardInputPDO_t*>(buf);
 		pRecord->rval = spdo->value;
@@ -243,29 +247,14 @@ struct devEL36XX_t {
 	6,
 	(DEVSUPFUN)EL3XXX_dev_report,
 	(DEVSUPFUN)EL3XXX_init,
-	(DEVSUPFUN)EL3XXX_init_record,
+	(DEVSUPFUN)EL3XXX_init_record<EL36XXInputPDO_t>,
 	(DEVSUPFUN)EL3XXX_get_ioint_info,
 	(DEVSUPFUN)EL36XX_read_record,
 	(DEVSUPFUN)EL3XXX_linconv,
 };
 epicsExportAddress(dset, devEL36XX);
 
-#pragma pack(1)
-struct EL36XXInputPDO_t {
-	struct {
-		uint8_t underrange : 1;
-		uint8_t overrange : 1;
-		uint8_t limit1 : 1;
-		uint8_t limit2 : 1;
-		uint8_t _r0 : 4;
-	} status;
-	uint8_t _r1; // Corresponds to some data we don't care about
-	uint32_t inp;
-	uint8_t _r2 : 4;
-	uint8_t sai_mode : 4;
-	uint8_t sai_range;
-};
-#pragma pack()
+// EL36XXInputPDO_t is in terminal_codec.h
 
 DEFINE_SINGLE_CHANNEL_INPUT_PDO(EL36XXInputPDO_t, EL3681);
 DEFINE_DUMMY_OUTPUT_PDO_CHECK(EL3681); // Currently no output support for EL3681 outputs. This is a TODO!
@@ -277,15 +266,16 @@ static long EL36XX_read_record(void* prec) {
 	/*static_assert(sizeof(EL36XXInputPDO_t) <= sizeof(buf),
 				  "SEL36XXInput is greater than 3 bytes in size! Contact the author regarding this error.");
 		*/
-	TerminalDpvt_t* dpvt = static_cast<TerminalDpvt_t*>(pRecord->dpvt);
+	InputDpvt_t* dpvt = static_cast<InputDpvt_t*>(pRecord->dpvt);
 
 	/* Check for invalid */
 	if (!util::DpvtValid(dpvt))
 		return 1;
 
-	/* Lock mutex */
-	int status = dpvt->pterm->getEK9000IO(READ_ANALOG, dpvt->pterm->m_inputStart + ((dpvt->channel - 1) * 2), buf,
-										  ArraySize(buf));
+	if (dpvt->input.image == INPUT_IMAGE_DECODED)
+		return EL3XXX_read_decoded(pRecord, dpvt);
+
+	int status = dpvt->pdrv->ReadInput(dpvt->input, buf);
 	if (status == EK_EOK) {
 		pdo = reinterpret_cast<EL36XXInputPDO_t*>(buf);
 		pRecord->rval = pdo->inp;
@@ -324,7 +314,7 @@ struct devEL331X_t {
 	6,
 	(DEVSUPFUN)EL3XXX_dev_report,
 	(DEVSUPFUN)EL3XXX_init,
-	(DEVSUPFUN)EL3XXX_init_record,
+	(DEVSUPFUN)EL3XXX_init_record<EL331XInputPDO_t>,
 	(DEVSUPFUN)EL3XXX_get_ioint_info,
 	(DEVSUPFUN)EL331X_read_record,
 	(DEVSUPFUN)EL3XXX_linconv,
@@ -365,14 +355,16 @@ static long EL331X_read_record(void* prec) {
 
 	uint16_t buf[2];
 	EL331XInputPDO_t* pdo = NULL;
-	TerminalDpvt_t* dpvt = static_cast<TerminalDpvt_t*>(pRecord->dpvt);
+	InputDpvt_t* dpvt = static_cast<InputDpvt_t*>(pRecord->dpvt);
 
 	/* Check for invalid */
 	if (!util::DpvtValid(dpvt))
 		return 1;
 
-	int loc = dpvt->pterm->m_inputStart + ((dpvt->channel - 1) * 2);
-	int status = dpvt->pterm->getEK9000IO(READ_ANALOG, loc, buf, 2);
+	if (dpvt->input.image == INPUT_IMAGE_DECODED)
+		return EL3XXX_read_decoded(pRecord, dpvt);
+
+	int status = dpvt->pdrv->ReadInput(dpvt->input, buf);
 	if (status == EK_EOK) {
 		pdo = reinterpret_cast<EL331XInputPDO_t*>(buf);
 		pRecord->rval = pdo->value;
@@ -22,6 +22,7 @@
 #include <aoRecord.h>
 #include <callback.h>
 #include <recGbl.h>
+#include <dbEvent.h>
 
 #include <drvModbusAsyn.h>
 
@@ -30,6 +31,7 @@
 
 #include "ekUtil.h"
 #include "devEK9000.h"
+#include "ekOutputGroup.h"
 
 #include "terminal_types.g.h"
 
@@ -40,7 +42,9 @@ static long EL40XX_write_record(void* record);
 static long EL40XX_linconv(void* precord, int after);
 
 struct EL40XXDpvt_t : public TerminalDpvt_t {
-	bool sign = false;
+	EL40XXDpvt_t() : sign(false) {}
+
+	bool sign;
 };
 
 struct devEL40XX_t {
@@ -87,16 +91,6 @@ DEFINE_SINGLE_CHANNEL_OUTPUT_PDO(uint16_t, EL4122);
 DEFINE_SINGLE_CHANNEL_OUTPUT_PDO(int16_t, EL4132); // EL413X support negative output values.
 DEFINE_SINGLE_CHANNEL_OUTPUT_PDO(int16_t, EL4134);
 
-static bool isTerminalSigned(int id) {
-	if (id <= 4039 && id >= 4030)
-		return true; // EL403X
-	if (id <= 4119 && id >= 4110)
-		return true; // EL411X
-	if (id <= 4139 && id >= 4130)
-		return true; // EL413X
-	return false;
-}
-
 static void EL40XX_WriteCallback(CALLBACK* callback) {
 	void* record = NULL;
 	callbackGetUser(record, callback);
@@ -158,30 +152,17 @@ static long EL40XX_init(int) {
 
 static long EL40XX_init_record(void* record) {
 	aoRecord* pRecord = (aoRecord*)record;
-	pRecord->dpvt = util::allocDpvt();
-	EL40XXDpvt_t* dpvt = (EL40XXDpvt_t*)pRecord->dpvt;
-	uint16_t termid = 0;
-
 	/* Verify terminal */
-	if (!util::setupCommonDpvt(pRecord, *dpvt)) {
-		LOG_ERROR(dpvt->pdrv, "Unable to find terminal for record %s\n", pRecord->name);
+	EL40XXDpvt_t setup;
+	if (!util::setupCommonDpvt(pRecord, setup)) {
+		LOG_ERROR(setup.pdrv, "Unable to find terminal for record %s\n", pRecord->name);
 		return 1;
 	}
+	EL40XXDpvt_t* dpvt = setup.pdrv->CommitDpvt(setup);
+	pRecord->dpvt = dpvt;
 
-	// Validate terminal ID
-	{
-		DeviceLock lock(dpvt->pdrv);
-
-		/* Verify it's error free */
-		if (!lock.valid()) {
-			LOG_ERROR(dpvt->pdrv, "unable to obtain device lock\n");
-			return 1;
-		}
-
-		/* Read terminal ID */
-		termid = dpvt->pterm->m_device->ReadTerminalID(dpvt->pterm->m_terminalIndex);
-	}
-
+	/* Terminal ID from the rail layout */
+	const uint16_t termid = dpvt->pdrv->LayoutTerminalID(dpvt->pterm->m_terminalIndex);
 	/* Verify terminal ID */
 	if (termid != dpvt->pterm->m_terminalId || termid == 0) {
 		LOG_ERROR(dpvt->pdrv, "%s: %s != %u\n", devEK9000::ErrorToString(EK_ETERMIDMIS), pRecord->name, termid);
@@ -189,13 +170,53 @@ static long EL40XX_init_record(void* record) {
 	}
 
 	/* Determine if it's signed or not */
-	dpvt->sign = isTerminalSigned(termid);
-
+	dpvt->sign = util::isAnalogOutputSigned(termid);
+
+	/* Start from the value the terminal is currently outputting. Returning 0 has the record convert it to VAL, 2
+	 * leaves VAL alone and UDF set when there's no readback */
+	uint16_t raw = 0;
+	if (!dpvt->pdrv->ClaimRegisters(dpvt->pterm->m_outputStart + (dpvt->channel - 1), 1, &raw))
+		return 2;
+	pRecord->rval = dpvt->sign ? (epicsInt32)(int16_t)raw : (epicsInt32)raw;
+	pRecord->rbv = pRecord->rval;
 	return 0;
 }
 
+/* Called by the group once the commit carrying the record's value is done */
+static void EL40XX_GroupDone(dbCommon* record, int status) {
+	aoRecord* pRecord = (aoRecord*)record;
+	EL40XXDpvt_t* dpvt = (EL40XXDpvt_t*)pRecord->dpvt;
+	bool readback = false;
+	uint16_t raw = 0;
+	if (status == EK_EOK) {
+		DeviceLock lock(dpvt->pdrv);
+		if ((readback = lock.valid()))
+			raw = dpvt->pdrv->OutputRegister(dpvt->pterm->m_outputStart + (dpvt->channel - 1));
+	}
+
+	dbScanLock(record);
+	const epicsInt32 rbv = dpvt->sign ? (epicsInt32)(int16_t)raw : (epicsInt32)raw;
+	if (readback && pRecord->rbv != rbv) {
+		pRecord->rbv = rbv;
+		db_post_events(pRecord, &pRecord->rbv, DBE_VALUE | DBE_LOG);
+	}
+	devEK9000OutputGroup::PostStatus(record, status);
+	dbScanUnlock(record);
+}
+
 static long EL40XX_write_record(void* record) {
 	struct aoRecord* prec = (struct aoRecord*)record;
+	EL40XXDpvt_t* dpvt = (EL40XXDpvt_t*)prec->dpvt;
+
+	/* Grouped outputs are only staged here, the group's commit record writes them out */
+	if (util::DpvtValid(dpvt) && dpvt->group) {
+		uint16_t val = dpvt->sign ? (uint16_t)(int16_t)prec->rval : (uint16_t)prec->rval;
+		dpvt->group->StageRegister(dpvt->pterm->m_outputStart + (dpvt->channel - 1), val, (dbCommon*)prec,
+								   EL40XX_GroupDone);
+		prec->udf = FALSE;
+		return 0;
+	}
+
 	if (prec->pact)
 		prec->pact = FALSE;
 	else {
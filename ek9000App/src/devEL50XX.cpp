@@ -14,46 +14,9 @@
 
 #include "terminal_types.g.h"
 
-// PDO definitions
-#pragma pack(1)
-struct EL5001Status_t {
-	uint8_t data_error : 1;
-	uint8_t frame_error : 1;
-	uint8_t power_fail : 1;
-	uint8_t data_mismatch : 1;
-	uint8_t _r1 : 1;
-	uint8_t sync_err : 1;
-	uint8_t txpdo_state : 1;
-	uint8_t txpdo_toggle : 1;
-};
-
+// PDO definitions and codecs are in terminal_codec.h
 STATIC_ASSERT(sizeof(EL5001Status_t) == sizeof(uint8_t));
 
-/* Input data from an el5001 terminal. el5001 from fw11 onwards also supports the EL5002Input_t PDO type  */
-struct EL5001Input_t {
-	union {
-		uint8_t status_byte;
-		EL5001Status_t data;
-	};
-	uint32_t encoder_value;
-	// This is additional padding to keep EL5001Input_t a multiple of 2. The ek9000 rounds up when mapping terminals to
-	// input/holding register space
-	// meaning, if a PDO is 3 bytes, it will be mapped as if it were 4 bytes (2 registers), 5 bytes as if it were 6 and
-	// so on.
-	uint8_t _pad;
-};
-
-/* Input data from an el5002 slave, given it has the extended status byte enabled */
-struct EL5002Input_t {
-	uint8_t data_error : 1;
-	uint8_t frame_error : 1;
-	uint8_t power_fail : 1;
-	uint8_t _r1 : 5;
-	uint8_t _r2;
-	uint32_t encoder_value;
-};
-#pragma pack()
-
 DEFINE_SINGLE_CHANNEL_INPUT_PDO(EL5001Input_t, EL5001);
 DEFINE_SINGLE_CHANNEL_INPUT_PDO(EL5002Input_t, EL5002);
 
@@ -73,35 +36,25 @@ static long el50xx_init(int) {
 
 static long el50xx_init_record(void* precord) {
 	longinRecord* record = static_cast<longinRecord*>(precord);
-	record->dpvt = util::allocDpvt();
-	TerminalDpvt_t* dpvt = static_cast<TerminalDpvt_t*>(record->dpvt);
-	uint16_t termid = 0;
-
 	/* Get the terminal */
-	if (!util::setupCommonDpvt(record, *dpvt)) {
-		LOG_ERROR(dpvt->pdrv, "Unable to setup dpvt for %s\n", record->name);
+	InputDpvt_t setup;
+	if (!util::setupCommonDpvt(record, setup)) {
+		LOG_ERROR(setup.pdrv, "Unable to setup dpvt for %s\n", record->name);
 		return 1;
 	}
+	InputDpvt_t* dpvt = setup.pdrv->CommitDpvt(setup);
+	record->dpvt = dpvt;
 
-	// Validate terminal ID
-	{
-		DeviceLock lock(dpvt->pdrv);
-
-		if (!lock.valid()) {
-			LOG_ERROR(dpvt->pdrv, "unable to obtain device lock\n");
-			return 1;
-		}
-
-		/* Check connection to terminal */
-		if (!dpvt->pdrv->VerifyConnection()) {
-			LOG_ERROR(dpvt->pdrv, "%s\n", devEK9000::ErrorToString(EK_ENOCONN));
-			return 1;
-		}
-
-		/* Check that slave # is OK */
-		termid = dpvt->pterm->m_device->ReadTerminalID(dpvt->pterm->m_terminalIndex);
+	/* Encoder channels are decoded by the poll thread, using the terminal's generated codec */
+	if (!dpvt->pdrv->ResolveChannel(dpvt->pterm, dpvt->channel, dpvt->input)) {
+		LOG_ERROR(dpvt->pdrv, "%s: channel %d is out of range for EL%d, or it has no codec\n", record->name,
+				  dpvt->channel, dpvt->pterm->m_terminalId);
+		return 1;
 	}
 
+	/* The coupler read the rail layout at init, no need to go to the device */
+	const uint16_t termid = dpvt->pdrv->LayoutTerminalID(dpvt->pterm->m_terminalIndex);
+
 	if (termid != dpvt->pterm->m_terminalId || termid == 0) {
 		LOG_ERROR(dpvt->pdrv, "%s: %s != %u\n", devEK9000::ErrorToString(EK_ETERMIDMIS), record->name, termid);
 		return 1;
@@ -146,18 +99,16 @@ extern "C"
 
 static long el50xx_read_record(void* prec) {
 	longinRecord* precord = static_cast<longinRecord*>(prec);
-	TerminalDpvt_t* dpvt = static_cast<TerminalDpvt_t*>(precord->dpvt);
+	InputDpvt_t* dpvt = static_cast<InputDpvt_t*>(precord->dpvt);
 
 	if (!util::DpvtValid(dpvt))
 		return 1;
 
-	/* Read into a buffer that's plenty big enough for any terminal type */
-	union {
-		EL5001Input_t el5001;
-		EL5002Input_t el5002;
-	} data;
-	int status = dpvt->pterm->getEK9000IO(READ_ANALOG, dpvt->pterm->m_inputStart, reinterpret_cast<uint16_t*>(&data),
-										  dpvt->pterm->m_inputSize);
+	/* Value and alarm state come pre-decoded: data/sync errors are INVALID, frame errors MAJOR, warnings MINOR */
+	DecodedInput_t input;
+	int status = dpvt->pdrv->ReadInput(dpvt->input, &input);
+
+	precord->udf = FALSE;
 
 	if (status != EK_EOK) {
 		recGblSetSevr(precord, COMM_ALARM, INVALID_ALARM);
@@ -165,40 +116,12 @@ static long el50xx_read_record(void* prec) {
 		return 1;
 	}
 
-	/* Handle individual terminal pdo types */
-	switch (dpvt->terminalType) {
-		case 5001:
-			{
-				EL5001Input_t& input = data.el5001;
-				if (input.data.data_error || input.data.sync_err)
-					recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
-				if (input.data.frame_error)
-					recGblSetSevr(precord, READ_ALARM, MAJOR_ALARM);
-				precord->val = input.encoder_value;
-				break;
-			}
-		case 5002:
-			{
-				EL5002Input_t& input = data.el5002;
-				if (input.data_error)
-					recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
-				if (input.frame_error)
-					recGblSetSevr(precord, COMM_ALARM, MAJOR_ALARM);
-				precord->val = input.encoder_value;
-				break;
-			}
-		default:
-			{
-				/* Raise invalid alarm if we don't have a tid */
-				recGblSetSevr(precord, READ_ALARM, INVALID_ALARM);
-			}
-	}
-	precord->udf = FALSE;
+	precord->val = input.value;
+	if (input.severity)
+		recGblSetSevr(precord, READ_ALARM, input.severity);
 	return 0;
 }
 
-static long el5042_read_record(void* prec);
-
 struct devEL5042_t {
 	long number;
 	DEVSUPFUN dev_report;
@@ -212,7 +135,7 @@ struct devEL5042_t {
 	(DEVSUPFUN)el50xx_init,
 	el50xx_init_record,
 	(DEVSUPFUN)el50xx_get_ioint_info,
-	el5042_read_record,
+	el50xx_read_record,
 };
 
 extern "C"
@@ -220,63 +143,6 @@ extern "C"
 	epicsExportAddress(dset, devEL5042);
 }
 
-#pragma pack(1)
-struct EL5042InputPDO_t {
-	uint8_t warning : 1;
-	uint8_t error : 1;
-	uint8_t ready : 1;
-	uint8_t _r1 : 5;
-	uint8_t _r2 : 4;
-	uint8_t diag : 1;
-	uint8_t txpdo_state : 1;
-	uint8_t input_cycle_counter : 2;
-	uint32_t position;
-};
-#pragma pack()
-
 DEFINE_SINGLE_CHANNEL_INPUT_PDO(EL5042InputPDO_t, EL5042);
 
-/*
--------------------------------------
-Called to read the specified record
--------------------------------------
-*/
-static long el5042_read_record(void* prec) {
-	longinRecord* precord = static_cast<longinRecord*>(prec);
-	TerminalDpvt_t* dpvt;
-	EL5042InputPDO_t* pdo;
-
-	dpvt = static_cast<TerminalDpvt_t*>(precord->dpvt);
-	if (!util::DpvtValid(dpvt))
-		return 1;
-
-	/* Read the stuff */
-	uint16_t buf[32];
-	uint16_t loc = dpvt->pterm->m_inputStart + ((dpvt->channel - 1) * 3);
-	int status = dpvt->pterm->getEK9000IO(READ_ANALOG, loc, buf, STRUCT_SIZE_TO_MODBUS_SIZE(sizeof(EL5042InputPDO_t)));
-
-	precord->udf = FALSE;
-
-	if (status != EK_EOK) {
-		recGblSetSevr(precord, COMM_ALARM, INVALID_ALARM);
-		LOG_WARNING(dpvt->pdrv, "%s\n", devEK9000::ErrorToString(status));
-		return 1;
-	}
-
-	/* Cast it to our pdo type */
-	pdo = reinterpret_cast<EL5042InputPDO_t*>(buf);
-
-	/* Update our params */
-	precord->val = pdo->position;
 
-	/* Check for any read alarms */
-	if (pdo->warning) {
-		recGblSetSevr(precord, READ_ALARM, MINOR_ALARM);
-	}
-
-	/* Check for any errors */
-	if (pdo->error) {
-		recGblSetSevr(precord, READ_ALARM, MAJOR_ALARM);
-	}
-	return 0;
-}
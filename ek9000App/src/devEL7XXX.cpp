@@ -408,6 +408,10 @@ asynStatus el70x7Axis::poll(bool* moving) {
 		return asynSuccess;
 	}
 
+	/* Coupler was mapped offline and the rail hasn't been confirmed yet */
+	if (!this->pcoupler->TerminalIOEnabled())
+		return asynSuccess;
+
 	this->lock();
 	MOTOR_TRACE();
 	/* This will read params from the motor controller */
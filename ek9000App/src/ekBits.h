@@ -0,0 +1,150 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekBits.h
+// Purpose: Helpers for bit-packed coil/discrete input
+//  images
+//======================================================//
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Packed images use the modbus FC1/FC2/FC15 layout: bit n lives in byte n/8 at bit n%8, so an image can be sent or
+ * received without any conversion. Accesses load the few bytes that cover the requested bits into one 64-bit word and
+ * shift/mask that, so extracting or inserting up to 32 bits costs the same as a single bit.
+ */
+namespace bits {
+
+/* Number of bytes needed to hold count bits */
+inline size_t PackedSize(size_t count) {
+	return (count + 7) / 8;
+}
+
+inline uint32_t Mask(unsigned count) {
+	return count >= 32 ? 0xFFFFFFFFu : (1u << count) - 1;
+}
+
+inline bool TestBit(const uint8_t* packed, size_t bit) {
+	return (packed[bit >> 3] >> (bit & 7)) & 1;
+}
+
+/* Bytes covering [bit, bit + count). count <= 32, so at most 5 */
+inline unsigned SpanBytes(size_t bit, unsigned count) {
+	return ((bit & 7) + count + 7) / 8;
+}
+
+/**
+ * Extract count (<= 32) bits starting at bit. The first bit ends up in bit 0 of the result.
+ */
+inline uint32_t GetBits(const uint8_t* packed, size_t bit, unsigned count) {
+	if (!count)
+		return 0;
+	const uint8_t* p = packed + (bit >> 3);
+	uint64_t word = 0;
+	for (unsigned i = 0, n = SpanBytes(bit, count); i < n; ++i)
+		word |= uint64_t(p[i]) << (i * 8);
+	return uint32_t(word >> (bit & 7)) & Mask(count);
+}
+
+/**
+ * Replace count (<= 32) bits starting at bit with the low bits of value, leaving the neighbouring bits alone
+ */
+inline void SetBits(uint8_t* packed, size_t bit, unsigned count, uint32_t value) {
+	if (!count)
+		return;
+	uint8_t* p = packed + (bit >> 3);
+	const unsigned shift = bit & 7, n = SpanBytes(bit, count);
+	uint64_t word = 0;
+	for (unsigned i = 0; i < n; ++i)
+		word |= uint64_t(p[i]) << (i * 8);
+	const uint64_t mask = uint64_t(Mask(count)) << shift;
+	word = (word & ~mask) | ((uint64_t(value) << shift) & mask);
+	for (unsigned i = 0; i < n; ++i)
+		p[i] = uint8_t(word >> (i * 8));
+}
+
+/* Copy count bits between two packed images, 32 bits at a time */
+inline void CopyBits(uint8_t* dst, size_t dstBit, const uint8_t* src, size_t srcBit, size_t count) {
+	for (size_t done = 0; done < count; done += 32) {
+		const unsigned n = count - done < 32 ? unsigned(count - done) : 32;
+		SetBits(dst, dstBit + done, n, GetBits(src, srcBit + done, n));
+	}
+}
+
+inline unsigned PopCount(uint32_t v) {
+	v = v - ((v >> 1) & 0x55555555u);
+	v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+	return (((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+}
+
+/**
+ * Find the end of the run of set bits in mask that starts at bit, stopping at limit
+ */
+inline size_t RunEnd(const uint8_t* mask, size_t bit, size_t limit) {
+	while (bit < limit) {
+		const unsigned n = limit - bit < 32 ? unsigned(limit - bit) : 32;
+		const uint32_t word = GetBits(mask, bit, n);
+		if (word != Mask(n)) {
+			/* First clear bit in this word */
+			uint32_t clear = ~word & Mask(n);
+			return bit + PopCount((clear & (~clear + 1)) - 1);
+		}
+		bit += n;
+	}
+	return limit;
+}
+
+/**
+ * Find the first set bit in mask at or after bit, or limit if there is none
+ */
+inline size_t NextSet(const uint8_t* mask, size_t bit, size_t limit) {
+	while (bit < limit) {
+		const unsigned n = limit - bit < 32 ? unsigned(limit - bit) : 32;
+		const uint32_t word = GetBits(mask, bit, n);
+		if (word)
+			return bit + PopCount((word & (~word + 1)) - 1);
+		bit += n;
+	}
+	return limit;
+}
+
+/**
+ * Expand count bits starting at srcBit into one word per bit (0 or 1), the layout drvModbusAsyn uses. Byte-aligned
+ * sources are expanded 8 words per byte with SSE2 where available.
+ */
+inline void UnpackWords(uint16_t* dst, const uint8_t* src, size_t srcBit, size_t count) {
+	size_t i = 0;
+#if defined(__SSE2__)
+	if ((srcBit & 7) == 0) {
+		const uint8_t* p = src + (srcBit >> 3);
+		const __m128i select = _mm_set_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+		for (; i + 8 <= count; i += 8) {
+			/* Broadcast the byte, isolate one bit per lane and turn set lanes into 1 */
+			const __m128i byte = _mm_set1_epi16(p[i >> 3]);
+			const __m128i set = _mm_cmpeq_epi16(_mm_and_si128(byte, select), select);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_srli_epi16(set, 15));
+		}
+	}
+#endif
+	for (; i < count; i += 32) {
+		const unsigned n = count - i < 32 ? unsigned(count - i) : 32;
+		const uint32_t word = GetBits(src, srcBit + i, n);
+		for (unsigned b = 0; b < n; ++b)
+			dst[i + b] = (word >> b) & 1;
+	}
+}
+
+} // namespace bits
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekLayoutCache.cpp
+// Purpose: Reading and writing the rail layout cache
+//======================================================//
+
+#include <epicsPrint.h>
+#include <epicsStdio.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "ekLayoutCache.h"
+
+/**
+ * The file is a flat array of host order uint16s:
+ *   magic[2] version serial railLen termCount analogIn analogOut coilIn coilOut introspection
+ *   rail[railLen]
+ *   {id inputStart outputStart inputSize outputSize source}[termCount]
+ *   checksum[2] (FNV-1a over everything before it)
+ * A file written on a machine of the other endianness fails the magic check and is ignored.
+ */
+static const uint16_t CACHE_MAGIC0 = 0x4B45; /* "EK" */
+static const uint16_t CACHE_MAGIC1 = 0x4C39; /* "9L" */
+static const uint16_t CACHE_VERSION = 2;
+static const size_t CACHE_HEADER_WORDS = 11;
+static const size_t CACHE_TERM_WORDS = 6;
+
+static uint32_t Checksum(const uint16_t* words, size_t count) {
+	const uint8_t* p = reinterpret_cast<const uint8_t*>(words);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < count * sizeof(uint16_t); ++i)
+		hash = (hash ^ p[i]) * 16777619u;
+	return hash;
+}
+
+/* Move from over to, replacing it. rename() refuses to replace an existing file on Windows */
+static bool ReplaceCacheFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+std::string LayoutCachePath(const std::string& dir, uint16_t serial) {
+	char name[32];
+	epicsSnprintf(name, sizeof(name), "ek9000-%u.layout", serial);
+	std::string path = dir;
+	if (!path.empty() && path[path.size() - 1] != '/')
+		path += '/';
+	return path + name;
+}
+
+bool LoadLayoutCache(const std::string& path, CachedLayout_t& out) {
+	FILE* fp = fopen(path.c_str(), "rb");
+	if (!fp)
+		return false;
+	std::vector<uint16_t> words;
+	uint16_t buf[256];
+	size_t n;
+	while ((n = fread(buf, sizeof(uint16_t), 256, fp)) > 0)
+		words.insert(words.end(), buf, buf + n);
+	fclose(fp);
+
+	if (words.size() < CACHE_HEADER_WORDS + 2 || words[0] != CACHE_MAGIC0 || words[1] != CACHE_MAGIC1 ||
+		words[2] != CACHE_VERSION)
+		return false;
+
+	const size_t railLen = words[4], termCount = words[5];
+	if (words.size() != CACHE_HEADER_WORDS + railLen + termCount * CACHE_TERM_WORDS + 2)
+		return false;
+
+	const size_t body = words.size() - 2;
+	const uint32_t sum = Checksum(&words[0], body);
+	if (words[body] != (sum & 0xFFFF) || words[body + 1] != (sum >> 16)) {
+		epicsPrintf("%s: checksum mismatch, ignoring it\n", path.c_str());
+		return false;
+	}
+
+	out.serial = words[3];
+	out.analogIn = words[6];
+	out.analogOut = words[7];
+	out.coilIn = words[8];
+	out.coilOut = words[9];
+	out.introspection = words[10] != 0;
+	out.rail.assign(words.begin() + CACHE_HEADER_WORDS, words.begin() + CACHE_HEADER_WORDS + railLen);
+	out.terms.resize(termCount);
+	const uint16_t* t = &words[CACHE_HEADER_WORDS + railLen];
+	for (size_t i = 0; i < termCount; ++i, t += CACHE_TERM_WORDS) {
+		out.terms[i].id = t[0];
+		out.terms[i].inputStart = t[1];
+		out.terms[i].outputStart = t[2];
+		out.terms[i].inputSize = t[3];
+		out.terms[i].outputSize = t[4];
+		out.terms[i].source = t[5];
+	}
+	return true;
+}
+
+bool StoreLayoutCache(const std::string& path, const CachedLayout_t& layout) {
+	std::vector<uint16_t> words;
+	words.reserve(CACHE_HEADER_WORDS + layout.rail.size() + layout.terms.size() * CACHE_TERM_WORDS + 2);
+	words.push_back(CACHE_MAGIC0);
+	words.push_back(CACHE_MAGIC1);
+	words.push_back(CACHE_VERSION);
+	words.push_back(layout.serial);
+	words.push_back(layout.rail.size());
+	words.push_back(layout.terms.size());
+	words.push_back(layout.analogIn);
+	words.push_back(layout.analogOut);
+	words.push_back(layout.coilIn);
+	words.push_back(layout.coilOut);
+	words.push_back(layout.introspection);
+	words.insert(words.end(), layout.rail.begin(), layout.rail.end());
+	for (size_t i = 0; i < layout.terms.size(); ++i) {
+		const CachedTerminal_t& t = layout.terms[i];
+		words.push_back(t.id);
+		words.push_back(t.inputStart);
+		words.push_back(t.outputStart);
+		words.push_back(t.inputSize);
+		words.push_back(t.outputSize);
+		words.push_back(t.source);
+	}
+	const uint32_t sum = Checksum(&words[0], words.size());
+	words.push_back(sum & 0xFFFF);
+	words.push_back(sum >> 16);
+
+	/* Write next to it and rename, so a crash never leaves a torn cache behind */
+	const std::string tmp = path + ".tmp";
+	FILE* fp = fopen(tmp.c_str(), "wb");
+	if (!fp) {
+		epicsPrintf("%s: unable to write layout cache: %s\n", tmp.c_str(), strerror(errno));
+		return false;
+	}
+	const bool ok = fwrite(&words[0], sizeof(uint16_t), words.size(), fp) == words.size();
+	if (fclose(fp) != 0 || !ok || !ReplaceCacheFile(tmp, path)) {
+		epicsPrintf("%s: unable to write layout cache: %s\n", path.c_str(), strerror(errno));
+		remove(tmp.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekLayoutCache.h
+// Purpose: On-disk cache of a coupler's rail layout and
+//  process image mapping, keyed by serial number
+//======================================================//
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Where a terminal's sizes came from */
+enum ESizeSource {
+	SIZE_SOURCE_REGISTRY, /* terminals.json */
+	SIZE_SOURCE_PDO		  /* Read from its PDO assignment, see ek9000SetPdoIntrospection */
+};
+
+/* Where one terminal landed in the process image */
+struct CachedTerminal_t {
+	uint16_t id;
+	uint16_t inputStart;
+	uint16_t outputStart;
+	uint16_t inputSize;
+	uint16_t outputSize;
+	uint16_t source; /* ESizeSource */
+};
+
+/**
+ * A validated rail layout and the mapping computed from it. The extents are the ends of each image as the mapping
+ * left them: input registers from 0, output registers from EK9000_OUTPUT_REG_START, coils from 1.
+ */
+struct CachedLayout_t {
+	uint16_t serial;
+	uint16_t analogIn;
+	uint16_t analogOut;
+	uint16_t coilIn;
+	uint16_t coilOut;
+	bool introspection; /* Mapped with PDO introspection on */
+	std::vector<uint16_t> rail;			  /* Coupler ID followed by the terminal IDs, as read from 0x6000 */
+	std::vector<CachedTerminal_t> terms; /* One per configured terminal, in rail order */
+};
+
+/* Cache file for the coupler with the given serial number */
+std::string LayoutCachePath(const std::string& dir, uint16_t serial);
+
+/* Read and check a cache file. Returns false if it's missing, truncated, corrupt or from another version */
+bool LoadLayoutCache(const std::string& path, CachedLayout_t& out);
+
+/* Write a cache file, replacing any previous one atomically */
+bool StoreLayoutCache(const std::string& path, const CachedLayout_t& layout);
@@ -0,0 +1,355 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekOutputGroup.cpp
+// Purpose: Output groups and the commit record device
+//  support (EK9000GroupCommit)
+//======================================================//
+
+/* EPICS includes */
+#include <epicsExport.h>
+#include <epicsPrint.h>
+#include <devSup.h>
+#include <alarm.h>
+#include <boRecord.h>
+#include <callback.h>
+#include <recGbl.h>
+#include <dbScan.h>
+#include <dbEvent.h>
+
+#include <drvModbusAsyn.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "devEK9000.h"
+#include "ekBits.h"
+#include "ekOutputGroup.h"
+
+//==========================================================//
+// class devEK9000OutputGroup
+//==========================================================//
+
+devEK9000OutputGroup::devEK9000OutputGroup(devEK9000* device, const char* name)
+	: m_commits(0), m_lastWrites(0), m_lastStatus(EK_EOK), m_name(name), m_device(device) {
+	m_mutex = epicsMutexMustCreate();
+	memset(&m_lastCommit, 0, sizeof(m_lastCommit));
+}
+
+devEK9000OutputGroup::~devEK9000OutputGroup() {
+	epicsMutexDestroy(m_mutex);
+}
+
+void devEK9000OutputGroup::StageCoils(uint16_t addr, uint32_t values, uint16_t count, dbCommon* record,
+									  DoneFn_t done) {
+	epicsMutexMustLock(m_mutex);
+	/* Sized lazily, the coil count isn't known until the coupler's mapping has been computed */
+	if (m_coils.size() < bits::PackedSize(size_t(addr) + count)) {
+		m_coils.resize(bits::PackedSize(std::max(m_device->m_dout_count, size_t(addr) + count)), 0);
+		m_coilMask.resize(m_coils.size(), 0);
+	}
+	bits::SetBits(&m_coils[0], addr, count, values);
+	bits::SetBits(&m_coilMask[0], addr, count, 0xFFFFFFFFu);
+	AddMember(record, done, true, addr, count);
+	epicsMutexUnlock(m_mutex);
+}
+
+void devEK9000OutputGroup::StageRegister(uint16_t addr, uint16_t value, dbCommon* record, DoneFn_t done) {
+	epicsMutexMustLock(m_mutex);
+	m_registers[addr] = value;
+	AddMember(record, done, false, addr, 1);
+	epicsMutexUnlock(m_mutex);
+}
+
+/* Caller holds m_mutex. A record already waiting on the next commit keeps its entry, it stages the same outputs */
+void devEK9000OutputGroup::AddMember(dbCommon* record, DoneFn_t done, bool coils, uint16_t addr, uint16_t count) {
+	if (!record || !done)
+		return;
+	Member_t member;
+	member.done = done;
+	member.coils = coils;
+	member.addr = addr;
+	member.count = count;
+	m_members.insert(std::make_pair(record, member));
+}
+
+/* Put back what a failed commit didn't write. Anything staged since is newer, so it wins */
+void devEK9000OutputGroup::Restage(const StagedMap_t& registers, const std::vector<uint8_t>& coils,
+								   const std::vector<uint8_t>& mask) {
+	epicsMutexMustLock(m_mutex);
+	m_registers.insert(registers.begin(), registers.end());
+	if (m_coils.size() < mask.size()) {
+		m_coils.resize(mask.size(), 0);
+		m_coilMask.resize(mask.size(), 0);
+	}
+	for (size_t i = 0; i < mask.size(); ++i) {
+		const uint8_t take = mask[i] & ~m_coilMask[i];
+		m_coils[i] = (m_coils[i] & ~take) | (coils[i] & take);
+		m_coilMask[i] |= take;
+	}
+	epicsMutexUnlock(m_mutex);
+}
+
+/* True if any of the member's outputs are still in what a failed commit left unwritten */
+bool devEK9000OutputGroup::Unwritten(const Member_t& member, const StagedMap_t& registers,
+									 const std::vector<uint8_t>& mask) {
+	if (member.coils)
+		return size_t(member.addr) + member.count <= mask.size() * 8 &&
+			   bits::GetBits(&mask[0], member.addr, member.count) != 0;
+	for (uint16_t i = 0; i < member.count; ++i) {
+		if (registers.count(member.addr + i))
+			return true;
+	}
+	return false;
+}
+
+void devEK9000OutputGroup::PostStatus(dbCommon* record, int status) {
+	if (status != EK_EOK)
+		recGblSetSevr(record, COMM_ALARM, INVALID_ALARM);
+	else if (record->stat != COMM_ALARM)
+		return;
+	recGblResetAlarms(record);
+}
+
+size_t devEK9000OutputGroup::StagedCount() {
+	epicsMutexMustLock(m_mutex);
+	size_t n = m_registers.size();
+	for (size_t i = 0; i < m_coilMask.size(); ++i)
+		n += bits::PopCount(m_coilMask[i]);
+	epicsMutexUnlock(m_mutex);
+	return n;
+}
+
+/* Walk the (sorted) staged addresses and issue one write per contiguous run */
+int devEK9000OutputGroup::FlushRegisters(StagedMap_t& staged, unsigned& writes) {
+	std::vector<uint16_t> run;
+	run.reserve(staged.size());
+	uint16_t runStart = 0;
+
+	for (StagedMap_t::iterator it = staged.begin();; ++it) {
+		const bool end = it == staged.end();
+		/* Flush the current run if this address doesn't extend it, or we've hit the max transaction size */
+		if (!run.empty() &&
+			(end || size_t(it->first) != runStart + run.size() || run.size() >= EK9000_MAX_WRITE_REGISTERS)) {
+			int status = m_device->WriteRegisters(runStart, &run[0], run.size());
+			if (status != EK_EOK)
+				return status;
+			++writes;
+			run.clear();
+			/* Runs go out in order, so everything before this one has been written */
+			staged.erase(staged.begin(), it);
+		}
+		if (end)
+			break;
+		if (run.empty())
+			runStart = it->first;
+		run.push_back(it->second);
+	}
+	return EK_EOK;
+}
+
+/* Find the runs of staged coils in the mask and write each straight out of the packed values */
+int devEK9000OutputGroup::FlushCoils(const std::vector<uint8_t>& values, std::vector<uint8_t>& mask,
+									 unsigned& writes) {
+	const size_t limit = mask.size() * 8;
+	for (size_t i = mask.empty() ? 0 : bits::NextSet(&mask[0], 0, limit); i < limit;) {
+		const size_t end = bits::RunEnd(&mask[0], i, limit);
+		int status = m_device->WriteCoilsPacked(i, &values[0], i, end - i);
+		if (status != EK_EOK)
+			return status;
+		writes += (end - i + EK9000_MAX_WRITE_COILS - 1) / EK9000_MAX_WRITE_COILS;
+		for (size_t b = i; b < end; b += 32)
+			bits::SetBits(&mask[0], b, std::min(end - b, size_t(32)), 0);
+		i = bits::NextSet(&mask[0], end, limit);
+	}
+	return EK_EOK;
+}
+
+int devEK9000OutputGroup::Commit() {
+	StagedMap_t registers;
+	std::vector<uint8_t> coils, coilMask;
+	MemberMap_t members;
+
+	/* Take ownership of everything staged so far. Anything staged while we're writing goes into the next commit */
+	epicsMutexMustLock(m_mutex);
+	coils.swap(m_coils);
+	coilMask.swap(m_coilMask);
+	registers.swap(m_registers);
+	members.swap(m_members);
+	epicsMutexUnlock(m_mutex);
+
+	int status = EK_EMUTEXTIMEOUT;
+	bool written = false;
+	unsigned writes = 0;
+	epicsTimeStamp landed;
+	{
+		DeviceLock lock(m_device);
+		if (!lock.valid())
+			LOG_ERROR(m_device, "group %s: unable to obtain device lock\n", m_name.c_str());
+		else {
+			status = m_device->TerminalIOEnabled() ? FlushRegisters(registers, writes) : EK_ELAYOUT;
+			if (status == EK_EOK)
+				status = FlushCoils(coils, coilMask, writes);
+			epicsTimeGetCurrent(&landed);
+			written = true;
+		}
+	}
+
+	if (status != EK_EOK) {
+		LOG_WARNING(m_device, "group %s: commit failed: %s\n", m_name.c_str(), devEK9000::ErrorToString(status));
+		Restage(registers, coils, coilMask);
+	}
+
+	epicsMutexMustLock(m_mutex);
+	if (written) {
+		m_lastWrites = writes;
+		m_lastCommit = landed;
+	}
+	if (status == EK_EOK)
+		++m_commits;
+	m_lastStatus = status;
+	epicsMutexUnlock(m_mutex);
+
+	/* Records whose value didn't make it also wait on the next commit, so they hear when it does land */
+	for (MemberMap_t::iterator it = members.begin(); it != members.end(); ++it) {
+		const bool unwritten = status != EK_EOK && Unwritten(it->second, registers, coilMask);
+		if (unwritten) {
+			epicsMutexMustLock(m_mutex);
+			AddMember(it->first, it->second.done, it->second.coils, it->second.addr, it->second.count);
+			epicsMutexUnlock(m_mutex);
+		}
+		it->second.done(it->first, unwritten ? status : EK_EOK);
+	}
+	return status;
+}
+
+epicsTimeStamp devEK9000OutputGroup::LastCommit() {
+	epicsMutexMustLock(m_mutex);
+	const epicsTimeStamp stamp = m_lastCommit;
+	epicsMutexUnlock(m_mutex);
+	return stamp;
+}
+
+void devEK9000OutputGroup::Report(int level) {
+	/* Copied out, so a commit can't land halfway through printing them */
+	epicsMutexMustLock(m_mutex);
+	const unsigned commits = m_commits, writes = m_lastWrites;
+	const int status = m_lastStatus;
+	const epicsTimeStamp stamp = m_lastCommit;
+	epicsMutexUnlock(m_mutex);
+
+	char timeBuf[64];
+	epicsTimeToStrftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S.%06f", &stamp);
+	epicsPrintf("\tGroup: %s\n", m_name.c_str());
+	epicsPrintf("\t\tCommits: %u\n", commits);
+	epicsPrintf("\t\tLast commit: %s (%u writes, %s)\n", commits ? timeBuf : "never", writes,
+				devEK9000::ErrorToString(status));
+	if (level > 0)
+		epicsPrintf("\t\tStaged: %u\n", (unsigned)StagedCount());
+}
+
+//======================================================//
+//
+// Commit record device support. Processing the record
+// flushes the group; with TSE=-2 the record timestamp is
+// the time the group landed on the coupler.
+//	OUT: @device=EK9K1,group=name
+//
+//======================================================//
+
+struct GroupCommitDpvt_t {
+	devEK9000* pdrv;
+	devEK9000OutputGroup* group;
+};
+
+static void group_commit_callback(CALLBACK* callback) {
+	void* record = NULL;
+	callbackGetUser(record, callback);
+	boRecord* pRecord = static_cast<boRecord*>(record);
+	GroupCommitDpvt_t* dpvt = static_cast<GroupCommitDpvt_t*>(pRecord->dpvt);
+	free(callback);
+
+	int status = dpvt->group->Commit();
+
+	struct typed_rset* prset = (struct typed_rset*)(pRecord->rset);
+	dbScanLock((struct dbCommon*)pRecord);
+	if (status != EK_EOK)
+		recGblSetSevr(pRecord, COMM_ALARM, INVALID_ALARM);
+	pRecord->time = dpvt->group->LastCommit();
+	pRecord->udf = FALSE;
+	(*prset->process)((struct dbCommon*)pRecord); /* This will set PACT false! */
+	dbScanUnlock((struct dbCommon*)pRecord);
+}
+
+static long group_commit_init_record(void* precord) {
+	boRecord* pRecord = static_cast<boRecord*>(precord);
+	devEK9000* pdrv = NULL;
+	util::StrView_t groupName = {NULL, 0};
+
+	const char* link = pRecord->out.value.instio.string;
+	if (!util::LinkParser::IsKeyValueLink(link)) {
+		epicsPrintf("%s: malformed link string\n", pRecord->name);
+		return 1;
+	}
+
+	util::LinkParser parser(link);
+	while (parser.Next()) {
+		char name[256];
+		switch (parser.KeyId()) {
+			case util::LINK_KEY_DEVICE:
+				pdrv = parser.Value().CopyTo(name) ? devEK9000::FindDevice(name) : NULL;
+				break;
+			case util::LINK_KEY_GROUP:
+				groupName = parser.Value();
+				break;
+			default:
+				epicsPrintf("%s: ignored unknown param %.*s\n", pRecord->name, (int)parser.Key().len, parser.Key().str);
+				break;
+		}
+	}
+
+	char group[256];
+	if (!pdrv || !groupName.str || !groupName.CopyTo(group)) {
+		epicsPrintf("%s: link must specify a valid device and group\n", pRecord->name);
+		return 1;
+	}
+
+	GroupCommitDpvt_t* dpvt = static_cast<GroupCommitDpvt_t*>(calloc(1, sizeof(GroupCommitDpvt_t)));
+	dpvt->pdrv = pdrv;
+	dpvt->group = pdrv->FindOutputGroup(group, true);
+	pRecord->dpvt = dpvt;
+	return 2; /* Don't convert */
+}
+
+static long group_commit_write_record(void* precord) {
+	boRecord* prec = static_cast<boRecord*>(precord);
+	if (!prec->dpvt)
+		return 1;
+	if (prec->pact)
+		prec->pact = FALSE;
+	else {
+		prec->pact = TRUE;
+		util::setupCallback(precord, group_commit_callback);
+	}
+	return 0;
+}
+
+struct devEK9000GroupCommit_t {
+	long number;
+	DEVSUPFUN dev_report;
+	DEVSUPFUN init;
+	DEVSUPFUN init_record;
+	DEVSUPFUN get_ioint_info;
+	DEVSUPFUN write_record;
+} devEK9000GroupCommit = {
+	5, NULL, NULL, (DEVSUPFUN)group_commit_init_record, NULL, (DEVSUPFUN)group_commit_write_record,
+};
+
+epicsExportAddress(dset, devEK9000GroupCommit);
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekOutputGroup.h
+// Purpose: Named groups of outputs that are staged by
+//  records and flushed to the coupler together
+//======================================================//
+#pragma once
+
+#include <epicsMutex.h>
+#include <epicsTime.h>
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ekUtil.h"
+
+class devEK9000;
+struct dbCommon;
+
+/**
+ * A named set of outputs on a single coupler. Output records that specify group=<name> in their link stage their
+ * value here instead of writing it, and a commit record (DTYP EK9000GroupCommit) flushes everything staged.
+ *
+ * Staged addresses are coalesced into contiguous runs, and each run is written with a single modbus transaction, so
+ * a group whose outputs are adjacent in the register map lands in one write (or one register write + one coil write
+ * if it mixes analog and digital outputs). Coils are staged bit-packed and go out as packed FC15 payloads.
+ *
+ * Records that staged a value are told how the commit carrying it went. Values a failed commit didn't write are
+ * staged again for the next one, unless something newer was staged in the meantime.
+ */
+class devEK9000OutputGroup {
+public:
+	/* Called once the commit carrying a record's value is done, with its status. No locks are held */
+	typedef void (*DoneFn_t)(dbCommon* record, int status);
+
+	DELETE_CTOR(devEK9000OutputGroup());
+	devEK9000OutputGroup(devEK9000* device, const char* name);
+	~devEK9000OutputGroup();
+
+	/**
+	 * Stage a run of coils
+	 * @param addr 0-based modbus coil address of the first coil
+	 * @param values Packed coil values, first coil in bit 0
+	 * @param count Number of coils to stage, at most 32
+	 * @param record Record staging them, told about the commit through done. May be NULL
+	 */
+	void StageCoils(uint16_t addr, uint32_t values, uint16_t count, dbCommon* record = NULL, DoneFn_t done = NULL);
+
+	/**
+	 * Stage a single holding register
+	 * @param addr Modbus register address (i.e. 0x800 for the first analog output)
+	 * @param value Raw register value
+	 * @param record Record staging it, told about the commit through done. May be NULL
+	 */
+	void StageRegister(uint16_t addr, uint16_t value, dbCommon* record = NULL, DoneFn_t done = NULL);
+
+	/**
+	 * Write everything staged to the device, then tell the records that staged it. Takes the device lock, so the
+	 * caller must not hold it unless the group has no records.
+	 * @returns EK_EOK on success
+	 */
+	int Commit();
+
+	/**
+	 * Update a staged record's alarm after its commit, outside of record processing. Raises COMM_ALARM if the commit
+	 * failed, and clears it once one succeeds. Caller must hold the record's scan lock
+	 */
+	static void PostStatus(dbCommon* record, int status);
+
+	/* Number of staged coils + registers */
+	size_t StagedCount();
+
+	const char* Name() const {
+		return m_name.c_str();
+	}
+
+	void Report(int level);
+
+	/* Time the last commit's final write returned */
+	epicsTimeStamp LastCommit();
+
+private:
+	/* Statistics, guarded by m_mutex as Report reads them from other threads */
+
+	/* Number of successful commits */
+	unsigned m_commits;
+	/* Number of modbus writes issued by the last commit */
+	unsigned m_lastWrites;
+	/* Status of the last commit */
+	int m_lastStatus;
+	/* Time the last commit's final write returned */
+	epicsTimeStamp m_lastCommit;
+
+	typedef std::map<uint16_t, uint16_t> StagedMap_t;
+
+	/* A record that staged into the next commit, and where its value went */
+	struct Member_t {
+		DoneFn_t done;
+		bool coils;
+		uint16_t addr;
+		uint16_t count;
+	};
+	typedef std::map<dbCommon*, Member_t> MemberMap_t;
+
+	/* These drop what they wrote from staged, so what's left after a failure is what didn't make it */
+	int FlushRegisters(StagedMap_t& staged, unsigned& writes);
+	int FlushCoils(const std::vector<uint8_t>& values, std::vector<uint8_t>& mask, unsigned& writes);
+
+	void AddMember(dbCommon* record, DoneFn_t done, bool coils, uint16_t addr, uint16_t count);
+	void Restage(const StagedMap_t& registers, const std::vector<uint8_t>& coils, const std::vector<uint8_t>& mask);
+	static bool Unwritten(const Member_t& member, const StagedMap_t& registers, const std::vector<uint8_t>& mask);
+
+	std::string m_name;
+	devEK9000* m_device;
+	epicsMutexId m_mutex;
+	/* Staged coils, bit-packed over the coupler's whole coil space. m_coilMask flags the staged ones */
+	std::vector<uint8_t> m_coils;
+	std::vector<uint8_t> m_coilMask;
+	StagedMap_t m_registers;
+	/* Records with a value in the next commit */
+	MemberMap_t m_members;
+};
@@ -0,0 +1,454 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekProfile.cpp
+// Purpose: Driver-side output profile engine and its
+//  device support (EL40XX_Ramp, EL20XX_Pulse,
+//  EK9000Schedule)
+//======================================================//
+
+/* EPICS includes */
+#include <epicsExport.h>
+#include <epicsMath.h>
+#include <epicsStdlib.h>
+#include <epicsPrint.h>
+#include <devSup.h>
+#include <alarm.h>
+#include <aoRecord.h>
+#include <boRecord.h>
+#include <aaoRecord.h>
+#include <menuFtype.h>
+#include <recGbl.h>
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include "devEK9000.h"
+#include "ekOutputGroup.h"
+#include "ekProfile.h"
+
+//==========================================================//
+// class devEK9000Profile
+//==========================================================//
+
+devEK9000Profile::devEK9000Profile(EProfileType type, bool digital, uint16_t addr)
+	: m_type(type), m_digital(digital), m_signed(false), m_addr(addr), m_active(false), m_slew(0), m_target(0),
+	  m_current(0), m_high(0), m_low(0), m_count(0), m_pulses(0), m_level(false), m_stopping(false), m_next(0), m_stepped(false),
+	  m_lastOut(0), m_written(false) {
+	memset(&m_start, 0, sizeof(m_start));
+	memset(&m_lastStep, 0, sizeof(m_lastStep));
+}
+
+uint16_t devEK9000Profile::ToRaw(double value) const {
+	if (m_digital)
+		return value != 0 ? 1 : 0;
+	if (m_signed)
+		return (uint16_t)(int16_t)util::clamp(floor(value + 0.5), -32768.0, 32767.0);
+	return (uint16_t)util::clamp(floor(value + 0.5), 0.0, 65535.0);
+}
+
+void devEK9000Profile::SeedOutput(uint16_t raw) {
+	m_lastOut = raw;
+	m_written = true;
+	m_current = m_signed ? (double)(int16_t)raw : (double)raw;
+}
+
+void devEK9000Profile::SetRampTarget(double target) {
+	m_target = target;
+	/* Without a known starting point there's nothing to ramp from */
+	if (!m_written)
+		m_current = target;
+	m_active = true;
+	m_stepped = false;
+}
+
+void devEK9000Profile::StartPulses(double highSec, double lowSec, int count) {
+	m_high = highSec;
+	m_low = lowSec;
+	m_count = count;
+	m_pulses = 0;
+	m_level = true;
+	m_stopping = false;
+	epicsTimeGetCurrent(&m_start);
+	m_active = true;
+	m_written = false; /* Force the rising edge out */
+}
+
+void devEK9000Profile::Stop() {
+	if (m_digital) {
+		/* Leave it active so the next step drives the output low */
+		m_stopping = m_active;
+		m_level = false;
+	}
+	else
+		m_active = false;
+}
+
+void devEK9000Profile::SetSchedule(const double* pairs, size_t numPairs, const epicsTimeStamp& start) {
+	m_schedule.clear();
+	for (size_t i = 0; i < numPairs; ++i)
+		m_schedule.push_back(std::make_pair(pairs[i * 2], pairs[i * 2 + 1]));
+	/* Stable so that multiple entries at the same offset apply in the order given */
+	std::stable_sort(m_schedule.begin(), m_schedule.end());
+	m_next = 0;
+	m_start = start;
+	m_active = !m_schedule.empty();
+}
+
+bool devEK9000Profile::Step(const epicsTimeStamp& now, uint16_t& out) {
+	if (!m_active)
+		return false;
+
+	const double dt = m_stepped ? epicsTimeDiffInSeconds(&now, &m_lastStep) : 0;
+	m_lastStep = now;
+	m_stepped = true;
+
+	double value = 0;
+	switch (m_type) {
+		case PROFILE_RAMP:
+			{
+				const double delta = m_target - m_current;
+				const double maxStep = m_slew * dt;
+				if (m_slew <= 0 || fabs(delta) <= maxStep)
+					m_current = m_target;
+				else
+					m_current += delta > 0 ? maxStep : -maxStep;
+				if (m_current == m_target)
+					m_active = false;
+				value = m_current;
+				break;
+			}
+		case PROFILE_PULSE:
+			{
+				if (m_stopping) {
+					m_stopping = m_active = false;
+					value = 0;
+					break;
+				}
+				double elapsed = epicsTimeDiffInSeconds(&now, &m_start);
+				/* Catch up on as many phases as elapsed, poll jitter shouldn't stretch the train */
+				while (m_active && elapsed >= (m_level ? m_high : m_low)) {
+					elapsed -= m_level ? m_high : m_low;
+					epicsTimeAddSeconds(&m_start, m_level ? m_high : m_low);
+					if (m_level && m_count > 0 && ++m_pulses >= m_count)
+						m_active = false;
+					m_level = m_active ? !m_level : false;
+				}
+				value = m_level ? 1 : 0;
+				break;
+			}
+		case PROFILE_SCHEDULE:
+			{
+				const double elapsed = epicsTimeDiffInSeconds(&now, &m_start);
+				bool changed = false;
+				while (m_next < m_schedule.size() && m_schedule[m_next].first <= elapsed) {
+					value = m_schedule[m_next].second;
+					changed = true;
+					++m_next;
+				}
+				if (m_next >= m_schedule.size())
+					m_active = false;
+				if (!changed)
+					return false;
+				break;
+			}
+	}
+
+	out = ToRaw(value);
+	if (m_written && out == m_lastOut)
+		return false;
+	m_lastOut = out;
+	m_written = true;
+	return true;
+}
+
+//==========================================================//
+// devEK9000 profile engine
+//==========================================================//
+
+void devEK9000::AddProfile(devEK9000Profile* profile) {
+	epicsMutexMustLock(m_profileMutex);
+	if (!m_profileGroup)
+		m_profileGroup = new devEK9000OutputGroup(this, "profiles");
+	m_profiles.push_back(profile);
+	epicsMutexUnlock(m_profileMutex);
+}
+
+/* Called from the poll thread with the device lock held. The lock is recursive, so committing the group is fine */
+void devEK9000::RunProfiles() {
+	epicsTimeStamp now;
+	epicsTimeGetCurrent(&now);
+
+	epicsMutexMustLock(m_profileMutex);
+	for (size_t i = 0; i < m_profiles.size(); ++i) {
+		uint16_t out = 0;
+		devEK9000Profile* profile = m_profiles[i];
+		if (!profile->Step(now, out))
+			continue;
+		if (profile->m_digital)
+			m_profileGroup->StageCoils(profile->m_addr, out, 1);
+		else
+			m_profileGroup->StageRegister(profile->m_addr, out);
+	}
+	epicsMutexUnlock(m_profileMutex);
+
+	/* All profile outputs that changed this cycle go out together */
+	if (m_profileGroup && m_profileGroup->StagedCount())
+		m_profileGroup->Commit();
+}
+
+//======================================================//
+//
+// Profile device support
+//	EL40XX_Ramp (ao):     @device=..,pos=..,channel=..,slew=<counts/s>
+//	EL20XX_Pulse (bo):    @device=..,pos=..,channel=..,high=<ms>,low=<ms>,count=<n>
+//	EK9000Schedule (aao): @device=..,pos=..,channel=..,time=<rel|abs>
+//		FTVL=DOUBLE, VAL is (time [s], raw value) pairs. Times are offsets from
+//		the write, or with time=abs seconds past the EPICS epoch
+//
+//======================================================//
+
+struct ProfileDpvt_t : public TerminalDpvt_t {
+	devEK9000Profile* profile;
+	bool absolute; /* Schedule times are timestamps, not offsets */
+};
+
+static const char* const s_profileKeys[] = {"slew", "high", "low", "count", "time", NULL};
+
+template <class RecordT> static ProfileDpvt_t* profile_setup(RecordT* pRecord, EProfileType type) {
+	ProfileDpvt_t setup;
+	setup.profile = NULL;
+	setup.absolute = false;
+
+	if (!util::setupCommonDpvt(pRecord, setup, s_profileKeys)) {
+		LOG_ERROR(setup.pdrv, "Unable to setup dpvt for record %s\n", pRecord->name);
+		return NULL;
+	}
+	ProfileDpvt_t* dpvt = &setup;
+
+	devEK9000Terminal* pterm = dpvt->pterm;
+	const bool digital = pterm->m_terminalFamily == TERMINAL_FAMILY_DIGITAL;
+	if (pterm->m_outputSize == 0 || dpvt->channel < 1 || (type == PROFILE_RAMP && digital) ||
+		(type == PROFILE_PULSE && !digital)) {
+		LOG_ERROR(dpvt->pdrv, "%s: terminal EL%d does not support this profile type\n", pRecord->name,
+				  pterm->m_terminalId);
+		return NULL;
+	}
+
+	/* Same addressing as the EL20XX/EL40XX device support */
+	const uint16_t addr =
+		digital ? pterm->m_outputStart + (dpvt->channel - 2) : pterm->m_outputStart + (dpvt->channel - 1);
+	dpvt->profile = new devEK9000Profile(type, digital, addr);
+	dpvt->profile->m_signed = !digital && util::isAnalogOutputSigned(pterm->m_terminalId);
+
+	/* Steps start from what the output is currently set to */
+	if (digital) {
+		uint32_t bit = 0;
+		if (dpvt->pdrv->ClaimCoils(addr, 1, &bit))
+			dpvt->profile->SeedOutput(bit);
+	}
+	else {
+		uint16_t raw = 0;
+		if (dpvt->pdrv->ClaimRegisters(addr, 1, &raw))
+			dpvt->profile->SeedOutput(raw);
+	}
+	return setup.pdrv->CommitDpvt(setup);
+}
+
+/* Profile params are read straight from the record's output link */
+static bool profile_param(const char* link, const char* recName, const char* key, double& out) {
+	util::StrView_t value;
+	if (!util::FindLinkParam(link, key, value))
+		return false;
+	char str[64];
+	if (!value.CopyTo(str) || epicsParseDouble(str, &out, NULL) != 0) {
+		epicsPrintf("%s: invalid value '%.*s' for %s\n", recName, (int)value.len, value.str, key);
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------//
+// EL40XX_Ramp
+
+static long ramp_init_record(void* precord) {
+	aoRecord* pRecord = static_cast<aoRecord*>(precord);
+	ProfileDpvt_t* dpvt = profile_setup(pRecord, PROFILE_RAMP);
+	if (!dpvt)
+		return 1;
+
+	if (!profile_param(pRecord->out.value.instio.string, pRecord->name, "slew", dpvt->profile->m_slew))
+		epicsPrintf("%s: no slew rate specified, setpoints will be applied immediately\n", pRecord->name);
+
+	dpvt->pdrv->AddProfile(dpvt->profile);
+	pRecord->dpvt = dpvt;
+	if (dpvt->profile->m_written) {
+		pRecord->rval = dpvt->profile->m_signed ? (epicsInt32)(int16_t)dpvt->profile->m_lastOut : dpvt->profile->m_lastOut;
+		return 0; /* Convert the read back value */
+	}
+	return 2; /* Don't convert */
+}
+
+static long ramp_write_record(void* precord) {
+	aoRecord* pRecord = static_cast<aoRecord*>(precord);
+	ProfileDpvt_t* dpvt = static_cast<ProfileDpvt_t*>(pRecord->dpvt);
+	if (!dpvt)
+		return 1;
+
+	epicsMutexMustLock(dpvt->pdrv->m_profileMutex);
+	dpvt->profile->SetRampTarget(dpvt->profile->m_signed ? (double)(int16_t)pRecord->rval : (double)pRecord->rval);
+	epicsMutexUnlock(dpvt->pdrv->m_profileMutex);
+	pRecord->udf = FALSE;
+	return 0;
+}
+
+struct devEL40XX_Ramp_t {
+	long number;
+	DEVSUPFUN dev_report;
+	DEVSUPFUN init;
+	DEVSUPFUN init_record;
+	DEVSUPFUN get_ioint_info;
+	DEVSUPFUN write_record;
+	DEVSUPFUN linconv;
+} devEL40XX_Ramp = {
+	6, NULL, NULL, (DEVSUPFUN)ramp_init_record, NULL, (DEVSUPFUN)ramp_write_record, NULL,
+};
+
+epicsExportAddress(dset, devEL40XX_Ramp);
+
+//-----------------------------------------------------------------//
+// EL20XX_Pulse
+
+static long pulse_init_record(void* precord) {
+	boRecord* pRecord = static_cast<boRecord*>(precord);
+
+	/* Checked before profile_setup creates the profile, so there's nothing to undo */
+	double high = 0, low = 0, count = 0;
+	const char* link = pRecord->out.value.instio.string;
+	if (!profile_param(link, pRecord->name, "high", high) || !profile_param(link, pRecord->name, "low", low) ||
+		high <= 0 || low <= 0) {
+		epicsPrintf("%s: pulse profiles require positive high=<ms> and low=<ms> link params\n", pRecord->name);
+		return 1;
+	}
+	profile_param(link, pRecord->name, "count", count);
+
+	ProfileDpvt_t* dpvt = profile_setup(pRecord, PROFILE_PULSE);
+	if (!dpvt)
+		return 1;
+
+	/* The train's shape is fixed by the link, VAL only starts and stops it */
+	dpvt->profile->m_high = high / 1000.0;
+	dpvt->profile->m_low = low / 1000.0;
+	dpvt->profile->m_count = (int)count;
+
+	dpvt->pdrv->AddProfile(dpvt->profile);
+	pRecord->dpvt = dpvt;
+	return 2; /* Don't convert */
+}
+
+static long pulse_write_record(void* precord) {
+	boRecord* pRecord = static_cast<boRecord*>(precord);
+	ProfileDpvt_t* dpvt = static_cast<ProfileDpvt_t*>(pRecord->dpvt);
+	if (!dpvt)
+		return 1;
+
+	devEK9000Profile* profile = dpvt->profile;
+	epicsMutexMustLock(dpvt->pdrv->m_profileMutex);
+	if (pRecord->val)
+		profile->StartPulses(profile->m_high, profile->m_low, profile->m_count);
+	else
+		profile->Stop();
+	epicsMutexUnlock(dpvt->pdrv->m_profileMutex);
+	pRecord->udf = FALSE;
+	return 0;
+}
+
+struct devEL20XX_Pulse_t {
+	long number;
+	DEVSUPFUN dev_report;
+	DEVSUPFUN init;
+	DEVSUPFUN init_record;
+	DEVSUPFUN get_ioint_info;
+	DEVSUPFUN write_record;
+} devEL20XX_Pulse = {
+	5, NULL, NULL, (DEVSUPFUN)pulse_init_record, NULL, (DEVSUPFUN)pulse_write_record,
+};
+
+epicsExportAddress(dset, devEL20XX_Pulse);
+
+//-----------------------------------------------------------------//
+// EK9000Schedule
+
+static long schedule_init_record(void* precord) {
+	aaoRecord* pRecord = static_cast<aaoRecord*>(precord);
+	if (pRecord->ftvl != menuFtypeDOUBLE) {
+		epicsPrintf("%s: EK9000Schedule requires FTVL=DOUBLE\n", pRecord->name);
+		return 1;
+	}
+
+	bool absolute = false;
+	util::StrView_t mode;
+	if (util::FindLinkParam(pRecord->out.value.instio.string, "time", mode)) {
+		if (mode == "abs")
+			absolute = true;
+		else if (!(mode == "rel")) {
+			epicsPrintf("%s: time must be rel or abs, not '%.*s'\n", pRecord->name, (int)mode.len, mode.str);
+			return 1;
+		}
+	}
+
+	ProfileDpvt_t* dpvt = profile_setup(pRecord, PROFILE_SCHEDULE);
+	if (!dpvt)
+		return 1;
+	dpvt->absolute = absolute;
+
+	dpvt->pdrv->AddProfile(dpvt->profile);
+	pRecord->dpvt = dpvt;
+	return 0;
+}
+
+static long schedule_write_record(void* precord) {
+	aaoRecord* pRecord = static_cast<aaoRecord*>(precord);
+	ProfileDpvt_t* dpvt = static_cast<ProfileDpvt_t*>(pRecord->dpvt);
+	if (!dpvt)
+		return 1;
+
+	if (pRecord->nord % 2) {
+		epicsPrintf("%s: schedule must be (time, value) pairs, ignoring trailing element\n", pRecord->name);
+	}
+
+	/* Absolute times are just offsets from the epoch; any already past are applied on the next cycle */
+	epicsTimeStamp start;
+	if (dpvt->absolute) {
+		start.secPastEpoch = 0;
+		start.nsec = 0;
+	}
+	else
+		epicsTimeGetCurrent(&start);
+	epicsMutexMustLock(dpvt->pdrv->m_profileMutex);
+	dpvt->profile->SetSchedule(static_cast<const double*>(pRecord->bptr), pRecord->nord / 2, start);
+	epicsMutexUnlock(dpvt->pdrv->m_profileMutex);
+	pRecord->udf = FALSE;
+	return 0;
+}
+
+struct devEK9000Schedule_t {
+	long number;
+	DEVSUPFUN dev_report;
+	DEVSUPFUN init;
+	DEVSUPFUN init_record;
+	DEVSUPFUN get_ioint_info;
+	DEVSUPFUN write_record;
+} devEK9000Schedule = {
+	5, NULL, NULL, (DEVSUPFUN)schedule_init_record, NULL, (DEVSUPFUN)schedule_write_record,
+};
+
+epicsExportAddress(dset, devEK9000Schedule);
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekProfile.h
+// Purpose: Driver-side output profiles (ramps, pulse
+//  trains, scheduled setpoints) stepped by the poll thread
+//======================================================//
+#pragma once
+
+#include <epicsTime.h>
+
+#include <stdint.h>
+#include <vector>
+
+#include "ekUtil.h"
+
+class devEK9000;
+
+enum EProfileType {
+	PROFILE_RAMP,	  /* Slew-limited ramp to a setpoint (analog outputs) */
+	PROFILE_PULSE,	  /* Pulse train (digital outputs) */
+	PROFILE_SCHEDULE, /* List of (time offset, value) setpoint changes */
+};
+
+/**
+ * A single output channel driven by the poll thread. Records only change the profile's parameters, every step after
+ * that is computed and written by the coupler's poll cycle, so the output resolution is the poll period.
+ *
+ * All setters and Step() must be called with the owning device's m_profileMutex held.
+ */
+class devEK9000Profile {
+public:
+	DELETE_CTOR(devEK9000Profile());
+	devEK9000Profile(EProfileType type, bool digital, uint16_t addr);
+
+	/* Ramp to target (raw counts), moving at most m_slew counts per second */
+	void SetRampTarget(double target);
+
+	/* Start a pulse train. count = 0 pulses until stopped */
+	void StartPulses(double highSec, double lowSec, int count);
+
+	/* Stop the profile, driving digital outputs low. Ramps hold their current value */
+	void Stop();
+
+	/* Schedule from (time offset [s], raw value) pairs, relative to start (the epoch for absolute times) */
+	void SetSchedule(const double* pairs, size_t numPairs, const epicsTimeStamp& start);
+
+	/* Seed the last known output value, so ramps start from it instead of jumping */
+	void SeedOutput(uint16_t raw);
+
+	/**
+	 * Advance the profile to now.
+	 * @param out Receives the raw output value if it changed
+	 * @returns true if the output needs to be written
+	 */
+	bool Step(const epicsTimeStamp& now, uint16_t& out);
+
+public:
+	EProfileType m_type;
+	bool m_digital;
+	bool m_signed;
+	/* Coil address for digital outputs, holding register address for analog outputs */
+	uint16_t m_addr;
+	bool m_active;
+
+	/* Ramp */
+	double m_slew;
+	double m_target;
+	double m_current;
+
+	/* Pulse train */
+	double m_high;
+	double m_low;
+	int m_count;
+	int m_pulses;
+	bool m_level;
+	/* Stop() was requested, drive the output low on the next step */
+	bool m_stopping;
+
+	/* Schedule */
+	std::vector<std::pair<double, double> > m_schedule;
+	size_t m_next;
+
+	/* Start of the current pulse phase or schedule */
+	epicsTimeStamp m_start;
+	epicsTimeStamp m_lastStep;
+	bool m_stepped;
+
+	/* Last value handed out by Step() */
+	uint16_t m_lastOut;
+	bool m_written;
+
+private:
+	uint16_t ToRaw(double value) const;
+};
@@ -0,0 +1,670 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekRailConfig.cpp
+// Purpose: Loading couplers, terminals and their settings
+//  from a JSON rail description in one pass
+//======================================================//
+
+#include <epicsPrint.h>
+#include <epicsStdio.h>
+#include <epicsString.h>
+#include <dbAccess.h>
+#include <yajl_parse.h>
+
+#include <errno.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "devEK9000.h"
+#include "ekRailConfig.h"
+#include "ekUtil.h"
+
+//-----------------------------------------------------------------//
+// JSON document, built from the yajl events
+
+namespace
+{
+
+struct JsonValue_t {
+	enum Type {
+		NUL,
+		BOOLEAN,
+		NUMBER,
+		STRING,
+		ARRAY,
+		OBJECT
+	} type;
+	bool boolean;
+	std::string str;				/* String value, or the text of a number */
+	std::vector<std::string> keys;	/* Object member names, matching items */
+	std::vector<JsonValue_t> items; /* Array elements or object member values */
+
+	JsonValue_t() : type(NUL), boolean(false) {
+	}
+
+	const JsonValue_t* Find(const char* key) const {
+		for (size_t i = 0; i < keys.size(); ++i)
+			if (keys[i] == key)
+				return &items[i];
+		return NULL;
+	}
+};
+
+/**
+ * Containers still being filled are on the stack. A value is only ever appended to the innermost one, so the pointers
+ * to the outer ones stay valid even though their items vectors are std::vectors.
+ */
+struct JsonBuilder_t {
+	JsonValue_t root;
+	std::vector<JsonValue_t*> stack;
+	std::string key;
+};
+
+} // namespace
+
+static JsonValue_t* JsonAdd(void* ctx, JsonValue_t::Type type) {
+	JsonBuilder_t* b = static_cast<JsonBuilder_t*>(ctx);
+	JsonValue_t* value = &b->root;
+	if (!b->stack.empty()) {
+		JsonValue_t* parent = b->stack.back();
+		if (parent->type == JsonValue_t::OBJECT)
+			parent->keys.push_back(b->key);
+		parent->items.push_back(JsonValue_t());
+		value = &parent->items.back();
+	}
+	value->type = type;
+	return value;
+}
+
+static int JsonNull(void* ctx) {
+	JsonAdd(ctx, JsonValue_t::NUL);
+	return 1;
+}
+
+static int JsonBoolean(void* ctx, int value) {
+	JsonAdd(ctx, JsonValue_t::BOOLEAN)->boolean = value != 0;
+	return 1;
+}
+
+static int JsonNumber(void* ctx, const char* text, size_t len) {
+	JsonAdd(ctx, JsonValue_t::NUMBER)->str.assign(text, len);
+	return 1;
+}
+
+static int JsonString(void* ctx, const unsigned char* text, size_t len) {
+	JsonAdd(ctx, JsonValue_t::STRING)->str.assign(reinterpret_cast<const char*>(text), len);
+	return 1;
+}
+
+static int JsonStartMap(void* ctx) {
+	static_cast<JsonBuilder_t*>(ctx)->stack.push_back(JsonAdd(ctx, JsonValue_t::OBJECT));
+	return 1;
+}
+
+static int JsonMapKey(void* ctx, const unsigned char* text, size_t len) {
+	static_cast<JsonBuilder_t*>(ctx)->key.assign(reinterpret_cast<const char*>(text), len);
+	return 1;
+}
+
+static int JsonStartArray(void* ctx) {
+	static_cast<JsonBuilder_t*>(ctx)->stack.push_back(JsonAdd(ctx, JsonValue_t::ARRAY));
+	return 1;
+}
+
+static int JsonEnd(void* ctx) {
+	static_cast<JsonBuilder_t*>(ctx)->stack.pop_back();
+	return 1;
+}
+
+static const yajl_callbacks s_jsonCallbacks = {
+	JsonNull, JsonBoolean, NULL, NULL, JsonNumber, JsonString, JsonStartMap, JsonMapKey, JsonEnd, JsonStartArray, JsonEnd,
+};
+
+static bool ParseJson(const char* path, const std::string& text, JsonValue_t& out) {
+	JsonBuilder_t builder;
+	yajl_handle handle = yajl_alloc(&s_jsonCallbacks, NULL, &builder);
+	if (!handle)
+		return false;
+	yajl_config(handle, yajl_allow_comments, 1);
+
+	const unsigned char* json = reinterpret_cast<const unsigned char*>(text.data());
+	yajl_status status = yajl_parse(handle, json, text.size());
+	if (status == yajl_status_ok)
+		status = yajl_complete_parse(handle);
+	if (status != yajl_status_ok) {
+		unsigned char* err = yajl_get_error(handle, 1, json, text.size());
+		epicsPrintf("ek9000LoadConfig: %s: %s\n", path, reinterpret_cast<const char*>(err));
+		yajl_free_error(handle, err);
+		yajl_free(handle);
+		return false;
+	}
+	yajl_free(handle);
+	out.type = builder.root.type;
+	out.keys.swap(builder.root.keys);
+	out.items.swap(builder.root.items);
+	return true;
+}
+
+//-----------------------------------------------------------------//
+// Rail description
+
+namespace
+{
+
+struct TerminalConfig_t {
+	uint16_t id;
+	std::string name; /* Record name for ek9000ConfigureTerminal, may be empty */
+};
+
+struct CouplerConfig_t {
+	std::string name;
+	std::string ip;
+	int port;
+	int count;
+	int watchdogTime;
+	int watchdogType;
+	double railCheck;
+	double outputVerify;
+	std::vector<TerminalConfig_t> terminals;
+	std::vector<CoEPreset_t> coe;
+	bool records;
+	std::string dbDir;
+	std::string recordBase;
+	std::string macros;
+};
+
+struct RailConfig_t {
+	int pollTime;
+	int parallelInit;
+	int pdoIntrospection;
+	double initTimeout;
+	bool haveLayoutCache;
+	std::string layoutCache;
+	std::vector<CouplerConfig_t> couplers;
+};
+
+/**
+ * Turns the document into a RailConfig_t, reporting every problem it finds along with where it is, rather than
+ * stopping at the first one.
+ */
+class ConfigReader {
+public:
+	explicit ConfigReader(const char* path) : m_path(path), m_errors(0) {
+	}
+
+	bool Read(const JsonValue_t& doc, RailConfig_t& config);
+
+private:
+	void Error(const std::string& where, const char* fmt, ...) EPICS_PRINTF_STYLE(3, 4);
+
+	void CheckKeys(const JsonValue_t& obj, const char* const* allowed, const std::string& where);
+	bool GetInt(const JsonValue_t& obj, const char* key, const std::string& where, long long lo, long long hi,
+				long long& out);
+	bool GetDouble(const JsonValue_t& obj, const char* key, const std::string& where, double& out);
+	bool GetString(const JsonValue_t& obj, const char* key, const std::string& where, std::string& out);
+	bool GetBool(const JsonValue_t& obj, const char* key, const std::string& where, bool& out);
+
+	bool ReadTerminalId(const JsonValue_t& value, const std::string& where, uint16_t& id, bool& known);
+	void ReadCoupler(const JsonValue_t& obj, const std::string& where, CouplerConfig_t& coupler);
+	void ReadCoE(const JsonValue_t& obj, const std::string& where, const CouplerConfig_t& coupler,
+				 CoEPreset_t& preset);
+
+	const char* m_path;
+	int m_errors;
+};
+
+} // namespace
+
+void ConfigReader::Error(const std::string& where, const char* fmt, ...) {
+	char msg[256];
+	va_list va;
+	va_start(va, fmt);
+	epicsVsnprintf(msg, sizeof(msg), fmt, va);
+	va_end(va);
+	epicsPrintf("ek9000LoadConfig: %s: %s: %s\n", m_path, where.empty() ? "(top)" : where.c_str(), msg);
+	++m_errors;
+}
+
+/* Unknown keys are most likely typos, which would otherwise be silently ignored */
+void ConfigReader::CheckKeys(const JsonValue_t& obj, const char* const* allowed, const std::string& where) {
+	for (size_t i = 0; i < obj.keys.size(); ++i) {
+		const char* const* k = allowed;
+		while (*k && obj.keys[i] != *k)
+			++k;
+		if (!*k)
+			Error(where, "unknown key '%s'", obj.keys[i].c_str());
+	}
+}
+
+bool ConfigReader::GetInt(const JsonValue_t& obj, const char* key, const std::string& where, long long lo,
+						  long long hi, long long& out) {
+	const JsonValue_t* value = obj.Find(key);
+	if (!value)
+		return false;
+	char* end = NULL;
+	errno = 0;
+	long long v = value->type == JsonValue_t::NUMBER || value->type == JsonValue_t::STRING
+					  ? strtoll(value->str.c_str(), &end, 0)
+					  : 0;
+	if (!end || end == value->str.c_str() || *end || errno == ERANGE) {
+		Error(where, "'%s' must be an integer", key);
+		return false;
+	}
+	if (v < lo || v > hi) {
+		Error(where, "'%s' is %lld, must be between %lld and %lld", key, v, lo, hi);
+		return false;
+	}
+	out = v;
+	return true;
+}
+
+bool ConfigReader::GetDouble(const JsonValue_t& obj, const char* key, const std::string& where, double& out) {
+	const JsonValue_t* value = obj.Find(key);
+	if (!value)
+		return false;
+	if (value->type != JsonValue_t::NUMBER) {
+		Error(where, "'%s' must be a number", key);
+		return false;
+	}
+	out = strtod(value->str.c_str(), NULL);
+	return true;
+}
+
+bool ConfigReader::GetString(const JsonValue_t& obj, const char* key, const std::string& where, std::string& out) {
+	const JsonValue_t* value = obj.Find(key);
+	if (!value)
+		return false;
+	if (value->type != JsonValue_t::STRING) {
+		Error(where, "'%s' must be a string", key);
+		return false;
+	}
+	out = value->str;
+	return true;
+}
+
+bool ConfigReader::GetBool(const JsonValue_t& obj, const char* key, const std::string& where, bool& out) {
+	const JsonValue_t* value = obj.Find(key);
+	if (!value)
+		return false;
+	if (value->type != JsonValue_t::BOOLEAN) {
+		Error(where, "'%s' must be true or false", key);
+		return false;
+	}
+	out = value->boolean;
+	return true;
+}
+
+/* "EL3064", or a bare 3064 for terminals this module doesn't know, like ek9000DeclareLayout */
+bool ConfigReader::ReadTerminalId(const JsonValue_t& value, const std::string& where, uint16_t& id, bool& known) {
+	const terminal_t* info = NULL;
+	const char* text = value.str.c_str();
+	if (value.type == JsonValue_t::STRING) {
+		info = util::FindTerminalByName(text);
+		if (!strncmp(text, "EL", 2))
+			text += 2;
+	}
+	else if (value.type != JsonValue_t::NUMBER) {
+		Error(where, "terminal type must be a name like \"EL3064\" or an ID");
+		return false;
+	}
+	if (info) {
+		id = info->id;
+		known = true;
+		return true;
+	}
+
+	char* end = NULL;
+	unsigned long v = strtoul(text, &end, 10);
+	if (end == text || *end || v == 0 || v > 0xFFFF) {
+		Error(where, "invalid terminal '%s'", value.str.c_str());
+		return false;
+	}
+	id = (uint16_t)v;
+	known = util::FindTerminal(id) != NULL;
+	return true;
+}
+
+struct CoETypeRange_t {
+	const char* name;
+	uint16_t bytes;
+	long long lo;
+	long long hi;
+};
+
+static const CoETypeRange_t s_coeTypes[] = {
+	{"bool", 1, 0, 1},
+	{"int8", 1, -128, 127},
+	{"uint8", 1, 0, 255},
+	{"int16", 2, -32768, 32767},
+	{"uint16", 2, 0, 65535},
+	{"int32", 4, -2147483647LL - 1, 2147483647LL},
+	{"uint32", 4, 0, 4294967295LL},
+	{"int64", 8, LLONG_MIN, LLONG_MAX},
+	{"uint64", 8, 0, LLONG_MAX},
+};
+
+void ConfigReader::ReadCoE(const JsonValue_t& obj, const std::string& where, const CouplerConfig_t& coupler,
+						   CoEPreset_t& preset) {
+	static const char* const keys[] = {"pos", "index", "subindex", "type", "value", NULL};
+	memset(&preset, 0, sizeof(preset));
+	if (obj.type != JsonValue_t::OBJECT) {
+		Error(where, "must be an object");
+		return;
+	}
+	CheckKeys(obj, keys, where);
+
+	long long pos = 0, index = 0, subindex = 0;
+	if (!GetInt(obj, "pos", where, 1, coupler.count, pos) && !obj.Find("pos"))
+		Error(where, "'pos' is required");
+	if (!GetInt(obj, "index", where, 0, 0xFFFF, index) && !obj.Find("index"))
+		Error(where, "'index' is required");
+	GetInt(obj, "subindex", where, 0, 0xFF, subindex);
+	preset.pos = (int)pos;
+	preset.index = (uint16_t)index;
+	preset.subindex = (uint16_t)subindex;
+
+	std::string type;
+	if (!GetString(obj, "type", where, type)) {
+		if (!obj.Find("type"))
+			Error(where, "'type' is required");
+		return;
+	}
+	size_t t = 0;
+	while (t < ArraySize(s_coeTypes) && epicsStrCaseCmp(type.c_str(), s_coeTypes[t].name) != 0)
+		++t;
+	if (t == ArraySize(s_coeTypes)) {
+		Error(where, "unknown CoE type '%s'", type.c_str());
+		return;
+	}
+
+	/* Laid out the same way the CoE dsets write them */
+	long long value = 0;
+	const JsonValue_t* v = obj.Find("value");
+	if (v && v->type == JsonValue_t::BOOLEAN)
+		value = v->boolean;
+	else if (!GetInt(obj, "value", where, s_coeTypes[t].lo, s_coeTypes[t].hi, value)) {
+		if (!v)
+			Error(where, "'value' is required");
+		return;
+	}
+	preset.bytes = s_coeTypes[t].bytes;
+	preset.len = (preset.bytes + 1) / 2;
+	if (preset.len == 1)
+		preset.data[0] = (uint16_t)value;
+	else if (preset.len == 2) {
+		uint32_t v32 = (uint32_t)value;
+		memcpy(preset.data, &v32, sizeof(v32));
+	}
+	else {
+		uint64_t v64 = (uint64_t)value;
+		memcpy(preset.data, &v64, sizeof(v64));
+	}
+}
+
+void ConfigReader::ReadCoupler(const JsonValue_t& obj, const std::string& where, CouplerConfig_t& coupler) {
+	static const char* const keys[] = {"name",		   "ip",	   "port",		  "count",		 "watchdogTime",
+									   "watchdogType", "railCheck", "outputVerify", "terminals", "coe",
+									   "records",	   NULL};
+	static const char* const recordKeys[] = {"dbDir", "base", "macros", NULL};
+	static const char* const terminalKeys[] = {"type", "name", NULL};
+
+	coupler.port = 502;
+	coupler.count = -1;
+	coupler.watchdogTime = coupler.watchdogType = -1;
+	coupler.railCheck = coupler.outputVerify = 0;
+	coupler.records = false;
+
+	if (obj.type != JsonValue_t::OBJECT) {
+		Error(where, "must be an object");
+		return;
+	}
+	CheckKeys(obj, keys, where);
+
+	if (!GetString(obj, "name", where, coupler.name) && !obj.Find("name"))
+		Error(where, "'name' is required");
+	if (!GetString(obj, "ip", where, coupler.ip) && !obj.Find("ip"))
+		Error(where, "'ip' is required");
+
+	long long v;
+	if (GetInt(obj, "port", where, 1, 65535, v))
+		coupler.port = (int)v;
+	if (GetInt(obj, "watchdogTime", where, 0, 60000, v))
+		coupler.watchdogTime = (int)v;
+	if (GetInt(obj, "watchdogType", where, 0, 2, v))
+		coupler.watchdogType = (int)v;
+	GetDouble(obj, "railCheck", where, coupler.railCheck);
+	GetDouble(obj, "outputVerify", where, coupler.outputVerify);
+
+	/* The rail, in order from position 1. Also the declared layout, so it gets checked against the real one */
+	const JsonValue_t* terms = obj.Find("terminals");
+	if (terms && terms->type != JsonValue_t::ARRAY)
+		Error(where, "'terminals' must be an array");
+	else if (terms) {
+		if (terms->items.size() >= TERMINAL_REGISTER_COUNT)
+			Error(where, "too many terminals");
+		for (size_t i = 0; i < terms->items.size(); ++i) {
+			char buf[32];
+			epicsSnprintf(buf, sizeof(buf), ".terminals[%u]", (unsigned)i);
+			const std::string at = where + buf;
+			const JsonValue_t& item = terms->items[i];
+
+			TerminalConfig_t term;
+			term.id = 0;
+			bool known = false;
+			if (item.type == JsonValue_t::OBJECT) {
+				CheckKeys(item, terminalKeys, at);
+				GetString(item, "name", at, term.name);
+				const JsonValue_t* type = item.Find("type");
+				if (!type)
+					Error(at, "'type' is required");
+				else
+					ReadTerminalId(*type, at, term.id, known);
+			}
+			else
+				ReadTerminalId(item, at, term.id, known);
+			if (!term.name.empty() && term.id && !known)
+				Error(at, "EL%u is not supported, it can't have a record name", term.id);
+			coupler.terminals.push_back(term);
+		}
+	}
+
+	/* Defaults to the length of the rail, like gen-cmd.py would have generated */
+	if (GetInt(obj, "count", where, 0, 254, v))
+		coupler.count = (int)v;
+	else if (!obj.Find("count"))
+		coupler.count = (int)coupler.terminals.size();
+	for (size_t i = (size_t)std::max(coupler.count, 0); i < coupler.terminals.size(); ++i)
+		if (!coupler.terminals[i].name.empty())
+			Error(where, "terminal %u has a record name but is past 'count' (%d)", (unsigned)i + 1, coupler.count);
+
+	const JsonValue_t* coe = obj.Find("coe");
+	if (coe && coe->type != JsonValue_t::ARRAY)
+		Error(where, "'coe' must be an array");
+	else if (coe) {
+		coupler.coe.resize(coe->items.size());
+		for (size_t i = 0; i < coe->items.size(); ++i) {
+			char buf[32];
+			epicsSnprintf(buf, sizeof(buf), ".coe[%u]", (unsigned)i);
+			ReadCoE(coe->items[i], where + buf, coupler, coupler.coe[i]);
+		}
+	}
+
+	const JsonValue_t* records = obj.Find("records");
+	if (records && records->type == JsonValue_t::BOOLEAN)
+		coupler.records = records->boolean;
+	else if (records && records->type == JsonValue_t::OBJECT) {
+		const std::string at = where + ".records";
+		CheckKeys(*records, recordKeys, at);
+		GetString(*records, "dbDir", at, coupler.dbDir);
+		GetString(*records, "base", at, coupler.recordBase);
+		GetString(*records, "macros", at, coupler.macros);
+		coupler.records = true;
+	}
+	else if (records)
+		Error(where, "'records' must be true, false or an object");
+}
+
+bool ConfigReader::Read(const JsonValue_t& doc, RailConfig_t& config) {
+	static const char* const keys[] = {"pollTime",	  "parallelInit",	  "initTimeout",
+									   "layoutCache", "pdoIntrospection", "couplers",
+									   NULL};
+
+	config.pollTime = -1;
+	config.parallelInit = -1;
+	config.pdoIntrospection = -1;
+	config.initTimeout = 0;
+	config.haveLayoutCache = false;
+
+	if (doc.type != JsonValue_t::OBJECT) {
+		Error("", "must be an object");
+		return false;
+	}
+	CheckKeys(doc, keys, "");
+
+	long long v;
+	bool b;
+	if (GetInt(doc, "pollTime", "", 10, 1000, v))
+		config.pollTime = (int)v;
+	if (GetBool(doc, "parallelInit", "", b))
+		config.parallelInit = b;
+	if (GetBool(doc, "pdoIntrospection", "", b))
+		config.pdoIntrospection = b;
+	GetDouble(doc, "initTimeout", "", config.initTimeout);
+	config.haveLayoutCache = GetString(doc, "layoutCache", "", config.layoutCache);
+
+	const JsonValue_t* couplers = doc.Find("couplers");
+	if (!couplers || couplers->type != JsonValue_t::ARRAY) {
+		Error("", "'couplers' must be an array");
+		return false;
+	}
+
+	config.couplers.resize(couplers->items.size());
+	std::set<std::string> names, addresses;
+	for (size_t i = 0; i < couplers->items.size(); ++i) {
+		char where[32];
+		epicsSnprintf(where, sizeof(where), "couplers[%u]", (unsigned)i);
+		CouplerConfig_t& coupler = config.couplers[i];
+		ReadCoupler(couplers->items[i], where, coupler);
+		if (coupler.name.empty())
+			continue;
+
+		/* Across couplers, and against the ones already configured */
+		if (!names.insert(coupler.name).second || devEK9000::FindDevice(coupler.name.c_str()))
+			Error(where, "coupler '%s' is configured more than once", coupler.name.c_str());
+		char addr[128];
+		epicsSnprintf(addr, sizeof(addr), "%s:%d", coupler.ip.c_str(), coupler.port);
+		if (!coupler.ip.empty() && !addresses.insert(addr).second)
+			Error(where, "%s is used by more than one coupler", addr);
+	}
+	return m_errors == 0;
+}
+
+//-----------------------------------------------------------------//
+
+/* Register the coupler with everything from the file, then bring it up unless parallel init will */
+static devEK9000* ConfigureCoupler(const CouplerConfig_t& coupler) {
+	if (!coupler.terminals.empty()) {
+		std::vector<uint16_t> ids;
+		for (size_t i = 0; i < coupler.terminals.size(); ++i)
+			ids.push_back(coupler.terminals[i].id);
+		devEK9000::DeclareLayout(coupler.name.c_str(), ids);
+	}
+
+	char ip[128];
+	epicsSnprintf(ip, sizeof(ip), "%s:%d", coupler.ip.c_str(), coupler.port);
+	devEK9000* dev = devEK9000::Register(coupler.name.c_str(), ip, coupler.count);
+	if (!dev)
+		return NULL;
+
+	dev->m_watchdogTime = coupler.watchdogTime;
+	dev->m_watchdogType = coupler.watchdogType;
+	dev->m_coePresets = coupler.coe;
+	dev->m_railCheckPeriod = coupler.railCheck > 0 ? coupler.railCheck : 0;
+	dev->m_outputVerifyPeriod = coupler.outputVerify > 0 ? coupler.outputVerify : 0;
+	for (int pos = 1; pos <= coupler.count && pos <= (int)coupler.terminals.size(); ++pos) {
+		const TerminalConfig_t& term = coupler.terminals[pos - 1];
+		if (!term.name.empty())
+			dev->AddTerminal(term.name.c_str(), term.id, pos);
+	}
+
+	if (!devEK9000::parallelInit && !dev->BringUp()) {
+		devEK9000::DetachFailed(dev);
+		return NULL;
+	}
+	return dev;
+}
+
+bool LoadRailConfig(const char* path) {
+	if (interruptAccept) {
+		epicsPrintf("ek9000LoadConfig: couplers can only be configured before iocInit\n");
+		return false;
+	}
+
+	FILE* fp = fopen(path, "r");
+	if (!fp) {
+		epicsPrintf("ek9000LoadConfig: unable to open %s: %s\n", path, strerror(errno));
+		return false;
+	}
+	std::string text;
+	char buf[4096];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+		text.append(buf, n);
+	fclose(fp);
+
+	/* Everything is checked before anything is configured, so a bad file leaves no half configured IOC */
+	JsonValue_t doc;
+	RailConfig_t config;
+	if (!ParseJson(path, text, doc) || !ConfigReader(path).Read(doc, config))
+		return false;
+
+	if (config.pollTime > 0)
+		devEK9000::pollDelay = config.pollTime;
+	if (config.parallelInit >= 0)
+		devEK9000::parallelInit = config.parallelInit != 0;
+	if (config.pdoIntrospection >= 0)
+		devEK9000::pdoIntrospection = config.pdoIntrospection != 0;
+	if (config.initTimeout > 0)
+		devEK9000::parallelInitTimeout = config.initTimeout;
+	if (config.haveLayoutCache)
+		devEK9000::layoutCacheDir = config.layoutCache;
+
+	int failed = 0;
+	for (size_t i = 0; i < config.couplers.size(); ++i) {
+		const CouplerConfig_t& coupler = config.couplers[i];
+		devEK9000* dev = ConfigureCoupler(coupler);
+		if (!dev) {
+			epicsPrintf("ek9000LoadConfig: unable to configure %s\n", coupler.name.c_str());
+			++failed;
+			continue;
+		}
+		if (coupler.records) {
+			std::string dir = coupler.dbDir;
+			if (dir.empty()) {
+				const char* top = getenv("TOP");
+				dir = std::string(top ? top : ".") + "/db";
+			}
+			const std::string base = coupler.recordBase.empty() ? coupler.name + ":" : coupler.recordBase;
+			dev->AutoConfigure(dir.c_str(), base.c_str(), coupler.macros.c_str());
+		}
+	}
+	epicsPrintf("ek9000LoadConfig: configured %u of %u couplers from %s\n", (unsigned)(config.couplers.size() - failed),
+				(unsigned)config.couplers.size(), path);
+	return failed == 0;
+}
@@ -0,0 +1,22 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: ekRailConfig.h
+// Purpose: Loading couplers, terminals and their settings
+//  from a JSON rail description in one pass
+//======================================================//
+#pragma once
+
+/**
+ * Parse and validate the whole file, then configure every coupler in it, as ek9000Configure,
+ * ek9000ConfigureTerminal, ek9000DeclareLayout and friends would. Nothing is configured if any part of the file is
+ * invalid. Must be called before iocInit. See README for the format.
+ */
+bool LoadRailConfig(const char* path);
@@ -14,8 +14,10 @@
 #include <epicsStdio.h>
 #include <epicsStdlib.h>
 #include <epicsString.h>
+#include <cantProceed.h>
 
 #include "devEK9000.h"
+#include "ekOutputGroup.h"
 
 #include "terminal_types.g.h"
 
@@ -31,12 +33,78 @@ struct iocshHandles_t {
 std::vector<iocshHandles_t*> functions;
 
 const terminal_t* util::FindTerminal(unsigned int id) {
-	for (unsigned int i = 0; i < ArraySize(s_terminalInfos); i++)
-		if (s_terminalInfos[i].id == id)
-			return &s_terminalInfos[i];
+	/* s_terminalInfos is sorted by ID */
+	size_t lo = 0, hi = ArraySize(s_terminalInfos);
+	while (lo < hi) {
+		const size_t mid = (lo + hi) / 2;
+		if (s_terminalInfos[mid].id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < ArraySize(s_terminalInfos) && s_terminalInfos[lo].id == id ? &s_terminalInfos[lo] : NULL;
+}
+
+const terminal_t* util::FindTerminalByName(const char* name) {
+	/* Binary search the name index, which is sorted in strcmp order */
+	size_t lo = 0, hi = ArraySize(s_terminalNameIndex);
+	while (lo < hi) {
+		const size_t mid = (lo + hi) / 2;
+		const int cmp = strcmp(s_terminalInfos[s_terminalNameIndex[mid]].str, name);
+		if (cmp == 0)
+			return &s_terminalInfos[s_terminalNameIndex[mid]];
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
 	return NULL;
 }
 
+const TerminalCodec_t* util::FindCodec(unsigned int id) {
+	size_t lo = 0, hi = ArraySize(s_terminalCodecs);
+	while (lo < hi) {
+		const size_t mid = (lo + hi) / 2;
+		if (s_terminalCodecs[mid].id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < ArraySize(s_terminalCodecs) && s_terminalCodecs[lo].id == id ? &s_terminalCodecs[lo] : NULL;
+}
+
+util::Arena::Arena() : m_used(BLOCK_SIZE), m_total(0), m_lock(epicsMutexMustCreate()) {
+}
+
+util::Arena::~Arena() {
+	for (size_t i = 0; i < m_blocks.size(); ++i)
+		free(m_blocks[i]);
+	epicsMutexDestroy(m_lock);
+}
+
+void* util::Arena::Alloc(size_t size) {
+	size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+
+	epicsMutexMustLock(m_lock);
+	char* p;
+	if (size > BLOCK_SIZE / 4) {
+		/* Too big to pack, give it a block of its own but keep filling the current one */
+		p = static_cast<char*>(callocMustSucceed(1, size, "util::Arena::Alloc"));
+		m_blocks.insert(m_blocks.begin(), p);
+	}
+	else {
+		if (m_used + size > BLOCK_SIZE) {
+			m_blocks.push_back(static_cast<char*>(callocMustSucceed(1, BLOCK_SIZE, "util::Arena::Alloc")));
+			m_used = 0;
+		}
+		p = m_blocks.back() + m_used;
+		m_used += size;
+	}
+	m_total += size;
+	epicsMutexUnlock(m_lock);
+	return p;
+}
+
 long util::setupCallback(void* rec, void (*pCallback)(CALLBACK*)) {
 	CALLBACK* callback = (CALLBACK*)calloc(1, sizeof(CALLBACK));
 	*callback = *(CALLBACK*)pCallback;
@@ -50,78 +118,114 @@ long util::setupCallback(void* rec, void (*pCallback)(CALLBACK*)) {
 /**
  * We also handle some backwards compatibility here.
  */
-bool util::setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t& dpvt) {
+static bool isExtraKey(const StrView_t& key, const char* const* extraKeys) {
+	for (; extraKeys && *extraKeys; ++extraKeys)
+		if (key == *extraKeys)
+			return true;
+	return false;
+}
+
+bool util::FindLinkParam(const char* link, const char* key, StrView_t& value) {
+	LinkParser parser(link);
+	while (parser.Next()) {
+		if (parser.Key() == key) {
+			value = parser.Value();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool util::setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t& dpvt, const char* const* extraKeys) {
 	static const char* function = "util::setupCommonDpvt<RecordT>()";
 
-	if (!inp || !util::ParseLinkSpecification(inp, INST_IO, dpvt.linkSpec)) {
+	if (!LinkParser::IsKeyValueLink(inp)) {
 		// This is likely a legacy setup, fallback to old logic
 		devEK9000Terminal* term = NULL;
-		if (!(term = devEK9000Terminal::ProcessRecordName(recName, &dpvt.channel)))
+		int channel = 0;
+		if (!(term = devEK9000Terminal::ProcessRecordName(recName, &channel)))
 			return false;
+		if (!term->m_device->IsUp()) {
+			epicsPrintf("%s (when parsing %s): %s did not come up\n", function, recName, term->m_device->m_name.c_str());
+			return false;
+		}
 		dpvt.pdrv = term->m_device;
 		dpvt.pterm = term;
+		dpvt.channel = channel;
 		dpvt.terminalType = term->m_terminalId;
 		return true;
 	}
 
 	/* Parse the params passed via INST_IO stuff */
-	const int paramCount = dpvt.linkSpec.size();
-	for (int i = 0; i < paramCount; ++i) {
-		std::pair<std::string, std::string>& param = dpvt.linkSpec.at(i);
-
-		/* Device name */
-		if (strcmp(param.first.c_str(), "device") == 0) {
-			bool found = false;
-			std::list<devEK9000*>& devList = GlobalDeviceList();
-			for (std::list<devEK9000*>::iterator x = devList.begin(); x != devList.end(); ++x) {
-				// for (const auto& x : GlobalDeviceList()) {
-				if (strcmp((*x)->m_name.data(), param.second.c_str()) == 0) {
-					dpvt.pdrv = *x;
-					found = true;
+	StrView_t groupName = {NULL, 0};
+	LinkParser parser(inp);
+	while (parser.Next()) {
+		const StrView_t& value = parser.Value();
+		switch (parser.KeyId()) {
+			/* Device name */
+			case LINK_KEY_DEVICE:
+				{
+					char name[256];
+					if (!value.CopyTo(name) || !(dpvt.pdrv = devEK9000::FindDevice(name))) {
+						epicsPrintf("%s (when parsing %s): invalid device name: %.*s\n", function, recName,
+									(int)value.len, value.str);
+						return false;
+					}
 					break;
 				}
-			}
-			if (!found) {
-				epicsPrintf("%s (when parsing %s): invalid device name: %s\n", function, recName, param.second.c_str());
-				return false;
-			}
-		}
-		/* Terminal position in rail (1=first) */
-		else if (strcmp(param.first.c_str(), "pos") == 0) {
-			epicsInt32 term = 0;
-			bool ok = parseNumber(param.second.c_str(), term, 10);
-
-			/* Max supported devices by the EK9K is 255 */
-			if (term < 0 || term > 255 || !ok) {
-				epicsPrintf("%s (when parsing %s): invalid rail position: %i\n", function, recName, term);
-				return false;
-			}
-			dpvt.pos = term;
-		}
-		/* Channel number */
-		else if (strcmp(param.first.c_str(), "channel") == 0) {
-			epicsInt32 channel = 0;
-			bool ok = parseNumber(param.second.c_str(), channel, 10);
-			/* No real max here, but I think it's good to limit this to 8k as nothing has this many channels */
-			if (channel < 0 || channel > 8192 || !ok) {
-				epicsPrintf("%s (when parsing %s): invalid channel: %i\n", function, recName, channel);
-				return false;
-			}
-			dpvt.channel = channel;
-		}
-		/* Terminal type string e.g. EL3064 */
-		else if (strcmp(param.first.c_str(), "type") == 0) {
-			const char* tid = param.second.c_str();
-			if (!strncmp(tid, "EL", 2))
-				tid += 2;
-			if (parseNumber(tid, dpvt.terminalType, 10) == 0) {
-				epicsPrintf("%s (when parsing %s): unable to parse terminal ID from string '%s'\n", function, recName,
-							param.second.c_str());
-				return false;
-			}
-		}
-		else {
-			epicsPrintf("%s (when parsing %s): ignored unknown param %s\n", function, recName, param.first.c_str());
+			/* Terminal position in rail (1=first) */
+			case LINK_KEY_POS:
+				{
+					epicsInt32 term = 0;
+					bool ok = parseNumber(value, term, 10);
+
+					/* Max supported devices by the EK9K is 255 */
+					if (term < 0 || term > 255 || !ok) {
+						epicsPrintf("%s (when parsing %s): invalid rail position: %i\n", function, recName, term);
+						return false;
+					}
+					dpvt.pos = term;
+					break;
+				}
+			/* Channel number */
+			case LINK_KEY_CHANNEL:
+				{
+					epicsInt32 channel = 0;
+					bool ok = parseNumber(value, channel, 10);
+					/* No real max here, but I think it's good to limit this to 8k as nothing has this many channels */
+					if (channel < 0 || channel > 8192 || !ok) {
+						epicsPrintf("%s (when parsing %s): invalid channel: %i\n", function, recName, channel);
+						return false;
+					}
+					dpvt.channel = channel;
+					break;
+				}
+			/* Terminal type string e.g. EL3064 */
+			case LINK_KEY_TYPE:
+				{
+					StrView_t tid = value;
+					if (tid.len >= 2 && !strncmp(tid.str, "EL", 2)) {
+						tid.str += 2;
+						tid.len -= 2;
+					}
+					epicsUInt16 type = 0;
+					if (parseNumber(tid, type, 10) == 0) {
+						epicsPrintf("%s (when parsing %s): unable to parse terminal ID from string '%.*s'\n", function,
+									recName, (int)value.len, value.str);
+						return false;
+					}
+					dpvt.terminalType = type;
+					break;
+				}
+			/* Output group to stage writes into */
+			case LINK_KEY_GROUP:
+				groupName = value;
+				break;
+			default:
+				if (!isExtraKey(parser.Key(), extraKeys))
+					epicsPrintf("%s (when parsing %s): ignored unknown param %.*s\n", function, recName,
+								(int)parser.Key().len, parser.Key().str);
+				break;
 		}
 	}
 
@@ -130,23 +234,47 @@ bool util::setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t&
 		dpvt = TerminalDpvt_t();
 		return false;
 	}
+	/* Failed couplers stay registered for ek9000Attach, but there's no mapping to set the record up against */
+	if (!dpvt.pdrv->IsUp()) {
+		epicsPrintf("%s (when parsing %s): %s did not come up\n", function, recName, dpvt.pdrv->m_name.c_str());
+		dpvt = TerminalDpvt_t();
+		return false;
+	}
+
+	if (groupName.str) {
+		char name[256];
+		if (!groupName.CopyTo(name)) {
+			epicsPrintf("%s (when parsing %s): group name is too long\n", function, recName);
+			dpvt = TerminalDpvt_t();
+			return false;
+		}
+		dpvt.group = dpvt.pdrv->FindOutputGroup(name, true);
+	}
 
 	// TODO: It is likely that we'll need to recompute the coupler's mapping in here if we ever add
 	//  support for alternative PDO mapping types that affect PDO mapping on the device.
 
-	/* Resolve terminal */
-	dpvt.pterm = dpvt.pdrv->TerminalByIndex(dpvt.pos);
-	dpvt.pterm->SetRecordName(recName);
-	dpvt.pterm->Init(dpvt.terminalType, dpvt.pos);
-	if (dpvt.pterm == NULL) {
+	/* Resolve terminal. It's mapped already, so the link only has to agree with the mapping */
+	if (dpvt.pos < 1 || dpvt.pos > dpvt.pdrv->m_numTerms || !(dpvt.pterm = dpvt.pdrv->TerminalByIndex(dpvt.pos))) {
 		epicsPrintf("%s (when parsing %s): unable to find terminal\n", function, recName);
 		dpvt = TerminalDpvt_t();
 		return false;
 	}
+	if (dpvt.terminalType && dpvt.terminalType != dpvt.pterm->m_terminalId) {
+		epicsPrintf("%s (when parsing %s): %s: EL%d at position %u, not EL%u\n", function, recName,
+					devEK9000::ErrorToString(EK_ETERMIDMIS), dpvt.pterm->m_terminalId, dpvt.pos, dpvt.terminalType);
+		dpvt = TerminalDpvt_t();
+		return false;
+	}
+	dpvt.terminalType = dpvt.pterm->m_terminalId;
+	dpvt.pterm->SetRecordName(recName);
 
 	return true;
 }
 
+//-----------------------------------------------------------------//
+// INST_IO link parsing
+
 /**
  * Right now only the INST_IO link type is supported.
  * INST_IO links cannot have any spaces in them, so @1,2,3,5 is valid
@@ -157,35 +285,61 @@ bool util::setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t&
  *
  */
 
-bool util::ParseLinkSpecification(const char* link, int linkType, LinkSpec_t& outSpec) {
-	if (!link || link[0] == '\0')
+struct LinkKeyName_t {
+	const char* name;
+	ELinkKey key;
+};
+
+static const LinkKeyName_t s_linkKeys[] = {
+	{"device", LINK_KEY_DEVICE}, {"pos", LINK_KEY_POS},		  {"channel", LINK_KEY_CHANNEL},
+	{"type", LINK_KEY_TYPE},	 {"group", LINK_KEY_GROUP},	  {"addr", LINK_KEY_ADDR},
+	{"flags", LINK_KEY_FLAGS},	 {"slew", LINK_KEY_SLEW},	  {"high", LINK_KEY_HIGH},
+	{"low", LINK_KEY_LOW},		 {"count", LINK_KEY_COUNT},
+};
+
+bool util::LinkParser::Next() {
+	/* Skip empty tokens */
+	while (*m_pos == ',')
+		++m_pos;
+	if (!*m_pos)
 		return false;
 
-	switch (linkType) {
-		case INST_IO:
-			{
-				char buf[2048];
-				strncpy(buf, link, sizeof(buf));
-				buf[sizeof(buf) - 1] = 0;
-
-				// Tokenize by commas
-				for (char* tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
-					// Split based on equals
-					char* s = strpbrk(tok, "=");
-					if (!s) {
-						outSpec.clear();
-						return false;
-					}
-					*s = 0;
-					s++;
-					outSpec.push_back(std::make_pair(std::string(tok), std::string(s)));
-				}
+	const char* tok = m_pos;
+	const char* eq = NULL;
+	for (; *m_pos && *m_pos != ','; ++m_pos)
+		if (!eq && *m_pos == '=')
+			eq = m_pos;
 
-				return true;
-			}
-		default:
+	if (!eq) {
+		m_key.str = tok;
+		m_key.len = 0;
+		m_value.str = tok;
+		m_value.len = m_pos - tok;
+		m_keyId = LINK_KEY_NONE;
+		return true;
+	}
+
+	m_key.str = tok;
+	m_key.len = eq - tok;
+	m_value.str = eq + 1;
+	m_value.len = m_pos - (eq + 1);
+
+	m_keyId = LINK_KEY_UNKNOWN;
+	for (size_t i = 0; i < ArraySize(s_linkKeys); ++i) {
+		if (m_key == s_linkKeys[i].name) {
+			m_keyId = s_linkKeys[i].key;
 			break;
+		}
 	}
+	return true;
+}
 
-	return false;
+bool util::LinkParser::IsKeyValueLink(const char* link) {
+	if (!link || !*link)
+		return false;
+	LinkParser parser(link);
+	while (parser.Next())
+		if (parser.KeyId() == LINK_KEY_NONE)
+			return false;
+	return true;
 }
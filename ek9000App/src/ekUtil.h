@@ -21,6 +21,7 @@
 #include <epicsMutex.h>
 #include <epicsAtomic.h>
 #include <mbboDirectRecord.h>
+#include <aaoRecord.h>
 #include <asynDriver.h>
 #include <compilerSpecific.h>
 #include <epicsStdlib.h>
@@ -33,6 +34,9 @@
 
 #if __cplusplus >= 201103L
 #include <type_traits>
+#include <unordered_map>
+#else
+#include <map>
 #endif
 
 #include "terminal.h"
@@ -75,19 +79,59 @@ typedef struct {
 	uint16_t m_inputSize;
 } terminal_info_t;
 
-typedef std::pair<std::string, std::string> LinkSpecPair_t;
-typedef std::vector<LinkSpecPair_t> LinkSpec_t;
+/* Buffered input images kept by the poll thread */
+enum EInputImage {
+	INPUT_IMAGE_NONE,
+	INPUT_IMAGE_ANALOG,	 /* Input registers, offset and width in registers */
+	INPUT_IMAGE_DIGITAL, /* Packed discrete inputs, offset and width in bits (width <= 32) */
+	INPUT_IMAGE_DECODED, /* Pre-decoded analog channels, offset is the channel index and width is 1 */
+};
+
+struct TerminalCodec_t;
+
+/* A channel of the decoded analog image */
+struct DecodedInput_t {
+	int32_t value;
+	uint8_t severity; /* epicsAlarmSeverity reported by the terminal's codec */
+};
+
+/**
+ * Where a record's data lives in the coupler's input image. Resolved and bounds checked once in init_record, so reads
+ * are a plain copy out of the image. The record's read_record decodes it. The poll thread keeps the image in the
+ * layout it was mapped with, even after terminals moved on the rail, so this never needs resolving again.
+ */
+struct ReadDescriptor_t {
+	uint8_t image; /* EInputImage */
+	uint8_t pos;   /* Rail position of the terminal, reads fail once it changed */
+	uint16_t width;
+	uint32_t offset;
+};
 
+/**
+ * Common part of every record's dpvt. Dpvts are built on the stack during init_record and then copied into their
+ * coupler's arena (see devEK9000::CommitDpvt), so keep them small: the scan list walks them for every record.
+ */
 struct TerminalDpvt_t {
-	TerminalDpvt_t() : pdrv(NULL), pos(0), pterm(NULL), channel(0), terminalType(0) {
+	TerminalDpvt_t() : pdrv(NULL), pterm(NULL), group(NULL), channel(0), terminalType(0), pos(0) {}
+
+	class devEK9000* pdrv;			   // Pointer to the coupler itself
+	class devEK9000Terminal* pterm;	   // Pointer to the terminal, which contains mappings
+	class devEK9000OutputGroup* group; // Output group this record stages into, NULL to write immediately
+	uint16_t channel;				   // Channel number within the terminal
+	uint16_t terminalType;			   // Terminal type ID (i.e. 3064 from EL3064)
+	uint8_t pos;					   // Position in the rail (first=1)
+};
+
+/* Dpvt of records reading the buffered input image */
+struct InputDpvt_t : public TerminalDpvt_t {
+	InputDpvt_t() {
+		input.image = INPUT_IMAGE_NONE;
+		input.pos = 0;
+		input.width = 0;
+		input.offset = 0;
 	}
 
-	class devEK9000* pdrv;			// Pointer to the coupler itself
-	int pos;						// Position in the rail (first=1)
-	class devEK9000Terminal* pterm; // Pointer to the terminal, which contains mappings
-	int channel;					// Channel number within the terminal
-	LinkSpec_t linkSpec;			// All link parameters
-	int terminalType;				// Terminal type ID (i.e. 3064 from EL3064)
+	ReadDescriptor_t input; // Input image location
 };
 
 // The following macros are for validating terminal_types.g.h against any PDO structs defined in code
@@ -181,6 +225,50 @@ template <class T> struct is_same<T, T> { static bool value; };
 template <class T> bool is_same<T, T>::value = true;
 #endif
 
+/**
+ * Map keyed by name, for lookups that happen once per record. A hash map where we have one, C++03 falls back to an
+ * ordered map.
+ */
+template <class T> struct NameMap {
+#if __cplusplus >= 201103L
+	typedef std::unordered_map<std::string, T> type;
+#else
+	typedef std::map<std::string, T> type;
+#endif
+};
+
+/**
+ * Bump allocator for small objects that live as long as the IOC, i.e. record dpvts. Objects are packed into blocks
+ * next to each other, nothing is freed until the arena itself is destroyed and destructors are never run.
+ */
+class Arena {
+public:
+	Arena();
+	~Arena();
+
+	/* Returns zeroed memory suitably aligned for any dpvt. Never returns NULL */
+	void* Alloc(size_t size);
+
+	size_t BytesUsed() const {
+		return m_total;
+	}
+
+private:
+	/* Not copyable */
+	Arena(const Arena&);
+	Arena& operator=(const Arena&);
+
+	enum {
+		BLOCK_SIZE = 4096,
+		ALIGNMENT = 16
+	};
+
+	std::vector<char*> m_blocks;
+	size_t m_used; /* Bytes used in m_blocks.back() */
+	size_t m_total;
+	epicsMutexId m_lock;
+};
+
 #if __cplusplus >= 202002L
 
 namespace detail
@@ -222,29 +310,122 @@ inline bool DpvtValid(TerminalDpvt_t* dpvt) {
 }
 
 /**
- * @brief Parse a INP string
- * @param link string from INP PV
- * @param linkType Type of link. INST_IO is the only supported type right now.
- * @param outSpec
- * @returns true if the link was parsed successfully
+ * Non-owning view of part of a string, i.e. a key or value of a link. Not NUL terminated, use CopyTo for APIs that want
+ * a C string. Print with "%.*s", (int)view.len, view.str
+ */
+struct StrView_t {
+	const char* str;
+	size_t len;
+
+	bool operator==(const char* other) const {
+		return strncmp(str, other, len) == 0 && other[len] == 0;
+	}
+	bool operator!=(const char* other) const {
+		return !(*this == other);
+	}
+
+	/* Copy into buf and NUL terminate it. Returns false if it doesn't fit */
+	template <size_t N> bool CopyTo(char (&buf)[N]) const {
+		if (len >= N)
+			return false;
+		memcpy(buf, str, len);
+		buf[len] = 0;
+		return true;
+	}
+};
+
+/* Link keys understood by the device supports in this module */
+enum ELinkKey {
+	LINK_KEY_NONE, /* Positional token, there was no '=' */
+	LINK_KEY_UNKNOWN,
+	LINK_KEY_DEVICE,
+	LINK_KEY_POS,
+	LINK_KEY_CHANNEL,
+	LINK_KEY_TYPE,
+	LINK_KEY_GROUP,
+	LINK_KEY_ADDR,
+	LINK_KEY_FLAGS,
+	LINK_KEY_SLEW,
+	LINK_KEY_HIGH,
+	LINK_KEY_LOW,
+	LINK_KEY_COUNT
+};
+
+/**
+ * Reentrant tokenizer for INST_IO links, i.e. @device=EK1,pos=3,channel=1. Keys and values are views into the link
+ * string, which is never modified, and nothing is allocated. Known keys are looked up once, so callers can switch on
+ * KeyId(). Empty tokens are skipped, tokens without an '=' are returned with an empty key and LINK_KEY_NONE, which is
+ * also how positional links (e.g. CoE records) are tokenized.
+ *
+ *	util::LinkParser parser(link);
+ *	while (parser.Next()) {
+ *		switch (parser.KeyId()) {
+ *			case LINK_KEY_DEVICE: ...
+ *		}
+ *	}
  */
-bool ParseLinkSpecification(const char* link, int linkType, LinkSpec_t& outSpec);
+class LinkParser {
+public:
+	explicit LinkParser(const char* link) : m_pos(link ? link : ""), m_keyId(LINK_KEY_NONE) {
+		m_key.str = m_value.str = m_pos;
+		m_key.len = m_value.len = 0;
+	}
+
+	/* Advance to the next token. Returns false at the end of the link */
+	bool Next();
+
+	const StrView_t& Key() const {
+		return m_key;
+	}
+	const StrView_t& Value() const {
+		return m_value;
+	}
+	ELinkKey KeyId() const {
+		return m_keyId;
+	}
+
+	/* Returns true if link is non-empty and every token in it is a key=value pair */
+	static bool IsKeyValueLink(const char* link);
+
+private:
+	const char* m_pos;
+	StrView_t m_key;
+	StrView_t m_value;
+	ELinkKey m_keyId;
+};
 
 /**
  * Look up a terminal by ID and return a structure containing info about it
  */
 const terminal_t* FindTerminal(unsigned int id);
 
+/**
+ * Look up a terminal by name, e.g. "EL3064"
+ */
+const terminal_t* FindTerminalByName(const char* name);
+
+/**
+ * Look up the generated input decoder for a terminal ID. Returns NULL if the terminal is decoded by its device support
+ */
+const TerminalCodec_t* FindCodec(unsigned int id);
+
 /**
  * Call this to setup a callback. Can be used in-place of the read or write functions in the dpvt struct
  */
 long setupCallback(void* rec, void (*pCallback)(CALLBACK*));
 
-inline TerminalDpvt_t* allocDpvt() {
-	return (TerminalDpvt_t*)calloc(1, sizeof(TerminalDpvt_t));
-}
+/**
+ * @brief Setup device private info from a record's link
+ * @param extraKeys NULL terminated list of additional link keys the device support handles itself. These are accepted
+ * without warning, use FindLinkParam to get at them.
+ */
+bool setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t& dpvt, const char* const* extraKeys = NULL);
 
-bool setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t& dpvt);
+/**
+ * Look up the value of a key in a link
+ * @returns false if the key isn't present
+ */
+bool FindLinkParam(const char* link, const char* key, StrView_t& value);
 
 /** The below template code is kinda ugly. I'd like to use if constexpr or concepts for overload resolution (so we don't
  * need to specialize for all output records), but we're bound to C++03 unfortunately! */
@@ -256,18 +437,40 @@ bool setupCommonDpvt(const char* recName, const char* inp, TerminalDpvt_t& dpvt)
  * @param dpvt Where we put the dpvt
  * @returns true if success
  */
-template <RECORD_TYPE RecordT> inline bool setupCommonDpvt(RecordT* prec, TerminalDpvt_t& dpvt) {
-	return setupCommonDpvt(prec->name, prec->inp.value.instio.string, dpvt);
+template <RECORD_TYPE RecordT>
+inline bool setupCommonDpvt(RecordT* prec, TerminalDpvt_t& dpvt, const char* const* extraKeys = NULL) {
+	return setupCommonDpvt(prec->name, prec->inp.value.instio.string, dpvt, extraKeys);
 }
 
-template <> inline bool setupCommonDpvt<boRecord>(boRecord* prec, TerminalDpvt_t& dpvt) {
-	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt);
+template <>
+inline bool setupCommonDpvt<boRecord>(boRecord* prec, TerminalDpvt_t& dpvt, const char* const* extraKeys) {
+	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt, extraKeys);
+}
+template <>
+inline bool setupCommonDpvt<mbboDirectRecord>(mbboDirectRecord* prec, TerminalDpvt_t& dpvt,
+											  const char* const* extraKeys) {
+	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt, extraKeys);
 }
-template <> inline bool setupCommonDpvt<mbboDirectRecord>(mbboDirectRecord* prec, TerminalDpvt_t& dpvt) {
-	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt);
+template <>
+inline bool setupCommonDpvt<aoRecord>(aoRecord* prec, TerminalDpvt_t& dpvt, const char* const* extraKeys) {
+	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt, extraKeys);
 }
-template <> inline bool setupCommonDpvt<aoRecord>(aoRecord* prec, TerminalDpvt_t& dpvt) {
-	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt);
+template <>
+inline bool setupCommonDpvt<aaoRecord>(aaoRecord* prec, TerminalDpvt_t& dpvt, const char* const* extraKeys) {
+	return setupCommonDpvt(prec->name, prec->out.value.instio.string, dpvt, extraKeys);
+}
+
+/**
+ * Analog output terminals that use a signed (int16) representation by default
+ */
+inline bool isAnalogOutputSigned(int id) {
+	if (id <= 4039 && id >= 4030)
+		return true; // EL403X
+	if (id <= 4119 && id >= 4110)
+		return true; // EL411X
+	if (id <= 4139 && id >= 4130)
+		return true; // EL413X
+	return false;
 }
 
 template <NUMERIC_TYPE T> NODISCARD inline bool parseNumber(const char* str, T& out, int base = 10);
@@ -296,6 +499,12 @@ template <> NODISCARD inline bool parseNumber<epicsUInt64>(const char* str, epic
 	return epicsParseUInt64(str, &out, base, NULL) == 0;
 }
 
+/* Same as above for a link value */
+template <NUMERIC_TYPE T> NODISCARD inline bool parseNumber(const StrView_t& str, T& out, int base = 10) {
+	char buf[32];
+	return str.CopyTo(buf) && parseNumber(buf, out, base);
+}
+
 } // namespace util
 
 // Clear pre-C++20 concept hacks
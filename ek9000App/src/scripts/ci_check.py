@@ -52,6 +52,9 @@ SCHEMA = {
                     'dtyp': {
                         'type': 'string'
                     },
+                    'codec': {
+                        'type': 'string'
+                    },
                     'specs': {
                         'type': 'object',
                         'required': ['min', 'max', 'egu', 'representation', 'resolution', 'error'],
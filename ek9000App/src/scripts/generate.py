@@ -22,7 +22,8 @@ JSON SYNTAX:
     "inputs": 2,            // Number of input channels
     "outputs": 0,           // Number of output channels
     "pdo_in_size": 4,       // PDO input size. For Digital terminals, this is COILS. For Analog terms, this is REGISTERS (16-bits per reg)  
-    "pdo_out_size": 0       // PDO output size. Same rules as in_size.
+    "pdo_out_size": 0,      // PDO output size. Same rules as in_size.
+    "codec": "StandardCodec" // Optional. Input decoder from terminal_codec.h, see get_codec for the default
 },
 
 """
@@ -53,6 +54,7 @@ class TerminalType(TypedDict):
     pdo_in_size: int
     pdo_out_size: int
     spec: SpecType
+    codec: str
 
 
 def is_digital(terminal: dict) -> bool:
@@ -60,6 +62,20 @@ def is_digital(terminal: dict) -> bool:
     return 'DigIn' in type or 'DigOut' in type
 
 
+def get_codec(terminal: dict) -> str | None:
+    """
+    Returns the input codec (a struct from terminal_codec.h) used to decode the terminal's channels, or None if the
+    terminal's device support decodes it by hand. Plain analog inputs with one status word and one value per channel
+    default to StandardCodec.
+    """
+    if 'codec' in terminal:
+        return terminal['codec']
+    types = terminal['type'] if isinstance(terminal['type'], list) else [terminal['type']]
+    if 'AnalogIn' in types and terminal['inputs'] > 0 and terminal['pdo_in_size'] == terminal['inputs'] * 2:
+        return 'StandardCodec'
+    return None
+
+
 def load_terminals(file: str) -> list[TerminalType]:
     """
     Loads the terminals.json file, returning a dict
@@ -98,7 +114,7 @@ def write_terminal_header(terms: dict, out: str):
     """
     with open(out, 'w') as fp:
         fp.write('// WARNING: This header was generated by scripts/generate.py! Do not edit!\n\n#pragma once\n\n')
-        fp.write('#include "terminal.h"\n#include "ekUtil.h"\n\n')
+        fp.write('#include "terminal.h"\n#include "terminal_codec.h"\n#include "ekUtil.h"\n\n')
         terminalTypes = []
         for term in terms:
             name = term['name']
@@ -112,31 +128,50 @@ def write_terminal_header(terms: dict, out: str):
                 if term['pdo_out_size'] > 0:
                     checks += '\tstatic void _pdo_output_check();\n'
 
+            # Codec typedef and channel stride for the generated decoders
+            codec = ''
+            if get_codec(term):
+                codec = f'typedef {get_codec(term)} Codec;\n    static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;'
+
             fp.write(
 f"""
-struct {name}_t FINAL : terminal_t {{
+struct {name}_t FINAL {{
     static const uint32_t ID = {name.replace('EL','')};
     static const uint16_t NUM_INPUTS = {term['inputs']};
     static const uint16_t INPUT_SIZE = {term['pdo_in_size']};
     static const uint16_t NUM_OUTPUTS = {term['outputs']};
     static const uint16_t OUTPUT_SIZE = {term['pdo_out_size']};
-    {name}_t() {{
-        str = "{name}";
-        id = ID;
-        numInputs = NUM_INPUTS;
-        numOutputs = NUM_OUTPUTS;
-        inputSize = INPUT_SIZE;
-        outputSize = OUTPUT_SIZE;
-    }}
+    {codec}
     {checks}
 }};\n\n
 """
             )
         
-        # Write out the terminal infos array
-        fp.write('static const terminal_t s_terminalInfos[] = {\n')
-        for type in terminalTypes:
-            fp.write(f'\t{type}_t(),\n')
+        # Write out the terminal infos array. This is constant-initialized (no constructors run at load time) and
+        # sorted by ID, so lookups can binary search it
+        byId = sorted(terms, key=lambda t: int(t['name'].replace('EL', '')))
+        fp.write('/* All supported terminals, sorted by ID */\n')
+        fp.write('CONSTEXPR terminal_t s_terminalInfos[] = {\n')
+        for term in byId:
+            type = f'{term["name"]}_t'
+            fp.write(f'\t{{"{term["name"]}", {type}::ID, {type}::INPUT_SIZE, {type}::NUM_INPUTS, {type}::OUTPUT_SIZE, '
+                     f'{type}::NUM_OUTPUTS}},\n')
+        fp.write('};\n\n')
+
+        # Name index: positions in s_terminalInfos, sorted by name
+        fp.write('/* Indexes into s_terminalInfos, sorted by name (strcmp order) */\n')
+        fp.write('CONSTEXPR uint16_t s_terminalNameIndex[] = {\n')
+        for term in sorted(byId, key=lambda t: t['name'].encode()):
+            fp.write(f'\t{byId.index(term)}, // {term["name"]}\n')
+        fp.write('};\n\n')
+
+        # Write out the decoder dispatch table, sorted by ID so it can be binary searched
+        fp.write('/* Input decoders for terminals with a codec, sorted by ID */\n')
+        fp.write('CONSTEXPR TerminalCodec_t s_terminalCodecs[] = {\n')
+        for term in sorted(terms, key=lambda t: int(t['name'].replace('EL', ''))):
+            if get_codec(term):
+                type = f'{term["name"]}_t'
+                fp.write(f'\t{{{type}::ID, {type}::INPUT_STRIDE, &DecodeChannels<{type}>}},\n')
         fp.write('};\n\n')
         
         # Write out the PDO checks
@@ -11,7 +11,8 @@
 
 #include <stdint.h>
 
-// If you change this struct, be sure to update scripts/generate.py!
+// If you change this struct, be sure to update scripts/generate.py! The generated s_terminalInfos table initializes it
+// as an aggregate, so the field order matters.
 struct terminal_t {
 	// String name of the terminal. e.g. EL3064
 	const char* str;
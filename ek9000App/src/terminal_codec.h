@@ -0,0 +1,219 @@
+/*
+ * This file is part of the EK9000 device support module. It is subject to
+ * the license terms in the LICENSE.txt file found in the top-level directory
+ * of this distribution and at:
+ *    https://confluence.slac.stanford.edu/display/ppareg/LICENSE.html.
+ * No part of the EK9000 device support module, including this file, may be
+ * copied, modified, propagated, or distributed except according to the terms
+ * contained in the LICENSE.txt file.
+ */
+//======================================================//
+// Name: terminal_codec.h
+// Purpose: Input PDO layouts and the codecs that decode
+//  them into a value and an alarm severity
+//======================================================//
+#pragma once
+
+#include <alarm.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ekBits.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Each codec decodes one input channel, given a pointer to its first input register. terminals.json names the codec for
+ * each terminal ("codec"), and scripts/generate.py emits a Codec typedef in the terminal's struct plus an entry in
+ * s_terminalCodecs. Terminals without a codec are decoded by their device support.
+ *
+ * Severities are epicsAlarmSeverity values, so they fit in 2 bits.
+ */
+
+#pragma pack(1)
+// This PDO type applies to EL30XX, EL31XX and EL32XX. For 31XX and 32XX some align bits are interpreted differently.
+struct EL30XXStandardInputPDO_t {
+	uint8_t underrange : 1;
+	uint8_t overrange : 1;
+	uint8_t limit1 : 2;
+	uint8_t limit2 : 2;
+	uint8_t _r1 : 2; // First bit in this align is error for EL31XX
+	uint8_t _r2 : 6; // Last bit in this align is Sync error for EL31XX
+	uint8_t txpdo_state : 1;
+	uint8_t txpdo_toggle : 1;
+	int16_t value; // Must be signed to accommodate bipolar terminals. Unsigned representation still defines range as
+				   // 0-32767, so this is safe.
+};
+
+struct EL36XXInputPDO_t {
+	struct {
+		uint8_t underrange : 1;
+		uint8_t overrange : 1;
+		uint8_t limit1 : 1;
+		uint8_t limit2 : 1;
+		uint8_t _r0 : 4;
+	} status;
+	uint8_t _r1; // Corresponds to some data we don't care about
+	uint32_t inp;
+	uint8_t _r2 : 4;
+	uint8_t sai_mode : 4;
+	uint8_t sai_range;
+};
+
+struct EL5001Status_t {
+	uint8_t data_error : 1;
+	uint8_t frame_error : 1;
+	uint8_t power_fail : 1;
+	uint8_t data_mismatch : 1;
+	uint8_t _r1 : 1;
+	uint8_t sync_err : 1;
+	uint8_t txpdo_state : 1;
+	uint8_t txpdo_toggle : 1;
+};
+
+/* Input data from an el5001 terminal. el5001 from fw11 onwards also supports the EL5002Input_t PDO type  */
+struct EL5001Input_t {
+	union {
+		uint8_t status_byte;
+		EL5001Status_t data;
+	};
+	uint32_t encoder_value;
+	// This is additional padding to keep EL5001Input_t a multiple of 2. The ek9000 rounds up when mapping terminals to
+	// input/holding register space
+	// meaning, if a PDO is 3 bytes, it will be mapped as if it were 4 bytes (2 registers), 5 bytes as if it were 6 and
+	// so on.
+	uint8_t _pad;
+};
+
+/* Input data from an el5002 slave, given it has the extended status byte enabled */
+struct EL5002Input_t {
+	uint8_t data_error : 1;
+	uint8_t frame_error : 1;
+	uint8_t power_fail : 1;
+	uint8_t _r1 : 5;
+	uint8_t _r2;
+	uint32_t encoder_value;
+};
+
+struct EL5042InputPDO_t {
+	uint8_t warning : 1;
+	uint8_t error : 1;
+	uint8_t ready : 1;
+	uint8_t _r1 : 5;
+	uint8_t _r2 : 4;
+	uint8_t diag : 1;
+	uint8_t txpdo_state : 1;
+	uint8_t input_cycle_counter : 2;
+	uint32_t position;
+};
+#pragma pack()
+
+/* Status word + int16 value, the EL30XX/EL31XX/EL32XX/EL331X layout. Over- or underrange is a major alarm */
+struct StandardCodec {
+	static inline void Decode(const uint16_t* src, int32_t& value, uint8_t& severity) {
+		const EL30XXStandardInputPDO_t* pdo = reinterpret_cast<const EL30XXStandardInputPDO_t*>(src);
+		value = pdo->value;
+		severity = (pdo->overrange || pdo->underrange) ? MAJOR_ALARM : NO_ALARM;
+	}
+};
+
+/* The compact PDO EL30XX/EL31XX terminals can be switched to: just the int16 value. No status, so never an alarm */
+struct CompactCodec {
+	static inline void Decode(const uint16_t* src, int32_t& value, uint8_t& severity) {
+		value = static_cast<int16_t>(src[0]);
+		severity = NO_ALARM;
+	}
+};
+
+struct EL36XXCodec {
+	static inline void Decode(const uint16_t* src, int32_t& value, uint8_t& severity) {
+		const EL36XXInputPDO_t* pdo = reinterpret_cast<const EL36XXInputPDO_t*>(src);
+		value = pdo->inp;
+		severity = (pdo->status.overrange || pdo->status.underrange) ? MAJOR_ALARM : NO_ALARM;
+	}
+};
+
+struct EL5001Codec {
+	static inline void Decode(const uint16_t* src, int32_t& value, uint8_t& severity) {
+		const EL5001Input_t* pdo = reinterpret_cast<const EL5001Input_t*>(src);
+		value = pdo->encoder_value;
+		severity = (pdo->data.data_error || pdo->data.sync_err) ? INVALID_ALARM
+				   : pdo->data.frame_error						? MAJOR_ALARM
+																: NO_ALARM;
+	}
+};
+
+struct EL5002Codec {
+	static inline void Decode(const uint16_t* src, int32_t& value, uint8_t& severity) {
+		const EL5002Input_t* pdo = reinterpret_cast<const EL5002Input_t*>(src);
+		value = pdo->encoder_value;
+		severity = pdo->data_error ? INVALID_ALARM : pdo->frame_error ? MAJOR_ALARM : NO_ALARM;
+	}
+};
+
+struct EL5042Codec {
+	static inline void Decode(const uint16_t* src, int32_t& value, uint8_t& severity) {
+		const EL5042InputPDO_t* pdo = reinterpret_cast<const EL5042InputPDO_t*>(src);
+		value = pdo->position;
+		severity = pdo->error ? MAJOR_ALARM : pdo->warning ? MINOR_ALARM : NO_ALARM;
+	}
+};
+
+/**
+ * Decode count consecutive channels, Stride registers apart, starting at src. Severities are packed 2 bits per channel
+ * into severities, starting at channel first.
+ */
+template <class CodecT, unsigned Stride> struct ChannelDecoder {
+	static void Run(const uint16_t* src, size_t count, int32_t* values, uint8_t* severities, size_t first) {
+		for (size_t i = 0; i < count; ++i) {
+			uint8_t severity;
+			CodecT::Decode(src + i * Stride, values[i], severity);
+			bits::SetBits(severities, (first + i) * 2, 2, severity);
+		}
+	}
+};
+
+/* Standard channels are decoded four at a time with SSE2: one channel per 32-bit lane, status in the low half */
+template <> struct ChannelDecoder<StandardCodec, 2> {
+	static void Run(const uint16_t* src, size_t count, int32_t* values, uint8_t* severities, size_t first) {
+		size_t i = 0;
+#if defined(__SSE2__)
+		const __m128i limits = _mm_set1_epi32(0x3); /* underrange | overrange */
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 4 <= count; i += 4) {
+			const __m128i ch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), _mm_srai_epi32(ch, 16));
+			const __m128i ok = _mm_cmpeq_epi32(_mm_and_si128(ch, limits), zero);
+			/* Spread the 4 alarm bits out to MAJOR_ALARM in each 2-bit severity */
+			const unsigned alarms = ~_mm_movemask_ps(_mm_castsi128_ps(ok)) & 0xF;
+			const unsigned spread =
+				((alarms & 0x1) << 1) | ((alarms & 0x2) << 2) | ((alarms & 0x4) << 3) | ((alarms & 0x8) << 4);
+			bits::SetBits(severities, (first + i) * 2, 8, spread);
+		}
+#endif
+		for (; i < count; ++i) {
+			uint8_t severity;
+			StandardCodec::Decode(src + i * 2, values[i], severity);
+			bits::SetBits(severities, (first + i) * 2, 2, severity);
+		}
+	}
+};
+
+typedef void (*ChannelDecoderFn_t)(const uint16_t* src, size_t count, int32_t* values, uint8_t* severities,
+								   size_t first);
+
+/* Decoder for a generated terminal type, with its codec and stride known at compile time */
+template <class TermT>
+void DecodeChannels(const uint16_t* src, size_t count, int32_t* values, uint8_t* severities, size_t first) {
+	ChannelDecoder<typename TermT::Codec, TermT::INPUT_STRIDE>::Run(src, count, values, severities, first);
+}
+
+/* An entry of the generated s_terminalCodecs table, sorted by id */
+struct TerminalCodec_t {
+	uint32_t id;
+	uint16_t stride; /* Input registers per channel */
+	ChannelDecoderFn_t decode;
+};
@@ -3,1920 +3,1377 @@
 #pragma once
 
 #include "terminal.h"
+#include "terminal_codec.h"
 #include "ekUtil.h"
 
-struct EL1001_t FINAL : terminal_t {
+struct EL1001_t FINAL {
 	static const uint32_t ID = 1001;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 1;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1001_t() {
-		str = "EL1001";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1002_t FINAL : terminal_t {
+struct EL1002_t FINAL {
 	static const uint32_t ID = 1002;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1002_t() {
-		str = "EL1002";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1004_t FINAL : terminal_t {
+struct EL1004_t FINAL {
 	static const uint32_t ID = 1004;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1004_t() {
-		str = "EL1004";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1008_t FINAL : terminal_t {
+struct EL1008_t FINAL {
 	static const uint32_t ID = 1008;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1008_t() {
-		str = "EL1008";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1012_t FINAL : terminal_t {
+struct EL1012_t FINAL {
 	static const uint32_t ID = 1012;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1012_t() {
-		str = "EL1012";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1014_t FINAL : terminal_t {
+struct EL1014_t FINAL {
 	static const uint32_t ID = 1014;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1014_t() {
-		str = "EL1014";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1018_t FINAL : terminal_t {
+struct EL1018_t FINAL {
 	static const uint32_t ID = 1018;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1018_t() {
-		str = "EL1018";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1024_t FINAL : terminal_t {
+struct EL1024_t FINAL {
 	static const uint32_t ID = 1024;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1024_t() {
-		str = "EL1024";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1034_t FINAL : terminal_t {
+struct EL1034_t FINAL {
 	static const uint32_t ID = 1034;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1034_t() {
-		str = "EL1034";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1084_t FINAL : terminal_t {
+struct EL1084_t FINAL {
 	static const uint32_t ID = 1084;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1084_t() {
-		str = "EL1084";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1088_t FINAL : terminal_t {
+struct EL1088_t FINAL {
 	static const uint32_t ID = 1088;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1088_t() {
-		str = "EL1088";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1094_t FINAL : terminal_t {
+struct EL1094_t FINAL {
 	static const uint32_t ID = 1094;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1094_t() {
-		str = "EL1094";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1098_t FINAL : terminal_t {
+struct EL1098_t FINAL {
 	static const uint32_t ID = 1098;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1098_t() {
-		str = "EL1098";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1104_t FINAL : terminal_t {
+struct EL1104_t FINAL {
 	static const uint32_t ID = 1104;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1104_t() {
-		str = "EL1104";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1114_t FINAL : terminal_t {
+struct EL1114_t FINAL {
 	static const uint32_t ID = 1114;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1114_t() {
-		str = "EL1114";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1124_t FINAL : terminal_t {
+struct EL1124_t FINAL {
 	static const uint32_t ID = 1124;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1124_t() {
-		str = "EL1124";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1134_t FINAL : terminal_t {
+struct EL1134_t FINAL {
 	static const uint32_t ID = 1134;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1134_t() {
-		str = "EL1134";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1144_t FINAL : terminal_t {
+struct EL1144_t FINAL {
 	static const uint32_t ID = 1144;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1144_t() {
-		str = "EL1144";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1184_t FINAL : terminal_t {
+struct EL1184_t FINAL {
 	static const uint32_t ID = 1184;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1184_t() {
-		str = "EL1184";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1202_t FINAL : terminal_t {
+struct EL1202_t FINAL {
 	static const uint32_t ID = 1202;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1202_t() {
-		str = "EL1202";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1382_t FINAL : terminal_t {
+struct EL1382_t FINAL {
 	static const uint32_t ID = 1382;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1382_t() {
-		str = "EL1382";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1702_t FINAL : terminal_t {
+struct EL1702_t FINAL {
 	static const uint32_t ID = 1702;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1702_t() {
-		str = "EL1702";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1712_t FINAL : terminal_t {
+struct EL1712_t FINAL {
 	static const uint32_t ID = 1712;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1712_t() {
-		str = "EL1712";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1722_t FINAL : terminal_t {
+struct EL1722_t FINAL {
 	static const uint32_t ID = 1722;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1722_t() {
-		str = "EL1722";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1804_t FINAL : terminal_t {
+struct EL1804_t FINAL {
 	static const uint32_t ID = 1804;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1804_t() {
-		str = "EL1804";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1808_t FINAL : terminal_t {
+struct EL1808_t FINAL {
 	static const uint32_t ID = 1808;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1808_t() {
-		str = "EL1808";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1809_t FINAL : terminal_t {
+struct EL1809_t FINAL {
 	static const uint32_t ID = 1809;
 	static const uint16_t NUM_INPUTS = 16;
 	static const uint16_t INPUT_SIZE = 16;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1809_t() {
-		str = "EL1809";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1814_t FINAL : terminal_t {
+struct EL1814_t FINAL {
 	static const uint32_t ID = 1814;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1814_t() {
-		str = "EL1814";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL1819_t FINAL : terminal_t {
+struct EL1819_t FINAL {
 	static const uint32_t ID = 1819;
 	static const uint16_t NUM_INPUTS = 16;
 	static const uint16_t INPUT_SIZE = 16;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL1819_t() {
-		str = "EL1819";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2001_t FINAL : terminal_t {
+struct EL2001_t FINAL {
 	static const uint32_t ID = 2001;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 1;
 	static const uint16_t OUTPUT_SIZE = 1;
-	EL2001_t() {
-		str = "EL2001";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2002_t FINAL : terminal_t {
+struct EL2002_t FINAL {
 	static const uint32_t ID = 2002;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL2002_t() {
-		str = "EL2002";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2004_t FINAL : terminal_t {
+struct EL2004_t FINAL {
 	static const uint32_t ID = 2004;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL2004_t() {
-		str = "EL2004";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2008_t FINAL : terminal_t {
+struct EL2008_t FINAL {
 	static const uint32_t ID = 2008;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL2008_t() {
-		str = "EL2008";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2022_t FINAL : terminal_t {
+struct EL2022_t FINAL {
 	static const uint32_t ID = 2022;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL2022_t() {
-		str = "EL2022";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2024_t FINAL : terminal_t {
+struct EL2024_t FINAL {
 	static const uint32_t ID = 2024;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL2024_t() {
-		str = "EL2024";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2042_t FINAL : terminal_t {
+struct EL2042_t FINAL {
 	static const uint32_t ID = 2042;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL2042_t() {
-		str = "EL2042";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2084_t FINAL : terminal_t {
+struct EL2084_t FINAL {
 	static const uint32_t ID = 2084;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL2084_t() {
-		str = "EL2084";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2088_t FINAL : terminal_t {
+struct EL2088_t FINAL {
 	static const uint32_t ID = 2088;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL2088_t() {
-		str = "EL2088";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2124_t FINAL : terminal_t {
+struct EL2124_t FINAL {
 	static const uint32_t ID = 2124;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL2124_t() {
-		str = "EL2124";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2794_t FINAL : terminal_t {
+struct EL2794_t FINAL {
 	static const uint32_t ID = 2794;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL2794_t() {
-		str = "EL2794";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2808_t FINAL : terminal_t {
+struct EL2808_t FINAL {
 	static const uint32_t ID = 2808;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL2808_t() {
-		str = "EL2808";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL2816_t FINAL : terminal_t {
+struct EL2816_t FINAL {
 	static const uint32_t ID = 2816;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 16;
 	static const uint16_t OUTPUT_SIZE = 16;
-	EL2816_t() {
-		str = "EL2816";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 };
 
-struct EL3001_t FINAL : terminal_t {
+struct EL3001_t FINAL {
 	static const uint32_t ID = 3001;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3001_t() {
-		str = "EL3001";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3002_t FINAL : terminal_t {
+struct EL3002_t FINAL {
 	static const uint32_t ID = 3002;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3002_t() {
-		str = "EL3002";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3004_t FINAL : terminal_t {
+struct EL3004_t FINAL {
 	static const uint32_t ID = 3004;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3004_t() {
-		str = "EL3004";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3008_t FINAL : terminal_t {
+struct EL3008_t FINAL {
 	static const uint32_t ID = 3008;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 16;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3008_t() {
-		str = "EL3008";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3012_t FINAL : terminal_t {
+struct EL3012_t FINAL {
 	static const uint32_t ID = 3012;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3012_t() {
-		str = "EL3012";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3014_t FINAL : terminal_t {
+struct EL3014_t FINAL {
 	static const uint32_t ID = 3014;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3014_t() {
-		str = "EL3014";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3021_t FINAL : terminal_t {
+struct EL3021_t FINAL {
 	static const uint32_t ID = 3021;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3021_t() {
-		str = "EL3021";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3022_t FINAL : terminal_t {
+struct EL3022_t FINAL {
 	static const uint32_t ID = 3022;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3022_t() {
-		str = "EL3022";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3024_t FINAL : terminal_t {
+struct EL3024_t FINAL {
 	static const uint32_t ID = 3024;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3024_t() {
-		str = "EL3024";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3041_t FINAL : terminal_t {
+struct EL3041_t FINAL {
 	static const uint32_t ID = 3041;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3041_t() {
-		str = "EL3041";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3042_t FINAL : terminal_t {
+struct EL3042_t FINAL {
 	static const uint32_t ID = 3042;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3042_t() {
-		str = "EL3042";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3044_t FINAL : terminal_t {
+struct EL3044_t FINAL {
 	static const uint32_t ID = 3044;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3044_t() {
-		str = "EL3044";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3048_t FINAL : terminal_t {
+struct EL3048_t FINAL {
 	static const uint32_t ID = 3048;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 16;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3048_t() {
-		str = "EL3048";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3051_t FINAL : terminal_t {
+struct EL3051_t FINAL {
 	static const uint32_t ID = 3051;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3051_t() {
-		str = "EL3051";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3052_t FINAL : terminal_t {
+struct EL3052_t FINAL {
 	static const uint32_t ID = 3052;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3052_t() {
-		str = "EL3052";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3054_t FINAL : terminal_t {
+struct EL3054_t FINAL {
 	static const uint32_t ID = 3054;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3054_t() {
-		str = "EL3054";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3058_t FINAL : terminal_t {
+struct EL3058_t FINAL {
 	static const uint32_t ID = 3058;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 16;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3058_t() {
-		str = "EL3058";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3061_t FINAL : terminal_t {
+struct EL3061_t FINAL {
 	static const uint32_t ID = 3061;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3061_t() {
-		str = "EL3061";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3062_t FINAL : terminal_t {
+struct EL3062_t FINAL {
 	static const uint32_t ID = 3062;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3062_t() {
-		str = "EL3062";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3064_t FINAL : terminal_t {
+struct EL3064_t FINAL {
 	static const uint32_t ID = 3064;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3064_t() {
-		str = "EL3064";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3068_t FINAL : terminal_t {
+struct EL3068_t FINAL {
 	static const uint32_t ID = 3068;
 	static const uint16_t NUM_INPUTS = 8;
 	static const uint16_t INPUT_SIZE = 16;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3068_t() {
-		str = "EL3068";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3101_t FINAL : terminal_t {
+struct EL3101_t FINAL {
 	static const uint32_t ID = 3101;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3101_t() {
-		str = "EL3101";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3102_t FINAL : terminal_t {
+struct EL3102_t FINAL {
 	static const uint32_t ID = 3102;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3102_t() {
-		str = "EL3102";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3104_t FINAL : terminal_t {
+struct EL3104_t FINAL {
 	static const uint32_t ID = 3104;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3104_t() {
-		str = "EL3104";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3111_t FINAL : terminal_t {
+struct EL3111_t FINAL {
 	static const uint32_t ID = 3111;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3111_t() {
-		str = "EL3111";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3112_t FINAL : terminal_t {
+struct EL3112_t FINAL {
 	static const uint32_t ID = 3112;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3112_t() {
-		str = "EL3112";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3114_t FINAL : terminal_t {
+struct EL3114_t FINAL {
 	static const uint32_t ID = 3114;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3114_t() {
-		str = "EL3114";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3121_t FINAL : terminal_t {
+struct EL3121_t FINAL {
 	static const uint32_t ID = 3121;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3121_t() {
-		str = "EL3121";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3122_t FINAL : terminal_t {
+struct EL3122_t FINAL {
 	static const uint32_t ID = 3122;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3122_t() {
-		str = "EL3122";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3124_t FINAL : terminal_t {
+struct EL3124_t FINAL {
 	static const uint32_t ID = 3124;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3124_t() {
-		str = "EL3124";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3141_t FINAL : terminal_t {
+struct EL3141_t FINAL {
 	static const uint32_t ID = 3141;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3141_t() {
-		str = "EL3141";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3142_t FINAL : terminal_t {
+struct EL3142_t FINAL {
 	static const uint32_t ID = 3142;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3142_t() {
-		str = "EL3142";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3144_t FINAL : terminal_t {
+struct EL3144_t FINAL {
 	static const uint32_t ID = 3144;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3144_t() {
-		str = "EL3144";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3151_t FINAL : terminal_t {
+struct EL3151_t FINAL {
 	static const uint32_t ID = 3151;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3151_t() {
-		str = "EL3151";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3152_t FINAL : terminal_t {
+struct EL3152_t FINAL {
 	static const uint32_t ID = 3152;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3152_t() {
-		str = "EL3152";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3154_t FINAL : terminal_t {
+struct EL3154_t FINAL {
 	static const uint32_t ID = 3154;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3154_t() {
-		str = "EL3154";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3161_t FINAL : terminal_t {
+struct EL3161_t FINAL {
 	static const uint32_t ID = 3161;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3161_t() {
-		str = "EL3161";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3162_t FINAL : terminal_t {
+struct EL3162_t FINAL {
 	static const uint32_t ID = 3162;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3162_t() {
-		str = "EL3162";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3164_t FINAL : terminal_t {
+struct EL3164_t FINAL {
 	static const uint32_t ID = 3164;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3164_t() {
-		str = "EL3164";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3174_t FINAL : terminal_t {
+struct EL3174_t FINAL {
 	static const uint32_t ID = 3174;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3174_t() {
-		str = "EL3174";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3202_t FINAL : terminal_t {
+struct EL3202_t FINAL {
 	static const uint32_t ID = 3202;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3202_t() {
-		str = "EL3202";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3314_t FINAL : terminal_t {
+struct EL3314_t FINAL {
 	static const uint32_t ID = 3314;
 	static const uint16_t NUM_INPUTS = 4;
 	static const uint16_t INPUT_SIZE = 8;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3314_t() {
-		str = "EL3314";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3312_t FINAL : terminal_t {
+struct EL3312_t FINAL {
 	static const uint32_t ID = 3312;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3312_t() {
-		str = "EL3312";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3311_t FINAL : terminal_t {
+struct EL3311_t FINAL {
 	static const uint32_t ID = 3311;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 2;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL3311_t() {
-		str = "EL3311";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef StandardCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL3681_t FINAL : terminal_t {
+struct EL3681_t FINAL {
 	static const uint32_t ID = 3681;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 4;
 	static const uint16_t NUM_OUTPUTS = 1;
 	static const uint16_t OUTPUT_SIZE = 1;
-	EL3681_t() {
-		str = "EL3681";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef EL36XXCodec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 	static void _pdo_output_check();
 };
 
-struct EL4001_t FINAL : terminal_t {
+struct EL4001_t FINAL {
 	static const uint32_t ID = 4001;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 1;
 	static const uint16_t OUTPUT_SIZE = 1;
-	EL4001_t() {
-		str = "EL4001";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4002_t FINAL : terminal_t {
+struct EL4002_t FINAL {
 	static const uint32_t ID = 4002;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4002_t() {
-		str = "EL4002";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4004_t FINAL : terminal_t {
+struct EL4004_t FINAL {
 	static const uint32_t ID = 4004;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4004_t() {
-		str = "EL4004";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4008_t FINAL : terminal_t {
+struct EL4008_t FINAL {
 	static const uint32_t ID = 4008;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL4008_t() {
-		str = "EL4008";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4011_t FINAL : terminal_t {
+struct EL4011_t FINAL {
 	static const uint32_t ID = 4011;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 1;
 	static const uint16_t OUTPUT_SIZE = 1;
-	EL4011_t() {
-		str = "EL4011";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4012_t FINAL : terminal_t {
+struct EL4012_t FINAL {
 	static const uint32_t ID = 4012;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4012_t() {
-		str = "EL4012";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4014_t FINAL : terminal_t {
+struct EL4014_t FINAL {
 	static const uint32_t ID = 4014;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4014_t() {
-		str = "EL4014";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4018_t FINAL : terminal_t {
+struct EL4018_t FINAL {
 	static const uint32_t ID = 4018;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL4018_t() {
-		str = "EL4018";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4021_t FINAL : terminal_t {
+struct EL4021_t FINAL {
 	static const uint32_t ID = 4021;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 1;
 	static const uint16_t OUTPUT_SIZE = 1;
-	EL4021_t() {
-		str = "EL4021";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4022_t FINAL : terminal_t {
+struct EL4022_t FINAL {
 	static const uint32_t ID = 4022;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4022_t() {
-		str = "EL4022";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4024_t FINAL : terminal_t {
+struct EL4024_t FINAL {
 	static const uint32_t ID = 4024;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4024_t() {
-		str = "EL4024";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4028_t FINAL : terminal_t {
+struct EL4028_t FINAL {
 	static const uint32_t ID = 4028;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL4028_t() {
-		str = "EL4028";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4031_t FINAL : terminal_t {
+struct EL4031_t FINAL {
 	static const uint32_t ID = 4031;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 1;
 	static const uint16_t OUTPUT_SIZE = 1;
-	EL4031_t() {
-		str = "EL4031";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4032_t FINAL : terminal_t {
+struct EL4032_t FINAL {
 	static const uint32_t ID = 4032;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4032_t() {
-		str = "EL4032";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4034_t FINAL : terminal_t {
+struct EL4034_t FINAL {
 	static const uint32_t ID = 4034;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4034_t() {
-		str = "EL4034";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4038_t FINAL : terminal_t {
+struct EL4038_t FINAL {
 	static const uint32_t ID = 4038;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 8;
 	static const uint16_t OUTPUT_SIZE = 8;
-	EL4038_t() {
-		str = "EL4038";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4102_t FINAL : terminal_t {
+struct EL4102_t FINAL {
 	static const uint32_t ID = 4102;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4102_t() {
-		str = "EL4102";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4104_t FINAL : terminal_t {
+struct EL4104_t FINAL {
 	static const uint32_t ID = 4104;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4104_t() {
-		str = "EL4104";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4114_t FINAL : terminal_t {
+struct EL4114_t FINAL {
 	static const uint32_t ID = 4114;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4114_t() {
-		str = "EL4114";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4112_t FINAL : terminal_t {
+struct EL4112_t FINAL {
 	static const uint32_t ID = 4112;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4112_t() {
-		str = "EL4112";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4134_t FINAL : terminal_t {
+struct EL4134_t FINAL {
 	static const uint32_t ID = 4134;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 4;
 	static const uint16_t OUTPUT_SIZE = 4;
-	EL4134_t() {
-		str = "EL4134";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4132_t FINAL : terminal_t {
+struct EL4132_t FINAL {
 	static const uint32_t ID = 4132;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4132_t() {
-		str = "EL4132";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL4122_t FINAL : terminal_t {
+struct EL4122_t FINAL {
 	static const uint32_t ID = 4122;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 0;
 	static const uint16_t NUM_OUTPUTS = 2;
 	static const uint16_t OUTPUT_SIZE = 2;
-	EL4122_t() {
-		str = "EL4122";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_output_check();
 };
 
-struct EL5001_t FINAL : terminal_t {
+struct EL5001_t FINAL {
 	static const uint32_t ID = 5001;
 	static const uint16_t NUM_INPUTS = 1;
 	static const uint16_t INPUT_SIZE = 3;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL5001_t() {
-		str = "EL5001";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef EL5001Codec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL5002_t FINAL : terminal_t {
+struct EL5002_t FINAL {
 	static const uint32_t ID = 5002;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 6;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL5002_t() {
-		str = "EL5002";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef EL5002Codec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL5042_t FINAL : terminal_t {
+struct EL5042_t FINAL {
 	static const uint32_t ID = 5042;
 	static const uint16_t NUM_INPUTS = 2;
 	static const uint16_t INPUT_SIZE = 6;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 0;
-	EL5042_t() {
-		str = "EL5042";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
+	typedef EL5042Codec Codec;
+	static const uint16_t INPUT_STRIDE = INPUT_SIZE / NUM_INPUTS;
 	static void _pdo_input_check();
 };
 
-struct EL7047_t FINAL : terminal_t {
+struct EL7047_t FINAL {
 	static const uint32_t ID = 7047;
 	static const uint16_t NUM_INPUTS = 0;
 	static const uint16_t INPUT_SIZE = 14;
 	static const uint16_t NUM_OUTPUTS = 0;
 	static const uint16_t OUTPUT_SIZE = 14;
-	EL7047_t() {
-		str = "EL7047";
-		id = ID;
-		numInputs = NUM_INPUTS;
-		numOutputs = NUM_OUTPUTS;
-		inputSize = INPUT_SIZE;
-		outputSize = OUTPUT_SIZE;
-	}
 	static void _pdo_input_check();
 	static void _pdo_output_check();
 };
 
-static const terminal_t s_terminalInfos[] = {
-	EL1001_t(), EL1002_t(), EL1004_t(), EL1008_t(), EL1012_t(), EL1014_t(), EL1018_t(), EL1024_t(), EL1034_t(),
-	EL1084_t(), EL1088_t(), EL1094_t(), EL1098_t(), EL1104_t(), EL1114_t(), EL1124_t(), EL1134_t(), EL1144_t(),
-	EL1184_t(), EL1202_t(), EL1382_t(), EL1702_t(), EL1712_t(), EL1722_t(), EL1804_t(), EL1808_t(), EL1809_t(),
-	EL1814_t(), EL1819_t(), EL2001_t(), EL2002_t(), EL2004_t(), EL2008_t(), EL2022_t(), EL2024_t(), EL2042_t(),
-	EL2084_t(), EL2088_t(), EL2124_t(), EL2794_t(), EL2808_t(), EL2816_t(), EL3001_t(), EL3002_t(), EL3004_t(),
-	EL3008_t(), EL3012_t(), EL3014_t(), EL3021_t(), EL3022_t(), EL3024_t(), EL3041_t(), EL3042_t(), EL3044_t(),
-	EL3048_t(), EL3051_t(), EL3052_t(), EL3054_t(), EL3058_t(), EL3061_t(), EL3062_t(), EL3064_t(), EL3068_t(),
-	EL3101_t(), EL3102_t(), EL3104_t(), EL3111_t(), EL3112_t(), EL3114_t(), EL3121_t(), EL3122_t(), EL3124_t(),
-	EL3141_t(), EL3142_t(), EL3144_t(), EL3151_t(), EL3152_t(), EL3154_t(), EL3161_t(), EL3162_t(), EL3164_t(),
-	EL3174_t(), EL3202_t(), EL3314_t(), EL3312_t(), EL3311_t(), EL3681_t(), EL4001_t(), EL4002_t(), EL4004_t(),
-	EL4008_t(), EL4011_t(), EL4012_t(), EL4014_t(), EL4018_t(), EL4021_t(), EL4022_t(), EL4024_t(), EL4028_t(),
-	EL4031_t(), EL4032_t(), EL4034_t(), EL4038_t(), EL4102_t(), EL4104_t(), EL4114_t(), EL4112_t(), EL4134_t(),
-	EL4132_t(), EL4122_t(), EL5001_t(), EL5002_t(), EL5042_t(), EL7047_t(),
+/* All supported terminals, sorted by ID */
+CONSTEXPR terminal_t s_terminalInfos[] = {
+	{"EL1001", EL1001_t::ID, EL1001_t::INPUT_SIZE, EL1001_t::NUM_INPUTS, EL1001_t::OUTPUT_SIZE, EL1001_t::NUM_OUTPUTS},
+	{"EL1002", EL1002_t::ID, EL1002_t::INPUT_SIZE, EL1002_t::NUM_INPUTS, EL1002_t::OUTPUT_SIZE, EL1002_t::NUM_OUTPUTS},
+	{"EL1004", EL1004_t::ID, EL1004_t::INPUT_SIZE, EL1004_t::NUM_INPUTS, EL1004_t::OUTPUT_SIZE, EL1004_t::NUM_OUTPUTS},
+	{"EL1008", EL1008_t::ID, EL1008_t::INPUT_SIZE, EL1008_t::NUM_INPUTS, EL1008_t::OUTPUT_SIZE, EL1008_t::NUM_OUTPUTS},
+	{"EL1012", EL1012_t::ID, EL1012_t::INPUT_SIZE, EL1012_t::NUM_INPUTS, EL1012_t::OUTPUT_SIZE, EL1012_t::NUM_OUTPUTS},
+	{"EL1014", EL1014_t::ID, EL1014_t::INPUT_SIZE, EL1014_t::NUM_INPUTS, EL1014_t::OUTPUT_SIZE, EL1014_t::NUM_OUTPUTS},
+	{"EL1018", EL1018_t::ID, EL1018_t::INPUT_SIZE, EL1018_t::NUM_INPUTS, EL1018_t::OUTPUT_SIZE, EL1018_t::NUM_OUTPUTS},
+	{"EL1024", EL1024_t::ID, EL1024_t::INPUT_SIZE, EL1024_t::NUM_INPUTS, EL1024_t::OUTPUT_SIZE, EL1024_t::NUM_OUTPUTS},
+	{"EL1034", EL1034_t::ID, EL1034_t::INPUT_SIZE, EL1034_t::NUM_INPUTS, EL1034_t::OUTPUT_SIZE, EL1034_t::NUM_OUTPUTS},
+	{"EL1084", EL1084_t::ID, EL1084_t::INPUT_SIZE, EL1084_t::NUM_INPUTS, EL1084_t::OUTPUT_SIZE, EL1084_t::NUM_OUTPUTS},
+	{"EL1088", EL1088_t::ID, EL1088_t::INPUT_SIZE, EL1088_t::NUM_INPUTS, EL1088_t::OUTPUT_SIZE, EL1088_t::NUM_OUTPUTS},
+	{"EL1094", EL1094_t::ID, EL1094_t::INPUT_SIZE, EL1094_t::NUM_INPUTS, EL1094_t::OUTPUT_SIZE, EL1094_t::NUM_OUTPUTS},
+	{"EL1098", EL1098_t::ID, EL1098_t::INPUT_SIZE, EL1098_t::NUM_INPUTS, EL1098_t::OUTPUT_SIZE, EL1098_t::NUM_OUTPUTS},
+	{"EL1104", EL1104_t::ID, EL1104_t::INPUT_SIZE, EL1104_t::NUM_INPUTS, EL1104_t::OUTPUT_SIZE, EL1104_t::NUM_OUTPUTS},
+	{"EL1114", EL1114_t::ID, EL1114_t::INPUT_SIZE, EL1114_t::NUM_INPUTS, EL1114_t::OUTPUT_SIZE, EL1114_t::NUM_OUTPUTS},
+	{"EL1124", EL1124_t::ID, EL1124_t::INPUT_SIZE, EL1124_t::NUM_INPUTS, EL1124_t::OUTPUT_SIZE, EL1124_t::NUM_OUTPUTS},
+	{"EL1134", EL1134_t::ID, EL1134_t::INPUT_SIZE, EL1134_t::NUM_INPUTS, EL1134_t::OUTPUT_SIZE, EL1134_t::NUM_OUTPUTS},
+	{"EL1144", EL1144_t::ID, EL1144_t::INPUT_SIZE, EL1144_t::NUM_INPUTS, EL1144_t::OUTPUT_SIZE, EL1144_t::NUM_OUTPUTS},
+	{"EL1184", EL1184_t::ID, EL1184_t::INPUT_SIZE, EL1184_t::NUM_INPUTS, EL1184_t::OUTPUT_SIZE, EL1184_t::NUM_OUTPUTS},
+	{"EL1202", EL1202_t::ID, EL1202_t::INPUT_SIZE, EL1202_t::NUM_INPUTS, EL1202_t::OUTPUT_SIZE, EL1202_t::NUM_OUTPUTS},
+	{"EL1382", EL1382_t::ID, EL1382_t::INPUT_SIZE, EL1382_t::NUM_INPUTS, EL1382_t::OUTPUT_SIZE, EL1382_t::NUM_OUTPUTS},
+	{"EL1702", EL1702_t::ID, EL1702_t::INPUT_SIZE, EL1702_t::NUM_INPUTS, EL1702_t::OUTPUT_SIZE, EL1702_t::NUM_OUTPUTS},
+	{"EL1712", EL1712_t::ID, EL1712_t::INPUT_SIZE, EL1712_t::NUM_INPUTS, EL1712_t::OUTPUT_SIZE, EL1712_t::NUM_OUTPUTS},
+	{"EL1722", EL1722_t::ID, EL1722_t::INPUT_SIZE, EL1722_t::NUM_INPUTS, EL1722_t::OUTPUT_SIZE, EL1722_t::NUM_OUTPUTS},
+	{"EL1804", EL1804_t::ID, EL1804_t::INPUT_SIZE, EL1804_t::NUM_INPUTS, EL1804_t::OUTPUT_SIZE, EL1804_t::NUM_OUTPUTS},
+	{"EL1808", EL1808_t::ID, EL1808_t::INPUT_SIZE, EL1808_t::NUM_INPUTS, EL1808_t::OUTPUT_SIZE, EL1808_t::NUM_OUTPUTS},
+	{"EL1809", EL1809_t::ID, EL1809_t::INPUT_SIZE, EL1809_t::NUM_INPUTS, EL1809_t::OUTPUT_SIZE, EL1809_t::NUM_OUTPUTS},
+	{"EL1814", EL1814_t::ID, EL1814_t::INPUT_SIZE, EL1814_t::NUM_INPUTS, EL1814_t::OUTPUT_SIZE, EL1814_t::NUM_OUTPUTS},
+	{"EL1819", EL1819_t::ID, EL1819_t::INPUT_SIZE, EL1819_t::NUM_INPUTS, EL1819_t::OUTPUT_SIZE, EL1819_t::NUM_OUTPUTS},
+	{"EL2001", EL2001_t::ID, EL2001_t::INPUT_SIZE, EL2001_t::NUM_INPUTS, EL2001_t::OUTPUT_SIZE, EL2001_t::NUM_OUTPUTS},
+	{"EL2002", EL2002_t::ID, EL2002_t::INPUT_SIZE, EL2002_t::NUM_INPUTS, EL2002_t::OUTPUT_SIZE, EL2002_t::NUM_OUTPUTS},
+	{"EL2004", EL2004_t::ID, EL2004_t::INPUT_SIZE, EL2004_t::NUM_INPUTS, EL2004_t::OUTPUT_SIZE, EL2004_t::NUM_OUTPUTS},
+	{"EL2008", EL2008_t::ID, EL2008_t::INPUT_SIZE, EL2008_t::NUM_INPUTS, EL2008_t::OUTPUT_SIZE, EL2008_t::NUM_OUTPUTS},
+	{"EL2022", EL2022_t::ID, EL2022_t::INPUT_SIZE, EL2022_t::NUM_INPUTS, EL2022_t::OUTPUT_SIZE, EL2022_t::NUM_OUTPUTS},
+	{"EL2024", EL2024_t::ID, EL2024_t::INPUT_SIZE, EL2024_t::NUM_INPUTS, EL2024_t::OUTPUT_SIZE, EL2024_t::NUM_OUTPUTS},
+	{"EL2042", EL2042_t::ID, EL2042_t::INPUT_SIZE, EL2042_t::NUM_INPUTS, EL2042_t::OUTPUT_SIZE, EL2042_t::NUM_OUTPUTS},
+	{"EL2084", EL2084_t::ID, EL2084_t::INPUT_SIZE, EL2084_t::NUM_INPUTS, EL2084_t::OUTPUT_SIZE, EL2084_t::NUM_OUTPUTS},
+	{"EL2088", EL2088_t::ID, EL2088_t::INPUT_SIZE, EL2088_t::NUM_INPUTS, EL2088_t::OUTPUT_SIZE, EL2088_t::NUM_OUTPUTS},
+	{"EL2124", EL2124_t::ID, EL2124_t::INPUT_SIZE, EL2124_t::NUM_INPUTS, EL2124_t::OUTPUT_SIZE, EL2124_t::NUM_OUTPUTS},
+	{"EL2794", EL2794_t::ID, EL2794_t::INPUT_SIZE, EL2794_t::NUM_INPUTS, EL2794_t::OUTPUT_SIZE, EL2794_t::NUM_OUTPUTS},
+	{"EL2808", EL2808_t::ID, EL2808_t::INPUT_SIZE, EL2808_t::NUM_INPUTS, EL2808_t::OUTPUT_SIZE, EL2808_t::NUM_OUTPUTS},
+	{"EL2816", EL2816_t::ID, EL2816_t::INPUT_SIZE, EL2816_t::NUM_INPUTS, EL2816_t::OUTPUT_SIZE, EL2816_t::NUM_OUTPUTS},
+	{"EL3001", EL3001_t::ID, EL3001_t::INPUT_SIZE, EL3001_t::NUM_INPUTS, EL3001_t::OUTPUT_SIZE, EL3001_t::NUM_OUTPUTS},
+	{"EL3002", EL3002_t::ID, EL3002_t::INPUT_SIZE, EL3002_t::NUM_INPUTS, EL3002_t::OUTPUT_SIZE, EL3002_t::NUM_OUTPUTS},
+	{"EL3004", EL3004_t::ID, EL3004_t::INPUT_SIZE, EL3004_t::NUM_INPUTS, EL3004_t::OUTPUT_SIZE, EL3004_t::NUM_OUTPUTS},
+	{"EL3008", EL3008_t::ID, EL3008_t::INPUT_SIZE, EL3008_t::NUM_INPUTS, EL3008_t::OUTPUT_SIZE, EL3008_t::NUM_OUTPUTS},
+	{"EL3012", EL3012_t::ID, EL3012_t::INPUT_SIZE, EL3012_t::NUM_INPUTS, EL3012_t::OUTPUT_SIZE, EL3012_t::NUM_OUTPUTS},
+	{"EL3014", EL3014_t::ID, EL3014_t::INPUT_SIZE, EL3014_t::NUM_INPUTS, EL3014_t::OUTPUT_SIZE, EL3014_t::NUM_OUTPUTS},
+	{"EL3021", EL3021_t::ID, EL3021_t::INPUT_SIZE, EL3021_t::NUM_INPUTS, EL3021_t::OUTPUT_SIZE, EL3021_t::NUM_OUTPUTS},
+	{"EL3022", EL3022_t::ID, EL3022_t::INPUT_SIZE, EL3022_t::NUM_INPUTS, EL3022_t::OUTPUT_SIZE, EL3022_t::NUM_OUTPUTS},
+	{"EL3024", EL3024_t::ID, EL3024_t::INPUT_SIZE, EL3024_t::NUM_INPUTS, EL3024_t::OUTPUT_SIZE, EL3024_t::NUM_OUTPUTS},
+	{"EL3041", EL3041_t::ID, EL3041_t::INPUT_SIZE, EL3041_t::NUM_INPUTS, EL3041_t::OUTPUT_SIZE, EL3041_t::NUM_OUTPUTS},
+	{"EL3042", EL3042_t::ID, EL3042_t::INPUT_SIZE, EL3042_t::NUM_INPUTS, EL3042_t::OUTPUT_SIZE, EL3042_t::NUM_OUTPUTS},
+	{"EL3044", EL3044_t::ID, EL3044_t::INPUT_SIZE, EL3044_t::NUM_INPUTS, EL3044_t::OUTPUT_SIZE, EL3044_t::NUM_OUTPUTS},
+	{"EL3048", EL3048_t::ID, EL3048_t::INPUT_SIZE, EL3048_t::NUM_INPUTS, EL3048_t::OUTPUT_SIZE, EL3048_t::NUM_OUTPUTS},
+	{"EL3051", EL3051_t::ID, EL3051_t::INPUT_SIZE, EL3051_t::NUM_INPUTS, EL3051_t::OUTPUT_SIZE, EL3051_t::NUM_OUTPUTS},
+	{"EL3052", EL3052_t::ID, EL3052_t::INPUT_SIZE, EL3052_t::NUM_INPUTS, EL3052_t::OUTPUT_SIZE, EL3052_t::NUM_OUTPUTS},
+	{"EL3054", EL3054_t::ID, EL3054_t::INPUT_SIZE, EL3054_t::NUM_INPUTS, EL3054_t::OUTPUT_SIZE, EL3054_t::NUM_OUTPUTS},
+	{"EL3058", EL3058_t::ID, EL3058_t::INPUT_SIZE, EL3058_t::NUM_INPUTS, EL3058_t::OUTPUT_SIZE, EL3058_t::NUM_OUTPUTS},
+	{"EL3061", EL3061_t::ID, EL3061_t::INPUT_SIZE, EL3061_t::NUM_INPUTS, EL3061_t::OUTPUT_SIZE, EL3061_t::NUM_OUTPUTS},
+	{"EL3062", EL3062_t::ID, EL3062_t::INPUT_SIZE, EL3062_t::NUM_INPUTS, EL3062_t::OUTPUT_SIZE, EL3062_t::NUM_OUTPUTS},
+	{"EL3064", EL3064_t::ID, EL3064_t::INPUT_SIZE, EL3064_t::NUM_INPUTS, EL3064_t::OUTPUT_SIZE, EL3064_t::NUM_OUTPUTS},
+	{"EL3068", EL3068_t::ID, EL3068_t::INPUT_SIZE, EL3068_t::NUM_INPUTS, EL3068_t::OUTPUT_SIZE, EL3068_t::NUM_OUTPUTS},
+	{"EL3101", EL3101_t::ID, EL3101_t::INPUT_SIZE, EL3101_t::NUM_INPUTS, EL3101_t::OUTPUT_SIZE, EL3101_t::NUM_OUTPUTS},
+	{"EL3102", EL3102_t::ID, EL3102_t::INPUT_SIZE, EL3102_t::NUM_INPUTS, EL3102_t::OUTPUT_SIZE, EL3102_t::NUM_OUTPUTS},
+	{"EL3104", EL3104_t::ID, EL3104_t::INPUT_SIZE, EL3104_t::NUM_INPUTS, EL3104_t::OUTPUT_SIZE, EL3104_t::NUM_OUTPUTS},
+	{"EL3111", EL3111_t::ID, EL3111_t::INPUT_SIZE, EL3111_t::NUM_INPUTS, EL3111_t::OUTPUT_SIZE, EL3111_t::NUM_OUTPUTS},
+	{"EL3112", EL3112_t::ID, EL3112_t::INPUT_SIZE, EL3112_t::NUM_INPUTS, EL3112_t::OUTPUT_SIZE, EL3112_t::NUM_OUTPUTS},
+	{"EL3114", EL3114_t::ID, EL3114_t::INPUT_SIZE, EL3114_t::NUM_INPUTS, EL3114_t::OUTPUT_SIZE, EL3114_t::NUM_OUTPUTS},
+	{"EL3121", EL3121_t::ID, EL3121_t::INPUT_SIZE, EL3121_t::NUM_INPUTS, EL3121_t::OUTPUT_SIZE, EL3121_t::NUM_OUTPUTS},
+	{"EL3122", EL3122_t::ID, EL3122_t::INPUT_SIZE, EL3122_t::NUM_INPUTS, EL3122_t::OUTPUT_SIZE, EL3122_t::NUM_OUTPUTS},
+	{"EL3124", EL3124_t::ID, EL3124_t::INPUT_SIZE, EL3124_t::NUM_INPUTS, EL3124_t::OUTPUT_SIZE, EL3124_t::NUM_OUTPUTS},
+	{"EL3141", EL3141_t::ID, EL3141_t::INPUT_SIZE, EL3141_t::NUM_INPUTS, EL3141_t::OUTPUT_SIZE, EL3141_t::NUM_OUTPUTS},
+	{"EL3142", EL3142_t::ID, EL3142_t::INPUT_SIZE, EL3142_t::NUM_INPUTS, EL3142_t::OUTPUT_SIZE, EL3142_t::NUM_OUTPUTS},
+	{"EL3144", EL3144_t::ID, EL3144_t::INPUT_SIZE, EL3144_t::NUM_INPUTS, EL3144_t::OUTPUT_SIZE, EL3144_t::NUM_OUTPUTS},
+	{"EL3151", EL3151_t::ID, EL3151_t::INPUT_SIZE, EL3151_t::NUM_INPUTS, EL3151_t::OUTPUT_SIZE, EL3151_t::NUM_OUTPUTS},
+	{"EL3152", EL3152_t::ID, EL3152_t::INPUT_SIZE, EL3152_t::NUM_INPUTS, EL3152_t::OUTPUT_SIZE, EL3152_t::NUM_OUTPUTS},
+	{"EL3154", EL3154_t::ID, EL3154_t::INPUT_SIZE, EL3154_t::NUM_INPUTS, EL3154_t::OUTPUT_SIZE, EL3154_t::NUM_OUTPUTS},
+	{"EL3161", EL3161_t::ID, EL3161_t::INPUT_SIZE, EL3161_t::NUM_INPUTS, EL3161_t::OUTPUT_SIZE, EL3161_t::NUM_OUTPUTS},
+	{"EL3162", EL3162_t::ID, EL3162_t::INPUT_SIZE, EL3162_t::NUM_INPUTS, EL3162_t::OUTPUT_SIZE, EL3162_t::NUM_OUTPUTS},
+	{"EL3164", EL3164_t::ID, EL3164_t::INPUT_SIZE, EL3164_t::NUM_INPUTS, EL3164_t::OUTPUT_SIZE, EL3164_t::NUM_OUTPUTS},
+	{"EL3174", EL3174_t::ID, EL3174_t::INPUT_SIZE, EL3174_t::NUM_INPUTS, EL3174_t::OUTPUT_SIZE, EL3174_t::NUM_OUTPUTS},
+	{"EL3202", EL3202_t::ID, EL3202_t::INPUT_SIZE, EL3202_t::NUM_INPUTS, EL3202_t::OUTPUT_SIZE, EL3202_t::NUM_OUTPUTS},
+	{"EL3311", EL3311_t::ID, EL3311_t::INPUT_SIZE, EL3311_t::NUM_INPUTS, EL3311_t::OUTPUT_SIZE, EL3311_t::NUM_OUTPUTS},
+	{"EL3312", EL3312_t::ID, EL3312_t::INPUT_SIZE, EL3312_t::NUM_INPUTS, EL3312_t::OUTPUT_SIZE, EL3312_t::NUM_OUTPUTS},
+	{"EL3314", EL3314_t::ID, EL3314_t::INPUT_SIZE, EL3314_t::NUM_INPUTS, EL3314_t::OUTPUT_SIZE, EL3314_t::NUM_OUTPUTS},
+	{"EL3681", EL3681_t::ID, EL3681_t::INPUT_SIZE, EL3681_t::NUM_INPUTS, EL3681_t::OUTPUT_SIZE, EL3681_t::NUM_OUTPUTS},
+	{"EL4001", EL4001_t::ID, EL4001_t::INPUT_SIZE, EL4001_t::NUM_INPUTS, EL4001_t::OUTPUT_SIZE, EL4001_t::NUM_OUTPUTS},
+	{"EL4002", EL4002_t::ID, EL4002_t::INPUT_SIZE, EL4002_t::NUM_INPUTS, EL4002_t::OUTPUT_SIZE, EL4002_t::NUM_OUTPUTS},
+	{"EL4004", EL4004_t::ID, EL4004_t::INPUT_SIZE, EL4004_t::NUM_INPUTS, EL4004_t::OUTPUT_SIZE, EL4004_t::NUM_OUTPUTS},
+	{"EL4008", EL4008_t::ID, EL4008_t::INPUT_SIZE, EL4008_t::NUM_INPUTS, EL4008_t::OUTPUT_SIZE, EL4008_t::NUM_OUTPUTS},
+	{"EL4011", EL4011_t::ID, EL4011_t::INPUT_SIZE, EL4011_t::NUM_INPUTS, EL4011_t::OUTPUT_SIZE, EL4011_t::NUM_OUTPUTS},
+	{"EL4012", EL4012_t::ID, EL4012_t::INPUT_SIZE, EL4012_t::NUM_INPUTS, EL4012_t::OUTPUT_SIZE, EL4012_t::NUM_OUTPUTS},
+	{"EL4014", EL4014_t::ID, EL4014_t::INPUT_SIZE, EL4014_t::NUM_INPUTS, EL4014_t::OUTPUT_SIZE, EL4014_t::NUM_OUTPUTS},
+	{"EL4018", EL4018_t::ID, EL4018_t::INPUT_SIZE, EL4018_t::NUM_INPUTS, EL4018_t::OUTPUT_SIZE, EL4018_t::NUM_OUTPUTS},
+	{"EL4021", EL4021_t::ID, EL4021_t::INPUT_SIZE, EL4021_t::NUM_INPUTS, EL4021_t::OUTPUT_SIZE, EL4021_t::NUM_OUTPUTS},
+	{"EL4022", EL4022_t::ID, EL4022_t::INPUT_SIZE, EL4022_t::NUM_INPUTS, EL4022_t::OUTPUT_SIZE, EL4022_t::NUM_OUTPUTS},
+	{"EL4024", EL4024_t::ID, EL4024_t::INPUT_SIZE, EL4024_t::NUM_INPUTS, EL4024_t::OUTPUT_SIZE, EL4024_t::NUM_OUTPUTS},
+	{"EL4028", EL4028_t::ID, EL4028_t::INPUT_SIZE, EL4028_t::NUM_INPUTS, EL4028_t::OUTPUT_SIZE, EL4028_t::NUM_OUTPUTS},
+	{"EL4031", EL4031_t::ID, EL4031_t::INPUT_SIZE, EL4031_t::NUM_INPUTS, EL4031_t::OUTPUT_SIZE, EL4031_t::NUM_OUTPUTS},
+	{"EL4032", EL4032_t::ID, EL4032_t::INPUT_SIZE, EL4032_t::NUM_INPUTS, EL4032_t::OUTPUT_SIZE, EL4032_t::NUM_OUTPUTS},
+	{"EL4034", EL4034_t::ID, EL4034_t::INPUT_SIZE, EL4034_t::NUM_INPUTS, EL4034_t::OUTPUT_SIZE, EL4034_t::NUM_OUTPUTS},
+	{"EL4038", EL4038_t::ID, EL4038_t::INPUT_SIZE, EL4038_t::NUM_INPUTS, EL4038_t::OUTPUT_SIZE, EL4038_t::NUM_OUTPUTS},
+	{"EL4102", EL4102_t::ID, EL4102_t::INPUT_SIZE, EL4102_t::NUM_INPUTS, EL4102_t::OUTPUT_SIZE, EL4102_t::NUM_OUTPUTS},
+	{"EL4104", EL4104_t::ID, EL4104_t::INPUT_SIZE, EL4104_t::NUM_INPUTS, EL4104_t::OUTPUT_SIZE, EL4104_t::NUM_OUTPUTS},
+	{"EL4112", EL4112_t::ID, EL4112_t::INPUT_SIZE, EL4112_t::NUM_INPUTS, EL4112_t::OUTPUT_SIZE, EL4112_t::NUM_OUTPUTS},
+	{"EL4114", EL4114_t::ID, EL4114_t::INPUT_SIZE, EL4114_t::NUM_INPUTS, EL4114_t::OUTPUT_SIZE, EL4114_t::NUM_OUTPUTS},
+	{"EL4122", EL4122_t::ID, EL4122_t::INPUT_SIZE, EL4122_t::NUM_INPUTS, EL4122_t::OUTPUT_SIZE, EL4122_t::NUM_OUTPUTS},
+	{"EL4132", EL4132_t::ID, EL4132_t::INPUT_SIZE, EL4132_t::NUM_INPUTS, EL4132_t::OUTPUT_SIZE, EL4132_t::NUM_OUTPUTS},
+	{"EL4134", EL4134_t::ID, EL4134_t::INPUT_SIZE, EL4134_t::NUM_INPUTS, EL4134_t::OUTPUT_SIZE, EL4134_t::NUM_OUTPUTS},
+	{"EL5001", EL5001_t::ID, EL5001_t::INPUT_SIZE, EL5001_t::NUM_INPUTS, EL5001_t::OUTPUT_SIZE, EL5001_t::NUM_OUTPUTS},
+	{"EL5002", EL5002_t::ID, EL5002_t::INPUT_SIZE, EL5002_t::NUM_INPUTS, EL5002_t::OUTPUT_SIZE, EL5002_t::NUM_OUTPUTS},
+	{"EL5042", EL5042_t::ID, EL5042_t::INPUT_SIZE, EL5042_t::NUM_INPUTS, EL5042_t::OUTPUT_SIZE, EL5042_t::NUM_OUTPUTS},
+	{"EL7047", EL7047_t::ID, EL7047_t::INPUT_SIZE, EL7047_t::NUM_INPUTS, EL7047_t::OUTPUT_SIZE, EL7047_t::NUM_OUTPUTS},
+};
+
+/* Indexes into s_terminalInfos, sorted by name (strcmp order) */
+CONSTEXPR uint16_t s_terminalNameIndex[] = {
+	0, // EL1001
+	1, // EL1002
+	2, // EL1004
+	3, // EL1008
+	4, // EL1012
+	5, // EL1014
+	6, // EL1018
+	7, // EL1024
+	8, // EL1034
+	9, // EL1084
+	10, // EL1088
+	11, // EL1094
+	12, // EL1098
+	13, // EL1104
+	14, // EL1114
+	15, // EL1124
+	16, // EL1134
+	17, // EL1144
+	18, // EL1184
+	19, // EL1202
+	20, // EL1382
+	21, // EL1702
+	22, // EL1712
+	23, // EL1722
+	24, // EL1804
+	25, // EL1808
+	26, // EL1809
+	27, // EL1814
+	28, // EL1819
+	29, // EL2001
+	30, // EL2002
+	31, // EL2004
+	32, // EL2008
+	33, // EL2022
+	34, // EL2024
+	35, // EL2042
+	36, // EL2084
+	37, // EL2088
+	38, // EL2124
+	39, // EL2794
+	40, // EL2808
+	41, // EL2816
+	42, // EL3001
+	43, // EL3002
+	44, // EL3004
+	45, // EL3008
+	46, // EL3012
+	47, // EL3014
+	48, // EL3021
+	49, // EL3022
+	50, // EL3024
+	51, // EL3041
+	52, // EL3042
+	53, // EL3044
+	54, // EL3048
+	55, // EL3051
+	56, // EL3052
+	57, // EL3054
+	58, // EL3058
+	59, // EL3061
+	60, // EL3062
+	61, // EL3064
+	62, // EL3068
+	63, // EL3101
+	64, // EL3102
+	65, // EL3104
+	66, // EL3111
+	67, // EL3112
+	68, // EL3114
+	69, // EL3121
+	70, // EL3122
+	71, // EL3124
+	72, // EL3141
+	73, // EL3142
+	74, // EL3144
+	75, // EL3151
+	76, // EL3152
+	77, // EL3154
+	78, // EL3161
+	79, // EL3162
+	80, // EL3164
+	81, // EL3174
+	82, // EL3202
+	83, // EL3311
+	84, // EL3312
+	85, // EL3314
+	86, // EL3681
+	87, // EL4001
+	88, // EL4002
+	89, // EL4004
+	90, // EL4008
+	91, // EL4011
+	92, // EL4012
+	93, // EL4014
+	94, // EL4018
+	95, // EL4021
+	96, // EL4022
+	97, // EL4024
+	98, // EL4028
+	99, // EL4031
+	100, // EL4032
+	101, // EL4034
+	102, // EL4038
+	103, // EL4102
+	104, // EL4104
+	105, // EL4112
+	106, // EL4114
+	107, // EL4122
+	108, // EL4132
+	109, // EL4134
+	110, // EL5001
+	111, // EL5002
+	112, // EL5042
+	113, // EL7047
+};
+
+/* Input decoders for terminals with a codec, sorted by ID */
+CONSTEXPR TerminalCodec_t s_terminalCodecs[] = {
+	{EL3001_t::ID, EL3001_t::INPUT_STRIDE, &DecodeChannels<EL3001_t>},
+	{EL3002_t::ID, EL3002_t::INPUT_STRIDE, &DecodeChannels<EL3002_t>},
+	{EL3004_t::ID, EL3004_t::INPUT_STRIDE, &DecodeChannels<EL3004_t>},
+	{EL3008_t::ID, EL3008_t::INPUT_STRIDE, &DecodeChannels<EL3008_t>},
+	{EL3012_t::ID, EL3012_t::INPUT_STRIDE, &DecodeChannels<EL3012_t>},
+	{EL3014_t::ID, EL3014_t::INPUT_STRIDE, &DecodeChannels<EL3014_t>},
+	{EL3021_t::ID, EL3021_t::INPUT_STRIDE, &DecodeChannels<EL3021_t>},
+	{EL3022_t::ID, EL3022_t::INPUT_STRIDE, &DecodeChannels<EL3022_t>},
+	{EL3024_t::ID, EL3024_t::INPUT_STRIDE, &DecodeChannels<EL3024_t>},
+	{EL3041_t::ID, EL3041_t::INPUT_STRIDE, &DecodeChannels<EL3041_t>},
+	{EL3042_t::ID, EL3042_t::INPUT_STRIDE, &DecodeChannels<EL3042_t>},
+	{EL3044_t::ID, EL3044_t::INPUT_STRIDE, &DecodeChannels<EL3044_t>},
+	{EL3048_t::ID, EL3048_t::INPUT_STRIDE, &DecodeChannels<EL3048_t>},
+	{EL3051_t::ID, EL3051_t::INPUT_STRIDE, &DecodeChannels<EL3051_t>},
+	{EL3052_t::ID, EL3052_t::INPUT_STRIDE, &DecodeChannels<EL3052_t>},
+	{EL3054_t::ID, EL3054_t::INPUT_STRIDE, &DecodeChannels<EL3054_t>},
+	{EL3058_t::ID, EL3058_t::INPUT_STRIDE, &DecodeChannels<EL3058_t>},
+	{EL3061_t::ID, EL3061_t::INPUT_STRIDE, &DecodeChannels<EL3061_t>},
+	{EL3062_t::ID, EL3062_t::INPUT_STRIDE, &DecodeChannels<EL3062_t>},
+	{EL3064_t::ID, EL3064_t::INPUT_STRIDE, &DecodeChannels<EL3064_t>},
+	{EL3068_t::ID, EL3068_t::INPUT_STRIDE, &DecodeChannels<EL3068_t>},
+	{EL3101_t::ID, EL3101_t::INPUT_STRIDE, &DecodeChannels<EL3101_t>},
+	{EL3102_t::ID, EL3102_t::INPUT_STRIDE, &DecodeChannels<EL3102_t>},
+	{EL3104_t::ID, EL3104_t::INPUT_STRIDE, &DecodeChannels<EL3104_t>},
+	{EL3111_t::ID, EL3111_t::INPUT_STRIDE, &DecodeChannels<EL3111_t>},
+	{EL3112_t::ID, EL3112_t::INPUT_STRIDE, &DecodeChannels<EL3112_t>},
+	{EL3114_t::ID, EL3114_t::INPUT_STRIDE, &DecodeChannels<EL3114_t>},
+	{EL3121_t::ID, EL3121_t::INPUT_STRIDE, &DecodeChannels<EL3121_t>},
+	{EL3122_t::ID, EL3122_t::INPUT_STRIDE, &DecodeChannels<EL3122_t>},
+	{EL3124_t::ID, EL3124_t::INPUT_STRIDE, &DecodeChannels<EL3124_t>},
+	{EL3141_t::ID, EL3141_t::INPUT_STRIDE, &DecodeChannels<EL3141_t>},
+	{EL3142_t::ID, EL3142_t::INPUT_STRIDE, &DecodeChannels<EL3142_t>},
+	{EL3144_t::ID, EL3144_t::INPUT_STRIDE, &DecodeChannels<EL3144_t>},
+	{EL3151_t::ID, EL3151_t::INPUT_STRIDE, &DecodeChannels<EL3151_t>},
+	{EL3152_t::ID, EL3152_t::INPUT_STRIDE, &DecodeChannels<EL3152_t>},
+	{EL3154_t::ID, EL3154_t::INPUT_STRIDE, &DecodeChannels<EL3154_t>},
+	{EL3161_t::ID, EL3161_t::INPUT_STRIDE, &DecodeChannels<EL3161_t>},
+	{EL3162_t::ID, EL3162_t::INPUT_STRIDE, &DecodeChannels<EL3162_t>},
+	{EL3164_t::ID, EL3164_t::INPUT_STRIDE, &DecodeChannels<EL3164_t>},
+	{EL3174_t::ID, EL3174_t::INPUT_STRIDE, &DecodeChannels<EL3174_t>},
+	{EL3202_t::ID, EL3202_t::INPUT_STRIDE, &DecodeChannels<EL3202_t>},
+	{EL3311_t::ID, EL3311_t::INPUT_STRIDE, &DecodeChannels<EL3311_t>},
+	{EL3312_t::ID, EL3312_t::INPUT_STRIDE, &DecodeChannels<EL3312_t>},
+	{EL3314_t::ID, EL3314_t::INPUT_STRIDE, &DecodeChannels<EL3314_t>},
+	{EL3681_t::ID, EL3681_t::INPUT_STRIDE, &DecodeChannels<EL3681_t>},
+	{EL5001_t::ID, EL5001_t::INPUT_STRIDE, &DecodeChannels<EL5001_t>},
+	{EL5002_t::ID, EL5002_t::INPUT_STRIDE, &DecodeChannels<EL5002_t>},
+	{EL5042_t::ID, EL5042_t::INPUT_STRIDE, &DecodeChannels<EL5042_t>},
 };
 
 MAYBE_UNUSED static void __pdo_check() {